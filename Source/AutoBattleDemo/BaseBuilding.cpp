@@ -7,10 +7,10 @@ ABaseBuilding::ABaseBuilding()
 {
     PrimaryActorTick.bCanEverTick = true;
 
-    // 
+    // 创建根组件
     // RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
 
-    // ģ
+    // 创建模型组件
     MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BuildingMesh"));
     MeshComp->SetupAttachment(RootComponent);
     MeshComp->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
@@ -18,7 +18,7 @@ ABaseBuilding::ABaseBuilding()
     MeshComp->SetCollisionResponseToAllChannels(ECR_Block);
     MeshComp->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 
-    // Ĭ
+    // 默认属性
     MaxHealth = 500.0f;
     TeamID = ETeam::Enemy;
     bIsTargetable = true;
@@ -30,7 +30,7 @@ ABaseBuilding::ABaseBuilding()
     BaseUpgradeGoldCost = 100;
     BaseUpgradeElixirCost = 50;
 
-    // ʼΪ -1δã
+    // 网格坐标初始化为 -1（未设置）
     GridX = -1;
     GridY = -1;
 }
@@ -42,7 +42,7 @@ void ABaseBuilding::BeginPlay()
     UE_LOG(LogTemp, Log, TEXT("[Building] %s | Type: %d | Level: %d | GridPos: (%d, %d)"),
         *GetName(), (int32)BuildingType, BuildingLevel, GridX, GridY);
 
-    //  GridX/Y ûùԼһ
+    // 如果 GridX/Y 没被设置过，就自己算一次
     if (GridX == -1)
     {
         AGridManager* GM = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
@@ -53,7 +53,7 @@ void ABaseBuilding::BeginPlay()
         }
     }
 
-    // 
+    // 锁定格子
     AGridManager* GM = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
     if (GM)
     {
@@ -86,8 +86,13 @@ void ABaseBuilding::LevelUp()
 
 void ABaseBuilding::GetUpgradeCost(int32& OutGold, int32& OutElixir)
 {
-    OutGold = BaseUpgradeGoldCost * BuildingLevel;
-    OutElixir = BaseUpgradeElixirCost * BuildingLevel;
+    GetUpgradeCostForLevel(BuildingLevel, OutGold, OutElixir);
+}
+
+void ABaseBuilding::GetUpgradeCostForLevel(int32 Level, int32& OutGold, int32& OutElixir) const
+{
+    OutGold = BaseUpgradeGoldCost * Level;
+    OutElixir = BaseUpgradeElixirCost * Level;
 }
 
 bool ABaseBuilding::CanUpgrade() const
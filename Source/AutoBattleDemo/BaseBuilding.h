@@ -17,7 +17,7 @@ public:
     virtual void BeginPlay() override;
     virtual void Tick(float DeltaTime) override;
 
-    // ---  ---
+    // --- 建筑属性 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Building")
         EBuildingType BuildingType;
 
@@ -27,29 +27,32 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Building")
         int32 MaxLevel;
 
-    // --- ꣨ؼըʹã ---
-    // ڳԱAGridManagerռݵ
-    // ԱCɽʱҪֵ
+    // --- 网格坐标（关键！供炸弹人使用） ---
+    // 这个建筑在成员A的GridManager中占据的网格坐标
+    // 成员C在生成建筑时需要设置这两个值
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
         int32 GridX;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
         int32 GridY;
 
-    // --- ϵͳ ---
+    // --- 升级系统 ---
     UFUNCTION(BlueprintCallable, Category = "Building")
         virtual void LevelUp();
 
     UFUNCTION(BlueprintCallable, Category = "Building")
         void GetUpgradeCost(int32& OutGold, int32& OutElixir);
 
+    // 从 Level 升到下一级的费用 (墙没有 Actor，按 WallClass 的默认对象算)
+    void GetUpgradeCostForLevel(int32 Level, int32& OutGold, int32& OutElixir) const;
+
     UFUNCTION(BlueprintCallable, Category = "Building")
         bool CanUpgrade() const;
 
-    // ---  ---
+    // --- 点击交互 ---
     virtual void NotifyActorOnClicked(FKey ButtonPressed) override;
 
-    // ---  ---
+    // --- 组件 ---
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
         class UStaticMeshComponent* MeshComp;
 
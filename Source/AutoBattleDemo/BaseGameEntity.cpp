@@ -1,5 +1,6 @@
 #include "BaseGameEntity.h"
 #include "RTSGameMode.h"
+#include "CrowdManager.h"
 #include "Kismet/GameplayStatics.h"
 
 ABaseGameEntity::ABaseGameEntity()
@@ -14,6 +15,9 @@ ABaseGameEntity::ABaseGameEntity()
     CurrentHealth = MaxHealth;
     TeamID = ETeam::Enemy;
     bIsTargetable = true;
+    PendingDamage = 0.0f;
+    CrowdManagerRef = nullptr;
+    bIsDead = false;
 }
 
 void ABaseGameEntity::BeginPlay()
@@ -25,11 +29,35 @@ void ABaseGameEntity::BeginPlay()
 
     UE_LOG(LogTemp, Log, TEXT("[Entity] %s spawned | HP: %f | Team: %d | Targetable: %d"),
         *GetName(), CurrentHealth, (int32)TeamID, bIsTargetable);
+
+    // 注册到群体管理器 (作为可选目标；如果是兵，还由它驱动 AI)
+    CrowdManagerRef = ACrowdManager::Get(this);
+    if (CrowdManagerRef)
+    {
+        EntityHandle = CrowdManagerRef->RegisterEntity(this);
+    }
+}
+
+void ABaseGameEntity::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 没经过 Die 就被移除的 (比如收回兵营)，同样要通知攻击者
+    NotifyAttackers();
+
+    if (IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->UnregisterEntity(this);
+    }
+    CrowdManagerRef = nullptr;
+
+    Super::EndPlay(EndPlayReason);
 }
 
 float ABaseGameEntity::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent,
     AController* EventInstigator, AActor* DamageCauser)
 {
+    // 已经死了 (等待清理) 的不再受伤
+    if (bIsDead) return 0.0f;
+
     float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 
     if (ActualDamage > 0.0f)
@@ -51,11 +79,23 @@ float ABaseGameEntity::TakeDamage(float DamageAmount, FDamageEvent const& Damage
 
 void ABaseGameEntity::Die()
 {
+    if (bIsDead) return;
+    bIsDead = true;
+
     UE_LOG(LogTemp, Warning, TEXT("[Entity] %s died!"), *GetName());
 
+    // 先让句柄失效，之后谁再解析都会拿到空 (不用等 Destroy)
+    if (IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->ReleaseHandle(EntityHandle);
+    }
+
     // 调用蓝图可重写的死亡事件
     OnDeath();
 
+    // 只通知锁定了自己的实体去重新选目标
+    NotifyAttackers();
+
     // 通知 GameMode
     ARTSGameMode* GM = Cast<ARTSGameMode>(UGameplayStatics::GetGameMode(this));
     if (GM)
@@ -63,10 +103,154 @@ void ABaseGameEntity::Die()
         GM->OnActorKilled(this, nullptr);
     }
 
-    Destroy();
+    // 不当场销毁：大混战里一帧死几十个，集中 Destroy 会卡顿，之后的 GC 也更重
+    RetireFromPlay();
+}
+
+void ABaseGameEntity::RetireFromPlay()
+{
+    bIsTargetable = false;
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+    SetActorTickEnabled(false);
+
+    if (IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->UnregisterEntity(this);
+        CrowdManagerRef->QueueCleanup(this);
+    }
+    else
+    {
+        Destroy();
+    }
 }
 
 void ABaseGameEntity::OnDeath_Implementation()
 {
     // 默认实现为空，子类可以重写添加特效、音效等
-}
\ No newline at end of file
+}
+ABaseGameEntity* ABaseGameEntity::ResolveEntity(const FEntityHandle& Handle) const
+{
+    return CrowdManagerRef ? CrowdManagerRef->ResolveHandle(Handle) : nullptr;
+}
+
+bool ABaseGameEntity::IsTargetAlive(const FEntityHandle& Handle) const
+{
+    return CrowdManagerRef && CrowdManagerRef->IsHandleAlive(Handle);
+}
+
+bool ABaseGameEntity::GetTargetLocation(const FEntityHandle& Handle, FVector& OutLocation) const
+{
+    return CrowdManagerRef && CrowdManagerRef->GetTargetLocation(Handle, OutLocation);
+}
+
+void ABaseGameEntity::AddAttacker(ABaseGameEntity* Attacker)
+{
+    if (Attacker) Attackers.AddUnique(Attacker);
+}
+
+void ABaseGameEntity::RemoveAttacker(ABaseGameEntity* Attacker)
+{
+    Attackers.RemoveSwap(Attacker);
+}
+
+void ABaseGameEntity::UpdateTargetTracking(AActor* OldTarget, AActor* NewTarget)
+{
+    if (OldTarget == NewTarget) return;
+
+    if (ABaseGameEntity* OldEntity = Cast<ABaseGameEntity>(OldTarget))
+    {
+        OldEntity->RemoveAttacker(this);
+    }
+    if (ABaseGameEntity* NewEntity = Cast<ABaseGameEntity>(NewTarget))
+    {
+        NewEntity->AddAttacker(this);
+    }
+}
+
+void ABaseGameEntity::NotifyAttackers()
+{
+    // 先把列表拿出来，回调里攻击者会把自己从列表中移除
+    TArray<ABaseGameEntity*> ToNotify = MoveTemp(Attackers);
+    Attackers.Reset();
+
+    for (ABaseGameEntity* Attacker : ToNotify)
+    {
+        // 攻击者自己可能已经被销毁 (列表是 UPROPERTY，GC 后会被置空)
+        if (IsValid(Attacker))
+        {
+            Attacker->OnTargetLost(this);
+        }
+    }
+}
+
+void ABaseGameEntity::DealDamage(ABaseGameEntity* Target, float Amount)
+{
+    if (!Target) return;
+
+    if (IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->QueueDamage(Target, Amount, this);
+        return;
+    }
+
+    FDamageEvent DamageEvent;
+    Target->TakeDamage(Amount, DamageEvent, nullptr, this);
+}
+
+void ABaseGameEntity::DealDamage(const FEntityHandle& Target, float Amount)
+{
+    // 句柄只有注册表能解析，伤害只能走队列 (墙也一样)
+    if (IsValid(CrowdManagerRef)) CrowdManagerRef->QueueDamage(Target, Amount, this);
+}
+
+void ABaseGameEntity::ScheduleAction(float FireTime)
+{
+    if (IsValid(CrowdManagerRef)) CrowdManagerRef->ScheduleEntityAction(this, FireTime);
+}
+
+void ABaseGameEntity::CancelScheduledAction()
+{
+    if (IsValid(CrowdManagerRef)) CrowdManagerRef->CancelEntityAction(this);
+}
+
+bool ABaseGameEntity::IsActionScheduled() const
+{
+    return IsValid(CrowdManagerRef) && CrowdManagerRef->IsEntityActionScheduled(this);
+}
+
+void ABaseGameEntity::OnReturnedToPool()
+{
+    // 活着被收回的 (存进兵营等) 也要通知攻击者、注销
+    NotifyAttackers();
+    if (IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->UnregisterEntity(this);
+    }
+    EntityHandle.Reset();
+
+    bIsDead = true;
+    CurrentHealth = 0.0f;
+    PendingDamage = 0.0f;
+    bIsTargetable = false;
+    SetActorHiddenInGame(true);
+    SetActorEnableCollision(false);
+    SetActorTickEnabled(false);
+}
+
+void ABaseGameEntity::OnTakenFromPool()
+{
+    bIsDead = false;
+    CurrentHealth = MaxHealth;
+    PendingDamage = 0.0f;
+    bIsTargetable = GetClass()->GetDefaultObject<ABaseGameEntity>()->bIsTargetable;
+    SetActorHiddenInGame(false);
+    SetActorEnableCollision(true);
+    SetActorTickEnabled(PrimaryActorTick.bCanEverTick);
+
+    CrowdManagerRef = ACrowdManager::Get(this);
+    if (CrowdManagerRef)
+    {
+        EntityHandle = CrowdManagerRef->RegisterEntity(this);
+    }
+}
@@ -2,6 +2,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "RTSCoreTypes.h"
+#include "EntityHandle.h"
 #include "BaseGameEntity.generated.h"
 
 // 所有游戏实体的基类（兵种和建筑的共同父类）
@@ -15,6 +16,7 @@ public:
     ABaseGameEntity();
 
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     // --- 核心属性 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
@@ -36,6 +38,15 @@ public:
 
     virtual void Die();
 
+    // 已经死亡：不可选中、已从注册表移除、隐藏，等待清理阶段销毁 (或者正在对象池里)
+    bool IsDead() const { return bIsDead; }
+
+    // --- 对象池 (AUnitPool 调用) ---
+    // 放回池里：注销、隐藏，血量清零
+    virtual void OnReturnedToPool();
+    // 从池里取出：满血、显示、重新注册拿新句柄 (相当于再 BeginPlay 一次)
+    virtual void OnTakenFromPool();
+
     // 虚函数：子类可以重写死亡逻辑
     UFUNCTION(BlueprintNativeEvent, Category = "Entity")
         void OnDeath();
@@ -48,4 +59,69 @@ public:
     // 播放死亡特效
     UFUNCTION(BlueprintImplementableEvent, Category = "Visuals")
         void PlayDeathVisuals();
+
+    // --- 伤害预约 (飞行中的子弹) ---
+    // 预测血量 = 当前血量 - 在路上的伤害，<= 0 说明已经必死，射手不再往它身上浪费子弹
+    float GetPredictedHealth() const { return CurrentHealth - PendingDamage; }
+    bool IsDoomed() const { return GetPredictedHealth() <= 0.0f; }
+
+    // 子弹发射时预约，命中或销毁时归还
+    void ReservePendingDamage(float Amount) { PendingDamage += Amount; }
+    void ReleasePendingDamage(float Amount) { PendingDamage = FMath::Max(0.0f, PendingDamage - Amount); }
+
+    // 注册表发的句柄 (BeginPlay 注册后有效，死亡后失效)
+    const FEntityHandle& GetEntityHandle() const { return EntityHandle; }
+
+    // --- 目标追踪 (谁锁定了我) ---
+    void AddAttacker(ABaseGameEntity* Attacker);
+    void RemoveAttacker(ABaseGameEntity* Attacker);
+
+    // 锁定的目标死亡或被移除时调用 (只有锁定了它的实体会收到，不用每帧检查目标血量)
+    virtual void OnTargetLost(ABaseGameEntity* LostTarget) {}
+
+    // ScheduleAction 安排的时间到了 (群体管理器的时间轮回调)
+    virtual void OnScheduledAction() {}
+
+protected:
+    // 切换锁定的目标，同时维护新旧目标的攻击者列表
+    void UpdateTargetTracking(AActor* OldTarget, AActor* NewTarget);
+
+    // 通知所有攻击者目标已失效，并清空列表
+    void NotifyAttackers();
+
+    // 所在世界的群体管理器 (BeginPlay 时注册)
+    UPROPERTY()
+        class ACrowdManager* CrowdManagerRef;
+
+    // 通过注册表解析句柄，目标已死亡/注销时返回空
+    ABaseGameEntity* ResolveEntity(const FEntityHandle& Handle) const;
+
+    // 按句柄查目标是否还在、在哪 (墙没有 Actor，解析不出实体，但句柄有效)
+    bool IsTargetAlive(const FEntityHandle& Handle) const;
+    bool GetTargetLocation(const FEntityHandle& Handle, FVector& OutLocation) const;
+
+    // 对目标造成伤害：排进群体管理器的伤害队列，本帧模拟结束后统一结算 (没有管理器时直接结算)
+    void DealDamage(ABaseGameEntity* Target, float Amount);
+    void DealDamage(const FEntityHandle& Target, float Amount);
+
+    // 定时回调：到 FireTime 调用 OnScheduledAction，不用每帧轮询冷却
+    // 每个实体同时只有一个 (重新安排会替换旧的)，死亡/注销时自动取消
+    void ScheduleAction(float FireTime);
+    void CancelScheduledAction();
+    bool IsActionScheduled() const;
+
+    FEntityHandle EntityHandle;
+
+    // 死亡后退场：隐藏、关闭碰撞和 Tick，从注册表移除，交给群体管理器的清理阶段销毁
+    void RetireFromPlay();
+
+private:
+    bool bIsDead;
+
+    // 已经发射、还没命中的伤害总和
+    float PendingDamage;
+
+    // 正在锁定自己的实体
+    UPROPERTY()
+        TArray<ABaseGameEntity*> Attackers;
 };
\ No newline at end of file
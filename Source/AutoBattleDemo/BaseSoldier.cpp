@@ -4,12 +4,12 @@ ABaseSoldier::ABaseSoldier()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
-	// Ĭֵͼģ
+	// 默认数值（可以在子类蓝图里改）
 	Damage = 10.0f;
-	AttackRange = 150.0f; // սĬϾ
+	AttackRange = 150.0f; // 近战默认距离
 	AttackInterval = 1.0f;
 
-	// ʼѪ
+	// 初始化血量
 	MaxHealth = 100.0f; 
 }
 
@@ -21,42 +21,42 @@ void ABaseSoldier::BeginPlay()
 void ABaseSoldier::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	// ԺдѰ·߼
+	// 这里以后写寻路逻辑
 }
 
-// ĬϹ߼սȭ
+// 父类的默认攻击逻辑（比如近战挥拳）
 void ABaseSoldier::Attack(AActor* Target)
 {
 	if (Target)
 	{
-		// C++ ־ӡڴ˭
+		// C++ 日志：打印我在打谁
 		UE_LOG(LogTemp, Warning, TEXT("BaseSoldier Attacking %s for %f damage!"), *Target->GetName(), Damage);
 
-		// ԺдTarget->TakeDamage(...)
+		// 这里以后可以写：Target->TakeDamage(...)
 	}
 }
 
-// Ѫ߼ BaseBuilding 
+// 点击扣血逻辑（跟 BaseBuilding 很像）
 void ABaseSoldier::NotifyActorOnClicked(FKey ButtonPressed)
 {
     Super::NotifyActorOnClicked(ButtonPressed);
 
-    // Ѫ
-    MaxHealth -= 20.0f; // ÿο20
+    // 扣血
+    MaxHealth -= 20.0f; // 每次扣20
 
-    // ӡ־
+    // 打印日志
     if (GEngine)
     {
         FString Msg = FString::Printf(TEXT("Soldier Hit! Health: %f"), MaxHealth);
         GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Cyan, Msg);
     }
 
-    // ߼
+    // 死亡逻辑
     if (MaxHealth <= 0.0f)
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Soldier Died!"));
 
-        // Լ
+        // 销毁自己
         Destroy();
     }
 }
\ No newline at end of file
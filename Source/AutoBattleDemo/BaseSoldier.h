@@ -12,7 +12,7 @@ class AUTOBATTLEDEMO_API ABaseSoldier : public ACharacter
 	GENERATED_BODY()
 
 public:
-	// 캯
+	// 构造函数声明
 	ABaseSoldier();
 
 protected:
@@ -21,31 +21,31 @@ protected:
 public:
 	virtual void Tick(float DeltaTime) override;
 
-	// ---  ---
+	// --- 核心属性 ---
 
-	//  (EditAnywhere ͼΪ 10  50)
+	// 攻击力 (EditAnywhere 允许在蓝图里改为 10 或 50)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 		float Damage;
 
-	// 
+	// 攻击距离
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 		float AttackRange;
 
-	//  ()
+	// 攻击间隔 (攻速)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 		float AttackInterval;
 
-	// ֵ
+	// 生命值
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats")
 		float MaxHealth;
 
-	// ǵ¼
+	// 覆盖点击事件
 	virtual void NotifyActorOnClicked(FKey ButtonPressed = EKeys::LeftMouseButton) override;
 
-	// --- Ķ̬ ---
+	// --- 核心多态函数 ---
 
-	// 麯𹥻
-	//  'virtual' ؼ֣ζ(Archer)Ը
+	// 虚函数：发起攻击
+	// 加上 'virtual' 关键字，意味着子类(Archer)可以覆盖它
 	virtual void Attack(AActor* Target);
 
 
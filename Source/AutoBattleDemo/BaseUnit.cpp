@@ -1,6 +1,8 @@
 #include "BaseUnit.h"
 #include "BaseBuilding.h"
 #include "GridManager.h"
+#include "CrowdManager.h"
+#include "CrowdAvoidance.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/PrimitiveComponent.h"
 #include "EngineUtils.h"
@@ -10,7 +12,8 @@
 
 ABaseUnit::ABaseUnit()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // AI 和移动统一由 ACrowdManager 批量驱动，单位自身不再 Tick
+    PrimaryActorTick.bCanEverTick = false;
 
     // 1. 创建胶囊体
     CapsuleComp = CreateDefaultSubobject<UCapsuleComponent>(TEXT("CapsuleComp"));
@@ -29,12 +32,23 @@ ABaseUnit::ABaseUnit()
     Damage = 10.0f;
     MoveSpeed = 300.0f;
     AttackInterval = 1.0f;
+    AttackLeash = 80.0f;
+    AvoidanceRadius = 30.0f;
+    bUseAttackSlot = true;
+    CurrentVelocity = FVector::ZeroVector;
 
     UnitType = EUnitType::Barbarian;
     CurrentState = EUnitState::Idle;
     LastAttackTime = 0.0f;
     CurrentPathIndex = 0;
-    CurrentTarget = nullptr;
+    PathJitterSeed = 0;
+    AttackSlotIndex = INDEX_NONE;
+    AttackSlotLocation = FVector::ZeroVector;
+    AgentIndex = INDEX_NONE;
+    SquadID = INDEX_NONE;
+    SquadLeader = nullptr;
+    FormationOffset = FVector::ZeroVector;
+    SquadBreakDistance = 400.0f;
     GridManagerRef = nullptr;
     bIsActive = false;
 
@@ -53,11 +67,7 @@ void ABaseUnit::BeginPlay()
     }
 
     // 2. 自动激活逻辑
-    FString MapName = GetWorld()->GetMapName();
-    if (MapName.Contains("BattleField") && TeamID == ETeam::Enemy)
-    {
-        SetUnitActive(true);
-    }
+    AutoActivateForLevel();
 
     // 3. 记录模型初始位置
     if (MeshComp)
@@ -70,195 +80,404 @@ void ABaseUnit::BeginPlay()
     MoveSpeed *= FMath::RandRange(0.85f, 1.15f);
 }
 
-void ABaseUnit::Tick(float DeltaTime)
+// 决策阶段：运行在工作线程上，只读快照和自身成员，不产生任何副作用
+void ABaseUnit::DecideIntent(const FCrowdFrame& Frame, FUnitIntent& OutIntent) const
 {
-    Super::Tick(DeltaTime);
-
-    // 绘制调试信息
-    //FColor StateColor = FColor::White;
-    //switch (CurrentState)
-    //{
-    //case EUnitState::Idle: StateColor = FColor::Black; break;
-    //case EUnitState::Moving: StateColor = FColor::Green; break;
-    //case EUnitState::Attacking: StateColor = FColor::Red; break;
-    //}
-
-    //// 绘制状态指示器
-    //FVector DrawLocation = GetActorLocation() + FVector(0, 0, 100.0f);
-    //FString StateString = UEnum::GetValueAsString(CurrentState);
-    //FString TeamString = (TeamID == ETeam::Player) ? TEXT("Player") : TEXT("Enemy");
-    //FString DebugString = FString::Printf(TEXT("%s - %s"), *TeamString, *StateString);
-
-    //// 使用DrawDebugString
-    //DrawDebugString(GetWorld(), DrawLocation, DebugString, nullptr, StateColor, 0.0f, true);
-
-    //// 绘制到目标的线
-    //if (CurrentTarget && bIsActive)
-    //{
-    //    FColor LineColor = (CurrentState == EUnitState::Attacking) ? FColor::Red : FColor::Green;
-    //    DrawDebugLine(GetWorld(), GetActorLocation(), CurrentTarget->GetActorLocation(),
-    //        LineColor, false, -1.0f, 0, 2.0f);
-    //}
-
-    //// 绘制路径点
-    //if (PathPoints.Num() > 0 && CurrentState == EUnitState::Moving)
-    //{
-    //    for (int32 i = 0; i < PathPoints.Num(); i++)
-    //    {
-    //        DrawDebugSphere(GetWorld(), PathPoints[i], 20.0f, 8, FColor::Yellow, false, -1.0f, 0, 1.0f);
-    //        if (i > 0)
-    //        {
-    //            DrawDebugLine(GetWorld(), PathPoints[i - 1], PathPoints[i],
-    //                FColor::Yellow, false, -1.0f, 0, 2.0f);
-    //        }
-    //    }
-    //}
-
-    if (!bIsActive) return;
+    OutIntent = FUnitIntent();
+    OutIntent.NewState = CurrentState;
+    OutIntent.NewTarget = CurrentTarget;
+    OutIntent.NewPathIndex = CurrentPathIndex;
+
+    const FVector CurrentLoc = GetActorLocation();
+
+    // 目标已经不在快照里 (被销毁了)，视同没有目标
+    const FCrowdEntityState* TargetState = Frame.Find(CurrentTarget);
+    if (!TargetState) OutIntent.NewTarget.Reset();
 
     // 1. 状态维护 (State Check)
     switch (CurrentState)
     {
     case EUnitState::Idle:
-        if (!CurrentTarget)
+        if (!OutIntent.NewTarget.IsSet())
         {
-            CurrentTarget = FindClosestTarget();
-            if (CurrentTarget && GridManagerRef)
+            if (const FCrowdEntityState* Leader = GetSquadLeaderState(Frame))
             {
-                RequestPathToTarget();
-                if (PathPoints.Num() > 0) CurrentState = EUnitState::Moving;
+                // 队员：跟队长打同一个目标，不自己寻路，直接按阵型跟上
+                // 队长还没选好目标就先等一帧
+                if (Frame.Find(Leader->Target))
+                {
+                    OutIntent.NewTarget = Leader->Target;
+                    OutIntent.NewState = EUnitState::Moving;
+                    OutIntent.NewPathIndex = 0;
+                    OutIntent.bClearPath = true;
+                }
+            }
+            else
+            {
+                OutIntent.NewTarget = Frame.GetSelectedTarget(GetEntityHandle());
+
+                // 距离场直接通向这个目标：沿场走，不用寻路
+                FVector FieldStep;
+                if (OutIntent.NewTarget.IsSet() && Frame.GetFieldStep(TeamID, OutIntent.NewTarget, CurrentLoc, FieldStep))
+                {
+                    OutIntent.NewState = EUnitState::Moving;
+                    OutIntent.NewPathIndex = 0;
+                    OutIntent.bClearPath = true;
+                }
+                else
+                {
+                    OutIntent.bRequestPath = (OutIntent.NewTarget.IsSet() && GridManagerRef);
+                }
             }
-        }
-        else
-        {
-            ABaseGameEntity* TargetEntity = Cast<ABaseGameEntity>(CurrentTarget);
-            if (!TargetEntity || TargetEntity->CurrentHealth <= 0) CurrentTarget = nullptr;
         }
         break;
 
     case EUnitState::Moving:
-        if (CurrentTarget)
+        if (TargetState)
         {
-            // --- 使用 GetClosestPointOnCollision ---
-            float DistToSurface = FLT_MAX;
-            UPrimitiveComponent* TargetPrim = Cast<UPrimitiveComponent>(CurrentTarget->GetRootComponent());
-            if (!TargetPrim) TargetPrim = CurrentTarget->FindComponentByClass<UStaticMeshComponent>();
-
-            if (TargetPrim)
+            // [进入门槛]：射程 + 10 (稍微宽容一点点，方便刹车)
+            // 有攻击位的还要先站到攻击位上
+            if (TargetState->GetSurfaceDistance(CurrentLoc) <= (AttackRange + 10.0f) && IsAtAttackSlot(CurrentLoc))
             {
-                FVector ClosestPoint;
-                TargetPrim->GetClosestPointOnCollision(GetActorLocation(), ClosestPoint);
-                ClosestPoint.Z = GetActorLocation().Z;
-                DistToSurface = FVector::Dist(GetActorLocation(), ClosestPoint);
+                OutIntent.NewState = EUnitState::Attacking;
+                OutIntent.bClearPath = true;
             }
-            else
+            // 队员没有自己的路径、队长还在走，但离阵型位置太远 (被挡住了)：退回自己寻路
+            else if (GetPathLength() == 0)
             {
-                // 保底
-                DistToSurface = FVector::Dist(GetActorLocation(), CurrentTarget->GetActorLocation());
-            }
-
-            // [进入门槛]：射程 + 10 (稍微宽容一点点，方便刹车)
-            if (DistToSurface <= (AttackRange + 10.0f))
-            {
-                CurrentState = EUnitState::Attacking;
-                PathPoints.Empty();
-                // 可以在这里加个日志
-                // UE_LOG(LogTemp, Log, TEXT("Enter Attack: Dist %f <= Range %f"), DistToSurface, AttackRange + 10.f);
+                FVector FieldStep;
+                if (const FCrowdEntityState* Leader = GetSquadLeaderState(Frame))
+                {
+                    if (Leader->UnitState == EUnitState::Moving &&
+                        FVector::Dist2D(CurrentLoc, Leader->Location + FormationOffset) > SquadBreakDistance)
+                    {
+                        OutIntent.bRequestPath = true;
+                    }
+                }
+                // 沿距离场走的单位：场已经不指向这个目标了 (更近的目标露出来了)，回到待机重新选
+                else if (!Frame.GetFieldStep(TeamID, CurrentTarget, CurrentLoc, FieldStep))
+                {
+                    OutIntent.NewTarget.Reset();
+                    OutIntent.NewState = EUnitState::Idle;
+                }
             }
         }
         else
         {
-            CurrentState = EUnitState::Idle;
+            OutIntent.NewState = EUnitState::Idle;
         }
         break;
 
     case EUnitState::Attacking:
-        PerformAttack();
+        // 目标失效，回到待机重新找 (目标死亡会通过 OnTargetLost 通知，这里不再检查血量)
+        if (!TargetState || !TargetState->bIsTargetable)
+        {
+            OutIntent.NewTarget.Reset();
+            OutIntent.NewState = EUnitState::Idle;
+        }
+        // 在路上的子弹已经够打死它了：不再补刀，换下一个目标
+        else if (TargetState->IsDoomed())
+        {
+            OutIntent.NewTarget.Reset();
+            OutIntent.NewState = EUnitState::Idle;
+            OutIntent.bDropDoomedTarget = true;
+        }
+        // 宽松判定：超出 射程 + 缓冲 才重新追击
+        else if (TargetState->GetSurfaceDistance(CurrentLoc) > (AttackRange + AttackLeash))
+        {
+            OutIntent.bRequestPath = true;
+        }
+        // 冷却好了才攻击
+        else if (Frame.TimeSeconds - LastAttackTime >= AttackInterval)
+        {
+            OutIntent.bAttack = true;
+        }
         break;
     }
 
     // 2. 移动计算
+    const FCrowdEntityState* ChaseTarget = (OutIntent.NewTarget == CurrentTarget) ? TargetState : nullptr;
+    bool bUnconstrained = false;
+    OutIntent.Velocity = ComputeDesiredVelocity(Frame, OutIntent.NewState, ChaseTarget, OutIntent.NewPathIndex, &bUnconstrained);
+
+    // 3. 接下来的结果确定的话就挂起，到点或条件触发再恢复
+    PlanSuspend(Frame, ChaseTarget, bUnconstrained, OutIntent);
+}
 
+void ABaseUnit::PlanSuspend(const FCrowdFrame& Frame, const FCrowdEntityState* TargetState, bool bUnconstrained, FUnitIntent& InOutIntent) const
+{
+    // 状态变了、要寻路的这一帧不挂起，下一帧再看
+    if (!TargetState || InOutIntent.NewState != CurrentState || InOutIntent.bRequestPath || InOutIntent.bClearPath) return;
+
+    FUnitWait& Wait = InOutIntent.Wait;
+    const FVector CurrentLoc = GetActorLocation();
+
+    if (CurrentState == EUnitState::Attacking)
+    {
+        // “打到目标死为止”：站定了就睡到下次冷却好 (这一帧攻击的话从现在算)
+        if (!InOutIntent.Velocity.IsNearlyZero()) return;
+
+        Wait.WakeTime = (InOutIntent.bAttack ? Frame.TimeSeconds : LastAttackTime) + AttackInterval;
+        Wait.WakeFlags = Wake_TargetLost;
+
+        // 单位会走动，跑出射程 + 缓冲也要醒 (建筑不会动)
+        if (TargetState->bIsUnit)
+        {
+            Wait.WakeFlags |= Wake_TargetOutOfRange;
+            Wait.WakeRange = AttackRange + AttackLeash;
+        }
+    }
+    else if (CurrentState == EUnitState::Moving)
+    {
+        // “沿路径走到射程内”：只有跟着路径、周围没人没阻挡时才直走，睡到下一个路点
+        // 这一帧刚换路点时速度还指向旧路点，下一帧再挂起
+        if (!bUnconstrained || InOutIntent.NewPathIndex != CurrentPathIndex || InOutIntent.NewPathIndex >= GetPathLength()) return;
+
+        const float Speed = InOutIntent.Velocity.Size2D();
+        if (Speed < KINDA_SMALL_NUMBER) return;
+
+        // 不能睡过头：下一个路点、进入目标附近 (要换去攻击位/开打)，最多 0.5 秒
+        const float ToWaypoint = FVector::Dist2D(CurrentLoc, GetPathPoint(InOutIntent.NewPathIndex));
+        const float ToTarget = TargetState->GetSurfaceDistance(CurrentLoc) - AttackRange - Frame.TileSize;
+        const float Duration = FMath::Min3(ToWaypoint, ToTarget, Speed * 0.5f) / Speed;
+        if (Duration < Frame.DeltaTime * 2.0f) return;
+
+        Wait.WakeTime = Frame.TimeSeconds + Duration;
+        Wait.WakeFlags = Wake_TargetLost | Wake_NeighborNear;
+        Wait.WakeRange = AvoidanceRadius * 2.0f + Speed * 0.5f;
+    }
+}
+
+FVector ABaseUnit::ComputeDesiredVelocity(const FCrowdFrame& Frame, EUnitState State, const FCrowdEntityState* Target, int32& InOutPathIndex, bool* bOutUnconstrained) const
+{
     FVector FinalVelocity = FVector::ZeroVector;
-    FVector CurrentLoc = GetActorLocation();
+    const FVector CurrentLoc = GetActorLocation();
+    FVector FieldStep;
 
     // --- 力 A: 寻路/追击引力 ---
-    if (CurrentState == EUnitState::Moving)
+    if (State == EUnitState::Moving)
     {
         FVector MoveDir = FVector::ZeroVector;
 
+        // 情况 0: 已经到目标跟前且预约了攻击位 -> 不再跟路径/距离场挤到同一个点，直接去自己的攻击位
+        if (Target && HasAttackSlot() && Target->GetSurfaceDistance(CurrentLoc) <= AttackRange + Frame.TileSize)
+        {
+            MoveDir = (GetApproachPoint(*Target, CurrentLoc) - CurrentLoc).GetSafeNormal();
+            MoveDir.Z = 0;
+        }
         // 情况 1: 还有路径点，跟着 A* 走
-        if (PathPoints.Num() > 0 && CurrentPathIndex < PathPoints.Num())
+        else if (InOutPathIndex < GetPathLength())
         {
-            FVector TargetPoint = PathPoints[CurrentPathIndex];
+            FVector TargetPoint = GetPathPoint(InOutPathIndex);
             TargetPoint.Z = CurrentLoc.Z;
             MoveDir = (TargetPoint - CurrentLoc).GetSafeNormal();
 
             // 检查到达路点
             if (FVector::DistSquared2D(CurrentLoc, TargetPoint) < 900.0f)
             {
-                CurrentPathIndex++;
+                InOutPathIndex++;
             }
         }
-        // 情况 2: [关键修复] 路径走完了/没路径，但还没打到人 -> 直奔目标！
-        else if (CurrentTarget)
+        // 情况 2: 小队队员，队长还在走 -> 跟住阵型位置
+        else if (const FCrowdEntityState* Leader = GetSquadLeaderState(Frame))
         {
-            MoveDir = (CurrentTarget->GetActorLocation() - CurrentLoc).GetSafeNormal();
-            MoveDir.Z = 0; // 锁死高度
+            if (Leader->UnitState == EUnitState::Moving)
+            {
+                FVector ToSlot = Leader->Location + FormationOffset - CurrentLoc;
+                ToSlot.Z = 0;
 
-            // 调试：画一条绿线，证明正在直追
-            // DrawDebugLine(GetWorld(), CurrentLoc, CurrentTarget->GetActorLocation(), FColor::Green, false, -1, 0, 2.0f);
+                // 跟队长同速，再加上朝阵型位置的修正 (离得越远修正越大)
+                FinalVelocity = FVector(Leader->Velocity, 0.0f) + ToSlot * 2.0f;
+                FinalVelocity = FinalVelocity.GetClampedToMaxSize(MoveSpeed);
+            }
+            else if (Target)
+            {
+                // 队长已经开打了，自己直奔目标
+                MoveDir = (GetApproachPoint(*Target, CurrentLoc) - CurrentLoc).GetSafeNormal();
+                MoveDir.Z = 0;
+            }
+        }
+        // 情况 3: 距离场指向目标 -> 沿场下降一格
+        else if (Target && Frame.GetFieldStep(TeamID, Target->Handle, CurrentLoc, FieldStep))
+        {
+            MoveDir = (FieldStep - CurrentLoc).GetSafeNormal();
+            MoveDir.Z = 0;
+        }
+        // 情况 4: 路径走完了/没路径，但还没打到人 -> 直奔目标！
+        else if (Target)
+        {
+            MoveDir = (GetApproachPoint(*Target, CurrentLoc) - CurrentLoc).GetSafeNormal();
+            MoveDir.Z = 0; // 锁死高度
         }
 
         // 应用移动力
         FinalVelocity += MoveDir * MoveSpeed;
     }
 
-    // --- 力 B: 强力避让 (Separation) ---
-    TArray<FOverlapResult> Overlaps;
-    FCollisionQueryParams Params;
-    Params.AddIgnoredActor(this);
+    // --- 局部避让 (ORCA) ---
+    // 原来的分离斥力会让单位来回抖动，现在对邻居和阻挡格子建立速度约束，求出最接近期望速度的无碰撞速度
+    const FVector2D SelfPos(CurrentLoc);
+    const FVector2D SelfVel(GetVelocity());
+    const FVector2D PreferredVel(FinalVelocity);
 
-    bool bHit = GetWorld()->OverlapMultiByChannel(
-        Overlaps, CurrentLoc, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeSphere(60.0f), Params
-    );
+    // 攻击中尽量站定，只在被挤时小幅让位
+    const float MaxSpeed = (State == EUnitState::Attacking) ? MoveSpeed * 0.25f : MoveSpeed;
 
-    if (bHit)
+    FOrcaLineArray Lines;
+
+    // 1. 静态障碍：周围被阻挡的格子 (看作不会动的对象，自己承担全部避让)
+    const float ObstacleTimeHorizon = 0.25f;
+    if (Frame.TileSize > 0.0f)
     {
-        FVector SeparationVec = FVector::ZeroVector;
-        for (const FOverlapResult& Res : Overlaps)
+        const float QueryRange = AvoidanceRadius + MaxSpeed * ObstacleTimeHorizon;
+        const FVector2D Local = SelfPos - Frame.GridOrigin;
+        const int32 MinX = FMath::FloorToInt((Local.X - QueryRange) / Frame.TileSize);
+        const int32 MaxX = FMath::FloorToInt((Local.X + QueryRange) / Frame.TileSize);
+        const int32 MinY = FMath::FloorToInt((Local.Y - QueryRange) / Frame.TileSize);
+        const int32 MaxY = FMath::FloorToInt((Local.Y + QueryRange) / Frame.TileSize);
+
+        for (int32 X = MinX; X <= MaxX; ++X)
         {
-            ABaseUnit* OtherUnit = Cast<ABaseUnit>(Res.GetActor());
-            // 推开所有活着的单位
-            if (OtherUnit && OtherUnit->CurrentHealth > 0)
+            for (int32 Y = MinY; Y <= MaxY; ++Y)
             {
-                FVector Dir = CurrentLoc - OtherUnit->GetActorLocation();
-                Dir.Z = 0;
-                float Dist = Dir.Size();
-                if (Dist < 60.0f)
-                {
-                    float PushStrength = (60.0f - Dist) / (Dist + 0.1f);
-                    SeparationVec += Dir.GetSafeNormal() * PushStrength * 5000.0f;
-                }
+                if (!Frame.IsTileBlocked(X, Y)) continue;
+
+                // 格子上离自己最近的点
+                const FVector2D TileMin = Frame.GridOrigin + FVector2D(X, Y) * Frame.TileSize;
+                const FVector2D Closest(FMath::Clamp(SelfPos.X, TileMin.X, TileMin.X + Frame.TileSize), FMath::Clamp(SelfPos.Y, TileMin.Y, TileMin.Y + Frame.TileSize));
+                const FVector2D RelPos = Closest - SelfPos;
+
+                // 已经站在格子里面了 (比如刚被放下)，让它自己走出来
+                if (RelPos.SizeSquared() < KINDA_SMALL_NUMBER) continue;
+                if (RelPos.SizeSquared() > FMath::Square(QueryRange)) continue;
+
+                Lines.Add(FCrowdAvoidance::MakeAgentLine(RelPos, SelfVel, FVector2D::ZeroVector, AvoidanceRadius, ObstacleTimeHorizon, Frame.DeltaTime, 1.0f));
             }
         }
-        FinalVelocity += SeparationVec;
     }
-    
+    const int32 NumObstacleLines = Lines.Num();
 
-    if (CurrentState == EUnitState::Attacking)
+    // 2. 邻居单位：互相各让一半，对方站着不动时自己全让
+    const float AgentTimeHorizon = 0.5f;
+    Frame.ForEachNeighbor(CurrentLoc, [&](const FCrowdEntityState& Other)
+    {
+        if (Other.Entity == this) return;
+
+        const FVector2D RelPos = FVector2D(Other.Location) - SelfPos;
+        if (RelPos.SizeSquared() < KINDA_SMALL_NUMBER) return; // 完全重合时方向无意义
+
+        const float Responsibility = Other.Velocity.IsNearlyZero() ? 1.0f : 0.5f;
+        Lines.Add(FCrowdAvoidance::MakeAgentLine(RelPos, SelfVel, Other.Velocity, AvoidanceRadius + Other.Radius, AgentTimeHorizon, Frame.DeltaTime, Responsibility));
+    });
+
+    if (bOutUnconstrained) *bOutUnconstrained = (Lines.Num() == 0);
+
+    const FVector2D NewVel = FCrowdAvoidance::SolveVelocity(Lines, NumObstacleLines, MaxSpeed, PreferredVel);
+    FinalVelocity = FVector(NewVel, 0.0f); // 绝对防钻地
+    return FinalVelocity;
+}
+
+// 提交阶段：游戏线程按固定顺序调用，所有副作用都在这里发生
+void ABaseUnit::CommitIntent(const FUnitIntent& Intent, float DeltaTime)
+{
+    // 1. 应用决策结果
+    FEntityHandle NewTarget = Intent.NewTarget;
+    EUnitState NewState = Intent.NewState;
+    if (NewTarget.IsSet() && NewTarget != CurrentTarget)
     {
-        // 减弱 90% 的推力，或者直接设为 ZeroVector
-        FinalVelocity *= 0.1f;
+        // 新选的目标可能在本帧提交阶段刚被打死 (还没锁定它，收不到通知)，只在切换目标时解析一次
+        if (ABaseGameEntity* Target = ResolveEntity(NewTarget))
+        {
+            UE_LOG(LogTemp, Log, TEXT("[Unit] %s found target %s"), *GetName(), *Target->GetName());
+        }
+        else if (!IsTargetAlive(NewTarget))
+        {
+            NewTarget.Reset();
+            NewState = EUnitState::Idle;
+        }
     }
 
-    // --- 3. 执行移动 ---
-    if (!FinalVelocity.IsNearlyZero())
+    if (Intent.bDropDoomedTarget && IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->NoteDoomedTargetSkipped();
+    }
+
+    SetCurrentTarget(NewTarget);
+    CurrentState = NewState;
+    CurrentPathIndex = Intent.NewPathIndex;
+
+    if (Intent.bClearPath)
+    {
+        PathHandle.Reset();
+    }
+
+    if (Intent.bRequestPath && IsTargetAlive(CurrentTarget))
     {
-        // 限制最大速度
-        FinalVelocity = FinalVelocity.GetClampedToMaxSize(MoveSpeed * 2.0f);
-        FinalVelocity.Z = 0.0f; // 绝对防钻地
+        // 交给管理器在提交阶段末尾统一寻路 (同一目标的请求合并成一次搜索)
+        if (IsValid(CrowdManagerRef))
+        {
+            CrowdManagerRef->QueuePathRequest(this);
+        }
+        else
+        {
+            RequestPathToTarget();
+        }
+    }
+
+    // 目标在本帧提交阶段被别人打死的话，OnTargetLost 已经清掉了目标和攻击标记
+    if (Intent.bAttack && IsTargetAlive(CurrentTarget))
+    {
+        PerformAttack();
+
+        // 炸弹人攻击后自己就没了 (回对象池后是死亡状态，池满时被销毁)
+        if (IsDead() || IsPendingKill()) return;
+    }
+
+    // 2. 执行移动
+    ApplyMovement(Intent.Velocity, DeltaTime);
+}
 
+void ABaseUnit::InterpolateMovement(const FVector& LastVelocity, float DeltaTime)
+{
+    FVector Velocity = LastVelocity;
+    const float Speed = Velocity.Size2D();
+    const FVector CurrentLoc = GetActorLocation();
+
+    if (CurrentState == EUnitState::Moving && Speed > KINDA_SMALL_NUMBER && CurrentPathIndex < GetPathLength())
+    {
+        FVector ToWaypoint = GetPathPoint(CurrentPathIndex) - CurrentLoc;
+        ToWaypoint.Z = 0.0f;
+
+        // 到达路点的判定与决策阶段一致
+        if (ToWaypoint.SizeSquared() < 900.0f && ++CurrentPathIndex < GetPathLength())
+        {
+            ToWaypoint = GetPathPoint(CurrentPathIndex) - CurrentLoc;
+            ToWaypoint.Z = 0.0f;
+        }
+
+        // 这一步最多走到路点上，拐角处不会冲过头
+        const float MaxSpeed = ToWaypoint.Size() / FMath::Max(DeltaTime, KINDA_SMALL_NUMBER);
+        Velocity = ToWaypoint.GetSafeNormal() * FMath::Min(Speed, MaxSpeed);
+    }
+    else if (GridManagerRef && !Velocity.IsNearlyZero())
+    {
+        // 没有路径可跟 (跟队长、沿距离场、直奔目标)：前面是阻挡格子就先停下，等下次决策重新避让
+        int32 NextX, NextY;
+        if (GridManagerRef->WorldToGrid(CurrentLoc + Velocity * DeltaTime, NextX, NextY) && GridManagerRef->IsTileBlocked(NextX, NextY))
+        {
+            Velocity = FVector::ZeroVector;
+        }
+    }
+
+    ApplyMovement(Velocity, DeltaTime);
+}
+
+void ABaseUnit::ApplyMovement(const FVector& FinalVelocity, float DeltaTime)
+{
+    CurrentVelocity = FinalVelocity;
+
+    if (!FinalVelocity.IsNearlyZero())
+    {
         /*FHitResult MoveHit;
         AddActorWorldOffset(FinalVelocity * DeltaTime, true, &MoveHit);
 
@@ -270,8 +489,7 @@ void ABaseUnit::Tick(float DeltaTime)
             AddActorWorldOffset(SlideDir * DeltaTime, true);
         }*/
 
-        AddActorWorldOffset(FinalVelocity* DeltaTime, false);
-
+        AddActorWorldOffset(FinalVelocity * DeltaTime, false);
 
         // 面向移动方向
         if (FinalVelocity.SizeSquared() > 100.0f)
@@ -282,7 +500,7 @@ void ABaseUnit::Tick(float DeltaTime)
         }
     }
 
-    // --- 4. 攻击动画 (冲撞) ---
+    // 3. 攻击动画 (冲撞)
     if (bIsLunging && MeshComp)
     {
         LungeTimer += DeltaTime * 10.0f; // 动画速度
@@ -302,87 +520,133 @@ void ABaseUnit::Tick(float DeltaTime)
     }
 }
 
+void ABaseUnit::AutoActivateForLevel()
+{
+    FString MapName = GetWorld()->GetMapName();
+    if (MapName.Contains("BattleField") && TeamID == ETeam::Enemy)
+    {
+        SetUnitActive(true);
+    }
+}
+
+void ABaseUnit::OnReturnedToPool()
+{
+    // 先在注销前清掉目标 (归还攻击位、维护目标的攻击者列表)
+    SetUnitActive(false);
+
+    // 注销时会按 SquadID 把自己移出小队并清掉小队字段，所以小队字段不能在这之前清
+    Super::OnReturnedToPool();
+
+    CurrentPathIndex = 0;
+
+    // 冲撞动画停在半路的话模型要归位
+    bIsLunging = false;
+    LungeTimer = 0.0f;
+    if (MeshComp) MeshComp->SetRelativeLocation(OriginalMeshOffset);
+}
+
+void ABaseUnit::OnTakenFromPool()
+{
+    Super::OnTakenFromPool();
+
+    CurrentState = EUnitState::Idle;
+    LastAttackTime = 0.0f;
+    bIsUnstucking = false;
+
+    // 移速按蓝图默认值重新随机 (BeginPlay 里的随机是乘在当前值上的)
+    MoveSpeed = GetClass()->GetDefaultObject<ABaseUnit>()->MoveSpeed * FMath::RandRange(0.85f, 1.15f);
+
+    AutoActivateForLevel();
+}
+
 void ABaseUnit::SetUnitActive(bool bActive)
 {
     bIsActive = bActive;
     CurrentState = EUnitState::Idle;
     if (!bActive)
     {
-        CurrentTarget = nullptr;
-        PathPoints.Empty();
+        SetCurrentTarget(FEntityHandle());
+        PathHandle.Reset();
+        CurrentVelocity = FVector::ZeroVector;
     }
 }
 
-AActor* ABaseUnit::FindClosestTarget()
+void ABaseUnit::SetSquad(int32 InSquadID, ABaseUnit* InLeader, const FVector& InFormationOffset)
 {
-    AActor* ClosestActor = nullptr;
-    float ClosestDistance = FLT_MAX;
+    SquadID = InSquadID;
+    SquadLeader = InLeader;
+    FormationOffset = InFormationOffset;
+}
 
-    // 搜索所有可能的目标类型
-    TArray<AActor*> AllTargets;
+const FCrowdEntityState* ABaseUnit::GetSquadLeaderState(const FCrowdFrame& Frame) const
+{
+    if (!SquadLeader || SquadLeader == this) return nullptr;
 
-    // 搜索玩家建筑
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), AllTargets);
+    const FCrowdEntityState* Leader = Frame.Find(SquadLeader);
+    return (Leader && Leader->IsAlive() && Leader->bIsActiveUnit) ? Leader : nullptr;
+}
 
-    // 搜索玩家兵
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), AllUnits);
-    AllTargets.Append(AllUnits);
+void ABaseUnit::SetCurrentTarget(const FEntityHandle& NewTarget)
+{
+    if (NewTarget == CurrentTarget) return;
+
+    UpdateTargetTracking(ResolveEntity(CurrentTarget), ResolveEntity(NewTarget));
+    CurrentTarget = NewTarget;
+    UpdateAttackSlot();
+}
+
+void ABaseUnit::UpdateAttackSlot()
+{
+    if (HasAttackSlot() && IsValid(CrowdManagerRef))
+    {
+        CrowdManagerRef->ReleaseAttackSlot(this, AttackSlotBuilding, AttackSlotIndex);
+    }
+    AttackSlotIndex = INDEX_NONE;
+    AttackSlotBuilding.Reset();
 
-    for (AActor* Actor : AllTargets)
+    // 目标不是建筑时预约不到，照旧直奔目标
+    if (bUseAttackSlot && CurrentTarget.IsSet() && IsValid(CrowdManagerRef))
     {
-        ABaseGameEntity* Entity = Cast<ABaseGameEntity>(Actor);
-        if (!Entity) continue;
+        AttackSlotIndex = CrowdManagerRef->ReserveAttackSlot(this, CurrentTarget, AttackSlotLocation);
+        if (HasAttackSlot()) AttackSlotBuilding = CurrentTarget;
+    }
+}
 
-        // 检查是否为有效目标
-        bool bIsValidTarget = false;
+FVector ABaseUnit::GetApproachPoint(const FCrowdEntityState& Target, const FVector& Location) const
+{
+    // 到了攻击位还不在射程内 (格子比射程大)，剩下的路直奔目标
+    const bool bSlotReached = FVector::DistSquared2D(Location, AttackSlotLocation) <= FMath::Square(AvoidanceRadius * 2.0f);
+    return (HasAttackSlot() && Target.Handle == AttackSlotBuilding && !bSlotReached) ? AttackSlotLocation : Target.Location;
+}
 
-        // 敌方兵应该攻击玩家阵营
-        if (this->TeamID == ETeam::Enemy)
-        {
-            bIsValidTarget = (Entity->TeamID == ETeam::Player);
-        }
-        // 玩家兵应该攻击敌方阵营
-        else if (this->TeamID == ETeam::Player)
-        {
-            bIsValidTarget = (Entity->TeamID == ETeam::Enemy);
-        }
+bool ABaseUnit::IsAtAttackSlot(const FVector& Location) const
+{
+    if (!HasAttackSlot()) return true;
 
-        if (bIsValidTarget && Entity->CurrentHealth > 0 && Entity->bIsTargetable)
-        {
-            // 计算距离（使用表面距离）
-            float DistToSurface = FLT_MAX;
-            UPrimitiveComponent* Prim = Cast<UPrimitiveComponent>(Entity->GetRootComponent());
-            if (!Prim) Prim = Entity->FindComponentByClass<UStaticMeshComponent>();
+    // 攻击位被别的单位挡住时不能一直等：速度几乎为零就原地开打
+    return FVector::DistSquared2D(Location, AttackSlotLocation) <= FMath::Square(AvoidanceRadius * 2.0f) ||
+        CurrentVelocity.SizeSquared2D() < 100.0f;
+}
 
-            if (Prim)
-            {
-                FVector ClosestPt;
-                Prim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-                ClosestPt.Z = GetActorLocation().Z;
-                DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-            }
-            else
-            {
-                DistToSurface = FVector::Dist(GetActorLocation(), Entity->GetActorLocation());
-            }
+void ABaseUnit::OnTargetLost(ABaseGameEntity* LostTarget)
+{
+    if (LostTarget) OnTargetHandleLost(LostTarget->GetEntityHandle());
+}
 
-            // 优先选择最近的
-            if (DistToSurface < ClosestDistance)
-            {
-                ClosestDistance = DistToSurface;
-                ClosestActor = Entity;
-            }
-        }
-    }
+void ABaseUnit::OnTargetHandleLost(const FEntityHandle& LostTarget)
+{
+    if (!LostTarget.IsSet() || LostTarget != CurrentTarget) return;
+
+    CurrentTarget.Reset();
+    UpdateAttackSlot();
+    CurrentState = EUnitState::Idle;
+    PathHandle.Reset();
 
-    if (ClosestActor)
+    // 不在这里立刻扫描，大量单位同时失去目标时由管理器分批重新决策
+    if (IsValid(CrowdManagerRef))
     {
-        UE_LOG(LogTemp, Log, TEXT("[Unit] %s found target %s at distance %.1f"),
-            *GetName(), *ClosestActor->GetName(), ClosestDistance);
+        CrowdManagerRef->RequestRetarget(this);
     }
-
-    return ClosestActor;
 }
 
 void ABaseUnit::RequestPathToTarget()
@@ -392,98 +656,65 @@ void ABaseUnit::RequestPathToTarget()
         GridManagerRef = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
     }
 
-    if (!CurrentTarget || !GridManagerRef) return;
+    FVector EndPos;
+    if (!GridManagerRef || !GetTargetLocation(CurrentTarget, EndPos)) return;
 
     FVector StartPos = GetActorLocation();
-    FVector EndPos = CurrentTarget->GetActorLocation();
-
-    // 查找路径
-    PathPoints = GridManagerRef->FindPath(StartPos, EndPos);
-    CurrentPathIndex = 0;
 
-    // 路径抖动 (Jitter) - 防止重叠走线
-    if (PathPoints.Num() > 0)
-    {
-        float JitterAmount = 40.0f;
-        for (int32 i = 0; i < PathPoints.Num() - 1; i++)
-        {
-            PathPoints[i].X += FMath::RandRange(-JitterAmount, JitterAmount);
-            PathPoints[i].Y += FMath::RandRange(-JitterAmount, JitterAmount);
-        }
-    }
+    // 查找路径 (共享，相同路线的单位拿到的是同一份)
+    ApplyPath(GridManagerRef->FindSharedPath(StartPos, EndPos));
 }
 
-void ABaseUnit::PerformAttack()
+void ABaseUnit::ApplyPath(const FGridPathRef& Path)
 {
-    // 更强的目标有效性检查
-    if (!IsValid(CurrentTarget) || CurrentTarget->IsPendingKill())
-    {
-        CurrentTarget = nullptr;
-        CurrentState = EUnitState::Idle;
-        return;
-    }
+    PathHandle = Path;
+    CurrentPathIndex = 0;
 
-    // 转换为具体类型进行更严格的检查
-    ABaseGameEntity* TargetEntity = Cast<ABaseGameEntity>(CurrentTarget);
-    if (!TargetEntity || TargetEntity->CurrentHealth <= 0.0f || !TargetEntity->bIsTargetable)
-    {
-        CurrentTarget = nullptr;
-        CurrentState = EUnitState::Idle;
-        return;
-    }
+    // 路径抖动 (Jitter) - 防止重叠走线，换个种子就是一条新的抖动路线
+    PathJitterSeed = FMath::Rand();
 
-    if (!CurrentTarget)
-    {
-        CurrentState = EUnitState::Idle;
-        return;
-    }
+    if (GetPathLength() > 0) CurrentState = EUnitState::Moving;
+}
 
-    // 攻击时的距离检查也用表面距离
-    float DistToSurface = FLT_MAX;
-    UPrimitiveComponent* TargetPrim = Cast<UPrimitiveComponent>(CurrentTarget->GetRootComponent());
-    if (!TargetPrim) TargetPrim = CurrentTarget->FindComponentByClass<UStaticMeshComponent>();
+FVector ABaseUnit::GetPathPoint(int32 Index) const
+{
+    FVector Point = PathHandle->Points[Index];
 
-    if (TargetPrim)
-    {
-        FVector ClosestPt;
-        TargetPrim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-        ClosestPt.Z = GetActorLocation().Z;
-        DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-    }
-    else
+    // 终点不抖动
+    if (Index < PathHandle->Points.Num() - 1)
     {
-        DistToSurface = FVector::Dist(GetActorLocation(), CurrentTarget->GetActorLocation());
+        const float JitterAmount = 40.0f;
+        const uint32 Hash = HashCombine(GetTypeHash(PathJitterSeed), GetTypeHash(Index));
+        Point.X += ((Hash & 0xFFFF) / 65535.0f * 2.0f - 1.0f) * JitterAmount;
+        Point.Y += ((Hash >> 16) / 65535.0f * 2.0f - 1.0f) * JitterAmount;
     }
+    return Point;
+}
 
-    // 宽松判定
-    if (DistToSurface > (AttackRange + 80.0f))
+void ABaseUnit::PerformAttack()
+{
+    // 这一击可能打死目标，OnTargetLost 会清空 CurrentTarget，先存一份 (墙只有句柄和位置)
+    const FEntityHandle Target = CurrentTarget;
+    FVector TargetLocation;
+    if (!GetTargetLocation(Target, TargetLocation)) return;
+
+    // 攻击执行 (排进伤害队列，本帧末统一结算)
+    DealDamage(Target, Damage);
+    LastAttackTime = GetWorld()->GetTimeSeconds();
+
+    // 面向目标
+    FVector Dir = (TargetLocation - GetActorLocation()).GetSafeNormal();
+    if (!Dir.IsNearlyZero())
     {
-        RequestPathToTarget();
-        if (PathPoints.Num() > 0) CurrentState = EUnitState::Moving;
-        return;
+        FRotator TargetRot = Dir.Rotation();
+        TargetRot.Pitch = 0;
+        SetActorRotation(TargetRot);
     }
 
-    // 攻击执行
-    float CurrentTime = GetWorld()->GetTimeSeconds();
-    if (CurrentTime - LastAttackTime >= AttackInterval)
-    {
-        FDamageEvent DamageEvent;
-        CurrentTarget->TakeDamage(Damage, DamageEvent, nullptr, this);
-        LastAttackTime = CurrentTime;
+    // 触发冲撞动画
+    bIsLunging = true;
+    LungeTimer = 0.0f;
 
-        // 面向目标
-        FVector Dir = (CurrentTarget->GetActorLocation() - GetActorLocation()).GetSafeNormal();
-        if (!Dir.IsNearlyZero())
-        {
-            FRotator TargetRot = Dir.Rotation();
-            TargetRot.Pitch = 0;
-            SetActorRotation(TargetRot);
-        }
-
-        // 触发冲撞动画
-        bIsLunging = true;
-        LungeTimer = 0.0f;
-
-        UE_LOG(LogTemp, Log, TEXT("[Unit] %s attacked %s!"), *GetName(), *CurrentTarget->GetName());
-    }
-}
\ No newline at end of file
+    const ABaseGameEntity* TargetEntity = ResolveEntity(Target);
+    UE_LOG(LogTemp, Log, TEXT("[Unit] %s attacked %s!"), *GetName(), TargetEntity ? *TargetEntity->GetName() : TEXT("Wall"));
+}
@@ -3,8 +3,13 @@
 #include "BaseGameEntity.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "RTSCoreTypes.h"
+#include "GridManager.h"
 #include "BaseUnit.generated.h"
 
+struct FCrowdFrame;
+struct FUnitIntent;
+struct FCrowdEntityState;
+
 // 士兵状态机
 UENUM()
 enum class EUnitState : uint8
@@ -22,7 +27,6 @@ class AUTOBATTLEDEMO_API ABaseUnit : public ABaseGameEntity
 public:
     ABaseUnit();
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
 
     // --- 兵种类型 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Unit")
@@ -32,6 +36,48 @@ public:
     UFUNCTION(BlueprintCallable)
         void SetUnitActive(bool bActive);
 
+    bool IsUnitActive() const { return bIsActive; }
+    EUnitState GetUnitState() const { return CurrentState; }
+    // 目标已死亡时返回空 (只比较句柄代数，不访问 UObject)
+    ABaseGameEntity* GetCurrentTarget() const { return ResolveEntity(CurrentTarget); }
+    const FEntityHandle& GetCurrentTargetHandle() const { return CurrentTarget; }
+
+    // --- 小队 (由 ACrowdManager 编队) ---
+    void SetSquad(int32 InSquadID, ABaseUnit* InLeader, const FVector& InFormationOffset);
+    int32 GetSquadID() const { return SquadID; }
+
+    // --- 供 ACrowdManager 调用 ---
+
+    // 在群体管理器调度槽里的下标 (注册/压缩时由管理器维护，未注册为 INDEX_NONE)
+    void SetAgentIndex(int32 InAgentIndex) { AgentIndex = InAgentIndex; }
+    int32 GetAgentIndex() const { return AgentIndex; }
+
+    // 决策阶段（工作线程）：只读快照和自身状态，把结果写进意图
+    virtual void DecideIntent(const FCrowdFrame& Frame, FUnitIntent& OutIntent) const;
+
+    // 提交阶段（游戏线程）：应用意图，移动/攻击等副作用都在这里
+    virtual void CommitIntent(const FUnitIntent& Intent, float DeltaTime);
+
+    // 锁定的目标死了：清空目标，交给群体管理器下一帧批量重新选
+    virtual void OnTargetLost(ABaseGameEntity* LostTarget) override;
+
+    // 同上，按句柄 (墙被拆时由群体管理器调用，墙没有 Actor)
+    void OnTargetHandleLost(const FEntityHandle& LostTarget);
+
+    // 对象池：清空目标/路径/小队/冲撞动画，取出时重新随机移速、按关卡自动激活
+    virtual void OnReturnedToPool() override;
+    virtual void OnTakenFromPool() override;
+
+    // 设置新路径 (寻路结果)，有路就进入移动状态
+    void ApplyPath(const FGridPathRef& Path);
+
+    // 按给定速度移动并播放冲撞动画
+    void ApplyMovement(const FVector& Velocity, float DeltaTime);
+
+    // 没轮到决策的帧 (游戏线程)：跟路径时按上次的速度大小朝当前路点走，到点推进游标，不会越过路点；
+    // 不跟路径时沿上次的速度走，但不走进阻挡格子
+    void InterpolateMovement(const FVector& LastVelocity, float DeltaTime);
+
     // --- 战斗属性 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
         float AttackRange;
@@ -42,9 +88,24 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
         float AttackInterval;
 
+    // 攻击中目标跑出 (射程 + 缓冲) 后才重新追击
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+        float AttackLeash;
+
+    // 攻击建筑时预约建筑外围的攻击位，各站各的位置 (近战用；远程单位在射程边上就停下，不需要)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
+        bool bUseAttackSlot;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
         float MoveSpeed;
 
+    // 局部避让半径 (ORCA)，两个单位中心距离小于半径之和即视为相撞
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+        float AvoidanceRadius;
+
+    // 上一次实际移动的速度 (避让时邻居读取)
+    virtual FVector GetVelocity() const override { return CurrentVelocity; }
+
     // --- 组件 ---
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
         class UCapsuleComponent* CapsuleComp;
@@ -54,42 +115,95 @@ public:
 
 protected:
     // --- 核心AI逻辑（可被子类重写） ---
+    // 选目标由 ACrowdManager 按兵种的策略批量完成 (TargetingPolicy.h)
 
-    virtual AActor* FindClosestTarget();
+    // 计算速度：寻路/追击得到期望速度，再经 ORCA 避让修正（决策阶段调用）
+    // bOutUnconstrained: 周围没有邻居和阻挡，速度就是期望速度 (可以挂起直走)
+    FVector ComputeDesiredVelocity(const FCrowdFrame& Frame, EUnitState State, const FCrowdEntityState* Target, int32& InOutPathIndex, bool* bOutUnconstrained = nullptr) const;
+
+    // 行为的挂起点：等攻击冷却 / 沿路径直走到下一个路点时给出挂起条件 (决策阶段末尾调用)
+    void PlanSuspend(const FCrowdFrame& Frame, const FCrowdEntityState* TargetState, bool bUnconstrained, FUnitIntent& InOutIntent) const;
 
     void RequestPathToTarget();
 
+    // 修改 CurrentTarget 都走这里 (维护目标的攻击者列表)
+    void SetCurrentTarget(const FEntityHandle& NewTarget);
+
+    // 可跟随的队长 (自己不是队长、队长还活着且激活时才返回)
+    const FCrowdEntityState* GetSquadLeaderState(const FCrowdFrame& Frame) const;
+
     // void MoveAlongPath(float DeltaTime);
 
+    // 执行一次攻击（提交阶段调用，距离和冷却已在决策阶段判定过）
     virtual void PerformAttack();
 
     // 当前状态
     EUnitState CurrentState;
 
-    // 路径缓存
-    TArray<FVector> PathPoints;
+    // 路径：共享路径的句柄 + 游标
+    FGridPathRef PathHandle;
     int32 CurrentPathIndex;
 
-    // 当前目标
-    UPROPERTY()
-        AActor* CurrentTarget;
+    // 路径抖动种子 (每次寻路换一个)，采样时才叠加抖动，共享路径本身不改
+    int32 PathJitterSeed;
+
+    int32 GetPathLength() const { return PathHandle.IsValid() ? PathHandle->Points.Num() : 0; }
+    FVector GetPathPoint(int32 Index) const;
+
+    // 当前目标 (句柄，目标死亡后自动失效，不需要 UPROPERTY)
+    FEntityHandle CurrentTarget;
+
+    // 在目标建筑上预约的攻击位 (只在提交阶段修改)
+    int32 AttackSlotIndex;
+    FEntityHandle AttackSlotBuilding;
+    FVector AttackSlotLocation;
+
+    bool HasAttackSlot() const { return AttackSlotIndex != INDEX_NONE; }
+
+    // 换目标后归还旧攻击位，再在新目标上预约
+    void UpdateAttackSlot();
+
+    // 靠近目标的最后一段往哪走：有攻击位且还没走到就去攻击位，否则直奔目标
+    FVector GetApproachPoint(const FCrowdEntityState& Target, const FVector& Location) const;
+
+    // 进入攻击的位置条件：没有攻击位、已经站到攻击位上，或者被挤得走不动了
+    bool IsAtAttackSlot(const FVector& Location) const;
 
     // 攻击计时
     float LastAttackTime;
 
+    // 当前移动速度 (ApplyMovement 写入)
+    FVector CurrentVelocity;
+
+    // 调度槽下标 (ACrowdManager 维护)
+    int32 AgentIndex;
+
+    // --- 小队 ---
+    // 队长负责寻路，队员跟着队长位置 + 阵型偏移走，掉队太远才自己寻路
+    int32 SquadID;
+
+    UPROPERTY()
+        ABaseUnit* SquadLeader;
+
+    FVector FormationOffset;
+
+    // 离阵型位置超过这个距离算掉队
+    UPROPERTY(EditAnywhere, Category = "Movement")
+        float SquadBreakDistance;
+
     // GridManager 引用
     class AGridManager* GridManagerRef;
 
     // AI 激活状态
     bool bIsActive;
 
+    // 战场关卡里的敌兵出生即激活 (BeginPlay 和从对象池取出时调用)
+    void AutoActivateForLevel();
+
     // 子弹蓝图类 (在编辑器里配置 BP_Arrow)
     UPROPERTY(EditDefaultsOnly, Category = "Combat")
         TSubclassOf<class ARTSProjectile> ProjectileClass;
 
-    // 重寻路计时器
-    float PathUpdateTimer;
-
     // --- 攻击动画变量 ---
     bool bIsLunging; // 是否正在执行冲撞动作
     float LungeTimer; // 动画计时器
@@ -3,20 +3,22 @@
 #include "RTSGameInstance.h"
 #include "BaseUnit.h"
 #include "GridManager.h"
+#include "CrowdManager.h"
+#include "UnitPool.h"
 #include "RTSGameMode.h"
 #include "Kismet/GameplayStatics.h"
 
 ABuilding_Barracks::ABuilding_Barracks()
 {
-    BuildingType = EBuildingType::Barracks; // ȷ CoreTypes ö
+    BuildingType = EBuildingType::Barracks; // 确保 CoreTypes 里有这个枚举
     MaxHealth = 800.0f;
     TeamID = ETeam::Player;
     BuildingLevel = 1;
-    // ĬÿӪṩ 5 ˿
+    // 默认每个兵营提供 5 人口
     // PopulationBonus = 5;
 }
 
-// [Ĺʽ] ʼ52,3ÿ+24,5ÿ+3
+// [核心公式] 初始5，2,3每级+2，4,5每级+3
 int32 ABuilding_Barracks::GetCurrentCapacity(int Level) const
 {
     // Level 1: 5 + 0 = 5
@@ -56,26 +58,26 @@ void ABuilding_Barracks::EndPlay(const EEndPlayReason::Type EndPlayReason)
     }
 }
 
-// ߼
+// 存兵逻辑
 bool ABuilding_Barracks::StoreUnit(ABaseUnit* UnitToStore)
 {
     if (!UnitToStore) return false;
 
-    // 
+    // 容量检查
     if (StoredUnits.Num() >= GetCurrentCapacity(BuildingLevel))
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Red, TEXT("Barracks Full!"));
         
-        //  falseʾ洢ʧ
+        // 返回 false，表示存储失败
         return false;
     }
 
-    // 
+    // 保存数据
     FUnitSaveData Data;
     Data.UnitType = UnitToStore->UnitType;
     StoredUnits.Add(Data);
 
-    // ԭռõĸ
+    // 解锁它原来占用的格子
     AGridManager* GM = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
     if (GM)
     {
@@ -86,16 +88,17 @@ bool ABuilding_Barracks::StoreUnit(ABaseUnit* UnitToStore)
         }
     }
 
-    //  Actor
-    UnitToStore->Destroy();
+    // 放回对象池 (放兵时再取出来)
+    if (AUnitPool* Pool = AUnitPool::Get(this)) Pool->Release(UnitToStore);
+    else UnitToStore->Destroy();
 
     UE_LOG(LogTemp, Warning, TEXT("Unit Stored in Barracks! Total: %d"), StoredUnits.Num());
 
-    //  trueʾɹ
+    // 返回 true，表示成功
     return true;
 }
 
-// ͷ߼
+// 释放逻辑
 void ABuilding_Barracks::ReleaseAllUnits()
 {
     if (StoredUnits.Num() == 0) return;
@@ -105,17 +108,20 @@ void ABuilding_Barracks::ReleaseAllUnits()
 
     if (!GameMode || !GM) return;
 
-    // 
+    // 本次放出来的兵 (最后统一编队)
+    TArray<ABaseUnit*> ReleasedUnits;
+
+    // 遍历库存
     for (int32 i = StoredUnits.Num() - 1; i >= 0; i--)
     {
         FUnitSaveData UnitData = StoredUnits[i];
 
-        // --- Ѱҿλ (ӱӪλÿʼɢ) ---
+        // --- 寻找空位 (从兵营位置开始向外扩散) ---
         bool bFoundSpot = false;
         int32 TargetX = GridX;
         int32 TargetY = GridY;
 
-        // 뾶 1 ʼ (ΧһȦȦ...)
+        // 半径从 1 开始扩 (找周围一圈，再两圈...)
         for (int32 Radius = 1; Radius <= 5; Radius++)
         {
             for (int32 x = GridX - Radius; x <= GridX + Radius; x++)
@@ -127,56 +133,63 @@ void ABuilding_Barracks::ReleaseAllUnits()
                         TargetX = x;
                         TargetY = y;
                         bFoundSpot = true;
-                        goto SpotFound; // ѭ
+                        goto SpotFound; // 跳出循环
                     }
                 }
             }
         }
         SpotFound:;
 
-        // ҵλɣ
+        // 如果找到空位，生成！
         if (bFoundSpot)
         {
-            if (GameMode->SpawnUnitAt(UnitData.UnitType, TargetX, TargetY))
+            if (ABaseUnit* NewUnit = GameMode->SpawnUnitAt(UnitData.UnitType, TargetX, TargetY))
             {
-                // ɳɹӲֿƳ
+                // 生成成功，从仓库移除
                 StoredUnits.RemoveAt(i);
+                ReleasedUnits.Add(NewUnit);
             }
         }
         else
         {
             UE_LOG(LogTemp, Warning, TEXT("Barracks full! No space to release unit."));
-            break; // Χˣ
+            break; // 周围堵死了，别放了
         }
     }
+
+    // 一起放出来的兵编成小队
+    if (ACrowdManager* CrowdManager = ACrowdManager::Get(this))
+    {
+        CrowdManager->CreateSquads(ReleasedUnits);
+    }
 }
 
-// ߼
+// 升级逻辑
 void ABuilding_Barracks::LevelUp()
 {
-    // 1. Ƿ
+    // 1. 检查是否能升级
     if (!CanUpgrade()) return;
 
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI || TeamID != ETeam::Player)
     {
-        Super::LevelUp();  // ұӪִֻл
+        Super::LevelUp();  // 非玩家兵营只执行基本升级
         return;
     }
 
-    // 2. ȡǰȼǰ
+    // 2. 获取当前等级容量（升级前）
     int32 OldCapacity = GetCurrentCapacity(BuildingLevel);
 
-    // 3. ִи BuildingLevel
+    // 3. 先执行父类升级（这会增加 BuildingLevel）
     Super::LevelUp();
 
-    // 4. ȡµȼ
+    // 4. 获取新等级容量
     int32 NewCapacity = GetCurrentCapacity(BuildingLevel);
 
-    // 5. 㾻ӵ˿
+    // 5. 计算净增加的人口
     int32 NetIncrease = NewCapacity - OldCapacity;
 
-    // 6. ˿
+    // 6. 更新人口上限
     GI->MaxPopulation += NetIncrease;
 
     UE_LOG(LogTemp, Warning, TEXT("Barracks Upgraded Lv%d->Lv%d. Pop: +%d (Net). Total MaxPop: %d"),
@@ -184,11 +197,11 @@ void ABuilding_Barracks::LevelUp()
 }
 
 
-// ֻӾЧֵ߼
+// 这个函数现在只负责视觉效果，不负责数值，避免逻辑混乱
 void ABuilding_Barracks::ApplyLevelUpBonus()
 {
     Super::ApplyLevelUpBonus();
-    // ԼЧ󡢲
+    // 这里可以加特效，比如变大、播放声音
 }
 
 TArray<EUnitType> ABuilding_Barracks::GetStoredUnitTypes() const
@@ -208,7 +221,7 @@ void ABuilding_Barracks::RestoreStoredUnits(const TArray<EUnitType>& InUnits)
     {
         FUnitSaveData Data;
         Data.UnitType = Type;
-        // GridX/Y ҪΪڲֿ
+        // GridX/Y 不重要，因为是在仓库里
         StoredUnits.Add(Data);
     }
 }
\ No newline at end of file
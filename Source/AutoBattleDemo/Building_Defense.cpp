@@ -1,152 +1,171 @@
 #include "Building_Defense.h"
 #include "BaseUnit.h"
-#include "Kismet/GameplayStatics.h"
 #include "RTSProjectile.h" 
+#include "ProjectileManager.h"
+#include "CrowdManager.h"
 #include "DrawDebugHelpers.h"
 
 ABuilding_Defense::ABuilding_Defense()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // 不 Tick：有敌人进入射程才唤醒，开火按时间轮安排
+    PrimaryActorTick.bCanEverTick = false;
 
     BuildingType = EBuildingType::Defense;
 
-    // Ĭ
+    // 防御塔默认属性
     MaxHealth = 800.0f;
     AttackRange = 600.0f;
     Damage = 20.0f;
-    FireRate = 1.0f; // ÿ1
+    FireRate = 1.0f; // 每秒1发
 
-    CurrentTarget = nullptr;
     LastFireTime = 0.0f;
+    bIsAwake = false;
+    ProjectileManagerRef = nullptr;
 }
 
 void ABuilding_Defense::BeginPlay()
 {
     Super::BeginPlay();
 
+    // 登记射程格子 (之后升级改射程时重新登记)
+    if (IsValid(CrowdManagerRef)) CrowdManagerRef->RegisterDefenseWatch(this);
+
+    // 只有发射子弹的塔才需要子弹管理器
+    if (ProjectileClass) ProjectileManagerRef = AProjectileManager::Get(this);
+
     UE_LOG(LogTemp, Warning, TEXT("[Defense] %s ready | Range: %f | Damage: %f | FireRate: %f/s"),
         *GetName(), AttackRange, Damage, FireRate);
 }
  
-void ABuilding_Defense::Tick(float DeltaTime)
+void ABuilding_Defense::OnScheduledAction()
 {
-    Super::Tick(DeltaTime);
+    // 目标死亡后句柄解析为空
+    ABaseGameEntity* Target = ResolveEntity(CurrentTarget);
 
-    // ƹΧã
-    // DrawAttackRange();
+    // 在路上的子弹已经够打死它了，换一个
+    if (Target && Target->IsDoomed())
+    {
+        if (IsValid(CrowdManagerRef)) CrowdManagerRef->NoteDoomedTargetSkipped();
+        Target = nullptr;
+    }
 
-    // ûĿĿʧЧѰĿ
-    if (!CurrentTarget || CurrentTarget->IsPendingKill())
+    // 目标走出射程
+    if (Target && FVector::Dist2D(GetActorLocation(), Target->GetActorLocation()) > AttackRange)
     {
-        CurrentTarget = FindTargetInRange();
+        Target = nullptr;
     }
 
-    // Ŀִ꣬й
-    if (CurrentTarget)
+    if (!Target)
     {
-        // ĿǷڷΧ
-        float Distance = FVector::Dist(GetActorLocation(), CurrentTarget->GetActorLocation());
-        if (Distance > AttackRange)
-        {
-            CurrentTarget = nullptr; // Ŀ곬Χ
-            return;
-        }
+        Target = FindTargetInRange();
+        SetCurrentTarget(Target);
+    }
 
-        // ȴ
-        float CurrentTime = GetWorld()->GetTimeSeconds();
-        if (CurrentTime - LastFireTime >= (1.0f / FireRate))
-        {
-            PerformAttack();
-            LastFireTime = CurrentTime;
-        }
+    // 射程里没有敌人了：休眠
+    if (!Target)
+    {
+        GoToSleep();
+        return;
+    }
+
+    // 冷却好了就开火，下一发直接安排在冷却结束的时间
+    const float CurrentTime = GetWorld()->GetTimeSeconds();
+    const float NextFireTime = LastFireTime + GetFireInterval();
+    if (CurrentTime >= NextFireTime)
+    {
+        PerformAttack();
+        LastFireTime = CurrentTime;
+        ScheduleAction(CurrentTime + GetFireInterval());
+    }
+    else
+    {
+        ScheduleAction(NextFireTime);
     }
 }
 
-AActor* ABuilding_Defense::FindTargetInRange()
+void ABuilding_Defense::WakeUp()
 {
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), AllUnits);
-
-    AActor* ClosestEnemy = nullptr;
-    float ClosestDistance = FLT_MAX;
+    if (bIsAwake || IsDead()) return;
+    bIsAwake = true;
 
-    for (AActor* Actor : AllUnits)
+    // 冷却已经好了就当场开火，否则等到能开火时
+    const float NextFireTime = LastFireTime + GetFireInterval();
+    if (GetWorld()->GetTimeSeconds() >= NextFireTime)
     {
-        ABaseUnit* Unit = Cast<ABaseUnit>(Actor);
-        if (!Unit) continue;
-
-        // ɸѡжӪ + 
-        if (Unit->TeamID != this->TeamID && Unit->CurrentHealth > 0)
-        {
-            float Distance = FVector::Dist(GetActorLocation(), Unit->GetActorLocation());
-
-            if (Distance <= AttackRange && Distance < ClosestDistance)
-            {
-                ClosestDistance = Distance;
-                ClosestEnemy = Unit;
-            }
-        }
+        OnScheduledAction();
     }
-
-    if (ClosestEnemy)
+    else
     {
-        UE_LOG(LogTemp, Log, TEXT("[Defense] %s locked target: %s (Distance: %f)"),
-            *GetName(), *ClosestEnemy->GetName(), ClosestDistance);
+        ScheduleAction(NextFireTime);
     }
+}
 
-    return ClosestEnemy;
+void ABuilding_Defense::GoToSleep()
+{
+    bIsAwake = false;
+    SetCurrentTarget(nullptr);
+    CancelScheduledAction();
 }
 
-void ABuilding_Defense::PerformAttack()
+void ABuilding_Defense::SetCurrentTarget(ABaseGameEntity* NewTarget)
 {
-    if (!CurrentTarget) return;
+    UpdateTargetTracking(ResolveEntity(CurrentTarget), NewTarget);
+    CurrentTarget = NewTarget ? NewTarget->GetEntityHandle() : FEntityHandle();
+}
 
-    ABaseUnit* TargetUnit = Cast<ABaseUnit>(CurrentTarget);
-    if (!TargetUnit || TargetUnit->CurrentHealth <= 0)
+void ABuilding_Defense::OnTargetLost(ABaseGameEntity* LostTarget)
+{
+    if (LostTarget && LostTarget->GetEntityHandle() == CurrentTarget)
     {
-        CurrentTarget = nullptr;
-        return;
+        CurrentTarget.Reset();
     }
+}
+
+ABaseUnit* ABuilding_Defense::FindTargetInRange()
+{
+    // 在群体管理器的空间格子上查射程内最近的敌方单位 (活着、不是必死)，不再遍历全部单位
+    if (!IsValid(CrowdManagerRef)) return nullptr;
+    return Cast<ABaseUnit>(CrowdManagerRef->FindNearestEnemyUnit(GetActorLocation(), AttackRange, TeamID));
+}
+
+void ABuilding_Defense::PerformAttack()
+{
+    ABaseUnit* TargetUnit = Cast<ABaseUnit>(ResolveEntity(CurrentTarget));
+    if (!TargetUnit) return;
 
-    // 1. 㳯 (ת)
+    // 1. 计算朝向 (塔身旋转面向敌人)
     FVector Direction = (TargetUnit->GetActorLocation() - GetActorLocation()).GetSafeNormal();
     if (!Direction.IsNearlyZero())
     {
         FRotator NewRotation = Direction.Rotation();
-        NewRotation.Pitch = 0; // ֻתˮƽ򣬲̧ͷ
+        NewRotation.Pitch = 0; // 塔身只转水平方向，不抬头
         NewRotation.Roll = 0;
         SetActorRotation(NewRotation);
     }
 
-    // 2. ߼
+    // 2. 攻击逻辑分流
     if (ProjectileClass)
     {
-        // ---  A: ʵӵ (Ӿֺ) ---
+        // --- 方案 A: 发射实体子弹 (视觉表现好) ---
 
-        // 㷢㣺䣬
-        // Լ 200Ǵ 150 ĸ߶ȷ (Լһ ArrowComponent Ϊǹ)
+        // 计算发射点：从塔顶发射，而不是塔底
+        // 假设塔高约 200，我们从 150 的高度发射 (或者你可以加一个 ArrowComponent 作为枪口)
         FVector SpawnLocation = GetActorLocation() + FVector(0.f, 0.f, 150.0f);
 
-        // ӵĳָ
-        FRotator SpawnRotation = (TargetUnit->GetActorLocation() - SpawnLocation).Rotation();
-
-        // ӵ
-        ARTSProjectile* NewProjectile = GetWorld()->SpawnActor<ARTSProjectile>(ProjectileClass, SpawnLocation, SpawnRotation);
-
-        if (NewProjectile)
+        // 交给子弹管理器 (告诉它打谁、伤害多少、谁发射的)
+        if (!IsValid(ProjectileManagerRef)) ProjectileManagerRef = AProjectileManager::Get(this);
+        if (ProjectileManagerRef)
         {
-            // ʼӵ (˭˺١˭)
-            NewProjectile->Initialize(TargetUnit, Damage, this);
+            ProjectileManagerRef->Launch(ProjectileClass, SpawnLocation, TargetUnit, Damage, this);
 
             UE_LOG(LogTemp, Log, TEXT("[Defense] %s Fired Projectile!"), *GetName());
         }
     }
     else
     {
-        // ---  B: ֱ˺ (߼ֹûӵʱû˺) ---
+        // --- 方案 B: 直接伤害 (保底逻辑，防止没配子弹时没伤害) ---
 
-        FDamageEvent DamageEvent;
-        TargetUnit->TakeDamage(Damage, DamageEvent, nullptr, this);
+        DealDamage(TargetUnit, Damage);
 
         UE_LOG(LogTemp, Log, TEXT("[Defense] %s Instant Hit %s!"), *GetName(), *TargetUnit->GetName());
     }
@@ -156,17 +175,20 @@ void ABuilding_Defense::ApplyLevelUpBonus()
 {
     Super::ApplyLevelUpBonus();
 
-    // ÿ 15%  10% Χ
+    // 每级提升 15% 攻击力和 10% 攻击范围
     Damage *= 1.15f;
     AttackRange *= 1.1f;
 
+    // 射程变了，重新登记唤醒格子
+    if (IsValid(CrowdManagerRef)) CrowdManagerRef->RegisterDefenseWatch(this);
+
     UE_LOG(LogTemp, Warning, TEXT("[Defense] %s upgraded | Damage: %f | Range: %f"),
         *GetName(), Damage, AttackRange);
 }
 
 //void ABuilding_Defense::DrawAttackRange()
 //{
-//    // ÿ0.5һηΧȦã
+//    // 每0.5秒绘制一次范围圈（调试用）
 //    static float LastDrawTime = 0.0f;
 //    float CurrentTime = GetWorld()->GetTimeSeconds();
 //
@@ -3,6 +3,11 @@
 #include "BaseBuilding.h"
 #include "Building_Defense.generated.h"
 
+/**
+ * 防御塔
+ * 不 Tick：射程覆盖的格子登记在群体管理器里，有敌方单位进入才被唤醒；
+ * 醒着时按射速 (FireRate) 在群体管理器的时间轮上安排下一发，射程里没有敌人就再次休眠
+ */
 UCLASS()
 class AUTOBATTLEDEMO_API ABuilding_Defense : public ABaseBuilding
 {
@@ -12,9 +17,18 @@ public:
     ABuilding_Defense();
 
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
 
-    // ---  ---
+    // 冷却结束：选目标、开火，安排下一发
+    virtual void OnScheduledAction() override;
+
+    // 锁定的单位死了 / 被收回
+    virtual void OnTargetLost(ABaseGameEntity* LostTarget) override;
+
+    // 有敌方单位进入射程格子 (群体管理器的唤醒阶段调用)
+    void WakeUp();
+    bool IsAwake() const { return bIsAwake; }
+
+    // --- 防御塔属性 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Defense")
         float AttackRange;
 
@@ -22,32 +36,45 @@ public:
         float Damage;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Defense")
-        float FireRate; // ÿ뿪
+        float FireRate; // 每秒开火次数
 
     
 
 protected:
-    // ʱ
+    // 升级时提升攻击力
     virtual void ApplyLevelUpBonus() override;
 
-    // ӵͼ (ڱ༭ BP_Arrow)
+    // 子弹蓝图类 (在编辑器里配置 BP_Arrow)
     UPROPERTY(EditDefaultsOnly, Category = "Combat")
         TSubclassOf<class ARTSProjectile> ProjectileClass;
 
+    // 子弹管理器 (BeginPlay 时取一次，开火时不再查找)
+    UPROPERTY()
+        class AProjectileManager* ProjectileManagerRef;
+
 private:
-    // ѰҷΧĵ
-    AActor* FindTargetInRange();
+    // 寻找范围内最近的敌人
+    ABaseUnit* FindTargetInRange();
 
-    // ִй
+    // 执行攻击
     void PerformAttack();
 
-    // ǰĿ
-    UPROPERTY()
-        AActor* CurrentTarget;
+    // 修改 CurrentTarget 都走这里 (维护目标的攻击者列表)
+    void SetCurrentTarget(ABaseGameEntity* NewTarget);
+
+    // 射程里没有敌人：取消下一发，等群体管理器唤醒
+    void GoToSleep();
+
+    float GetFireInterval() const { return 1.0f / FMath::Max(FireRate, KINDA_SMALL_NUMBER); }
+
+    bool bIsAwake;
+
+    // 当前锁定的目标 (句柄，目标死亡后解析为空)
+    FEntityHandle CurrentTarget;
 
-    // ʱ
+    // 攻击计时器
     float LastFireTime;
 
-    // ӻ
+    // 可视化调试
     // void DrawAttackRange();
 };
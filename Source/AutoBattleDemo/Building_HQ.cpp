@@ -5,7 +5,7 @@
 ABuilding_HQ::ABuilding_HQ()
 {
     BuildingType = EBuildingType::Headquarters;
-    MaxHealth = 5000.0f; // ӪѪ
+    MaxHealth = 5000.0f; // 大本营血厚
     TeamID = ETeam::Player;
 }
 
@@ -13,13 +13,13 @@ void ABuilding_HQ::BeginPlay()
 {
     Super::BeginPlay();
 
-    // ֻҵ HQ ż˿
+    // 只有玩家的 HQ 才加人口
     if (TeamID == ETeam::Player)
     {
         URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
         if (GI)
         {
-            GI->MaxPopulation += 20; // ˿
+            GI->MaxPopulation += 20; // 基础人口
             UE_LOG(LogTemp, Log, TEXT("HQ Built! MaxPop +20. Current: %d"), GI->MaxPopulation);
         }
     }
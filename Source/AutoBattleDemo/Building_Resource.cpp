@@ -2,20 +2,21 @@
 
 ABuilding_Resource::ABuilding_Resource()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // 不 Tick：产量用到时再算
+    PrimaryActorTick.bCanEverTick = false;
 
     BuildingType = EBuildingType::GoldMine;
 
-    // Դ
+    // 资源建筑属性
     MaxHealth = 600.0f;
-    ProductionRate = 10.0f;    // ÿ10
+    ProductionRate = 10.0f;    // 每秒10金币
     MaxStorage = 1000.0f;
-    CurrentStorage = 0.0f;
-    bProducesGold = true;      // Ĭϲ
+    SettledStorage = 0.0f;
+    bProducesGold = true;      // 默认产金币
 
-    ProductionTimer = 0.0f;
+    LastProductionTime = FDateTime::UtcNow();
 
-    // Դͨ
+    // 资源建筑通常属于玩家
     TeamID = ETeam::Player;
     bIsTargetable = true;
 }
@@ -26,35 +27,43 @@ void ABuilding_Resource::BeginPlay()
 
     UE_LOG(LogTemp, Log, TEXT("[Resource] %s | Rate: %f/s | MaxStorage: %f | Type: %s"),
         *GetName(), ProductionRate, MaxStorage, bProducesGold ? TEXT("Gold") : TEXT("Elixir"));
+
+    // 从现在开始累积 (读档时会被 RestoreProductionState 覆盖)
+    LastProductionTime = FDateTime::UtcNow();
 }
 
-void ABuilding_Resource::Tick(float DeltaTime)
+float ABuilding_Resource::GetCurrentStorage() const
 {
-    Super::Tick(DeltaTime);
+    // 系统时间被往回调的话不倒扣
+    const double Elapsed = FMath::Max(0.0, (FDateTime::UtcNow() - LastProductionTime).GetTotalSeconds());
+    return (float)FMath::Min((double)MaxStorage, SettledStorage + ProductionRate * Elapsed);
+}
 
-    // Դ߼
-    if (CurrentStorage < MaxStorage)
-    {
-        ProductionTimer += DeltaTime;
+void ABuilding_Resource::SettleProduction()
+{
+    SettledStorage = GetCurrentStorage();
+    LastProductionTime = FDateTime::UtcNow();
+}
 
-        // ÿһ
-        if (ProductionTimer >= 1.0f)
-        {
-            float ProducedAmount = ProductionRate * ProductionTimer;
-            CurrentStorage = FMath::Min(CurrentStorage + ProducedAmount, MaxStorage);
+void ABuilding_Resource::SaveProductionState(FBuildingSaveData& OutData) const
+{
+    OutData.StoredResource = SettledStorage;
+    OutData.LastProductionTime = LastProductionTime;
+}
 
-            ProductionTimer = 0.0f;
+void ABuilding_Resource::RestoreProductionState(const FBuildingSaveData& Data)
+{
+    // 旧存档没有时间戳：从现在开始算
+    SettledStorage = FMath::Min(Data.StoredResource, MaxStorage);
+    LastProductionTime = (Data.LastProductionTime.GetTicks() > 0) ? Data.LastProductionTime : FDateTime::UtcNow();
 
-            // 
-            UE_LOG(LogTemp, Log, TEXT("[Resource] %s produced %.1f | Storage: %.0f/%.0f"),
-                *GetName(), ProducedAmount, CurrentStorage, MaxStorage);
-        }
-    }
+    UE_LOG(LogTemp, Log, TEXT("[Resource] %s restored | Storage: %.0f/%.0f (incl. offline production)"),
+        *GetName(), GetCurrentStorage(), MaxStorage);
 }
 
 float ABuilding_Resource::CollectResource()
 {
-    // Ӫ飺ֻԼĽռ
+    // 添加阵营检查：只有玩家自己的建筑才能收集
     if (TeamID != ETeam::Player)
     {
         UE_LOG(LogTemp, Warning, TEXT("[Resource] Cannot collect from enemy building!"));
@@ -68,8 +77,9 @@ float ABuilding_Resource::CollectResource()
         return 0.0f;
     }
 
-    float CollectedAmount = CurrentStorage;
-    CurrentStorage = 0.0f;
+    float CollectedAmount = GetCurrentStorage();
+    SettledStorage = 0.0f;
+    LastProductionTime = FDateTime::UtcNow();
 
     UE_LOG(LogTemp, Warning, TEXT("[Resource] %s collected %.0f %s!"),
         *GetName(), CollectedAmount, bProducesGold ? TEXT("Gold") : TEXT("Elixir"));
@@ -88,7 +98,10 @@ void ABuilding_Resource::ApplyLevelUpBonus()
 {
     Super::ApplyLevelUpBonus();
 
-    // ÿ 20%  30% 洢
+    // 旧产量下累积的先结算
+    SettleProduction();
+
+    // 每级提升 20% 产量和 30% 存储上限
     ProductionRate *= 1.2f;
     MaxStorage *= 1.3f;
 
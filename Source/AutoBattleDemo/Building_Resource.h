@@ -4,8 +4,10 @@
 #include "Building_Resource.generated.h"
 
 /**
- * Դ󳡣
- * ܣÿԴ
+ * 资源建筑（矿场）
+ * 功能：每秒产出资源
+ * 不 Tick：只记录上次结算的存量和时间，用到时再算 min(上限, 存量 + 产量 × 经过的时间)
+ * 时间用真实时间 (UTC)，连同存量一起存进 FBuildingSaveData，切关卡、退出游戏期间也照常累积
  */
 UCLASS()
 class AUTOBATTLEDEMO_API ABuilding_Resource : public ABaseBuilding
@@ -16,29 +18,39 @@ public:
     ABuilding_Resource();
 
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
 
-    // --- Դ ---
+    // --- 资源生产属性 ---
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource")
-        float ProductionRate; // ÿ
+        float ProductionRate; // 每秒产量
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource")
-        float MaxStorage; // 洢
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Resource")
-        float CurrentStorage; // ǰ洢
+        float MaxStorage; // 最大存储量
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Resource")
-        bool bProducesGold; // true=, false=ʥˮ
+        bool bProducesGold; // true=金币, false=圣水
 
-        // ռԴҵã
+        // 收集资源（供玩家点击调用）
     UFUNCTION(BlueprintCallable, Category = "Resource")
         float CollectResource();
 
+    // 当前存储量 (按经过的时间现算)
+    UFUNCTION(BlueprintPure, Category = "Resource")
+        float GetCurrentStorage() const;
+
+    // 存档 / 读档：存量和结算时间
+    void SaveProductionState(FBuildingSaveData& OutData) const;
+    void RestoreProductionState(const FBuildingSaveData& Data);
+
 protected:
     virtual void ApplyLevelUpBonus() override;
 
 private:
-    // Դʱ
-    float ProductionTimer;
+    // 把到现在为止的产量计入 SettledStorage (改产量、上限之前调用)
+    void SettleProduction();
+
+    // 上次结算时的存储量 (实时的用 GetCurrentStorage)
+    float SettledStorage;
+
+    // 上次结算的时间 (UTC)
+    FDateTime LastProductionTime;
 };
\ No newline at end of file
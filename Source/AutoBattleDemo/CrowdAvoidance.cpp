@@ -0,0 +1,214 @@
+#include "CrowdAvoidance.h"
+
+namespace
+{
+    const float OrcaEpsilon = 0.00001f;
+
+    // 二维叉积
+    FORCEINLINE float Det(const FVector2D& A, const FVector2D& B)
+    {
+        return A.X * B.Y - A.Y * B.X;
+    }
+}
+
+FOrcaLine FCrowdAvoidance::MakeAgentLine(const FVector2D& RelativePosition, const FVector2D& Velocity, const FVector2D& OtherVelocity,
+    float CombinedRadius, float TimeHorizon, float DeltaTime, float Responsibility)
+{
+    FOrcaLine Line;
+    FVector2D U;
+
+    const FVector2D RelativeVelocity = Velocity - OtherVelocity;
+    const float DistSq = RelativePosition.SizeSquared();
+    const float CombinedRadiusSq = FMath::Square(CombinedRadius);
+
+    if (DistSq > CombinedRadiusSq)
+    {
+        // 还没碰上：速度障碍是一个截头圆锥
+        const float InvTimeHorizon = 1.0f / TimeHorizon;
+        const FVector2D W = RelativeVelocity - RelativePosition * InvTimeHorizon;
+        const float WLengthSq = W.SizeSquared();
+        const float DotProduct1 = W | RelativePosition;
+
+        if (DotProduct1 < 0.0f && FMath::Square(DotProduct1) > CombinedRadiusSq * WLengthSq)
+        {
+            // 投影到截断圆上
+            const float WLength = FMath::Sqrt(WLengthSq);
+            const FVector2D UnitW = W / WLength;
+            Line.Direction = FVector2D(UnitW.Y, -UnitW.X);
+            U = UnitW * (CombinedRadius * InvTimeHorizon - WLength);
+        }
+        else
+        {
+            // 投影到圆锥的两条腰上
+            const float Leg = FMath::Sqrt(DistSq - CombinedRadiusSq);
+            if (Det(RelativePosition, W) > 0.0f)
+            {
+                Line.Direction = FVector2D(RelativePosition.X * Leg - RelativePosition.Y * CombinedRadius,
+                    RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistSq;
+            }
+            else
+            {
+                Line.Direction = -FVector2D(RelativePosition.X * Leg + RelativePosition.Y * CombinedRadius,
+                    -RelativePosition.X * CombinedRadius + RelativePosition.Y * Leg) / DistSq;
+            }
+
+            const float DotProduct2 = RelativeVelocity | Line.Direction;
+            U = Line.Direction * DotProduct2 - RelativeVelocity;
+        }
+    }
+    else
+    {
+        // 已经重叠：要求在这一帧内分开
+        const float InvTimeStep = 1.0f / FMath::Max(DeltaTime, KINDA_SMALL_NUMBER);
+        const FVector2D W = RelativeVelocity - RelativePosition * InvTimeStep;
+        const float WLength = W.Size();
+        const FVector2D UnitW = (WLength > OrcaEpsilon) ? W / WLength : FVector2D(1.0f, 0.0f);
+        Line.Direction = FVector2D(UnitW.Y, -UnitW.X);
+        U = UnitW * (CombinedRadius * InvTimeStep - WLength);
+    }
+
+    Line.Point = Velocity + U * Responsibility;
+    return Line;
+}
+
+FVector2D FCrowdAvoidance::SolveVelocity(const FOrcaLineArray& Lines, int32 NumObstacleLines, float MaxSpeed, const FVector2D& PreferredVelocity)
+{
+    FVector2D Result = FVector2D::ZeroVector;
+    const int32 LineFail = LinearProgram2(Lines, MaxSpeed, PreferredVelocity, false, Result);
+    if (LineFail < Lines.Num())
+    {
+        // 约束互相冲突：在不违反障碍约束的前提下，让最大违反量最小
+        LinearProgram3(Lines, NumObstacleLines, LineFail, MaxSpeed, Result);
+    }
+    return Result;
+}
+
+// 在第 LineNo 条约束线上求解 (一维)
+bool FCrowdAvoidance::LinearProgram1(const FOrcaLineArray& Lines, int32 LineNo, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result)
+{
+    const FOrcaLine& Line = Lines[LineNo];
+    const float DotProduct = Line.Point | Line.Direction;
+    const float Discriminant = FMath::Square(DotProduct) + FMath::Square(Radius) - Line.Point.SizeSquared();
+
+    // 最大速度圆与这条线不相交
+    if (Discriminant < 0.0f) return false;
+
+    const float SqrtDiscriminant = FMath::Sqrt(Discriminant);
+    float TLeft = -DotProduct - SqrtDiscriminant;
+    float TRight = -DotProduct + SqrtDiscriminant;
+
+    for (int32 i = 0; i < LineNo; ++i)
+    {
+        const float Denominator = Det(Line.Direction, Lines[i].Direction);
+        const float Numerator = Det(Lines[i].Direction, Line.Point - Lines[i].Point);
+
+        if (FMath::Abs(Denominator) <= OrcaEpsilon)
+        {
+            // 两条线平行
+            if (Numerator < 0.0f) return false;
+            continue;
+        }
+
+        const float T = Numerator / Denominator;
+        if (Denominator >= 0.0f)
+        {
+            TRight = FMath::Min(TRight, T);
+        }
+        else
+        {
+            TLeft = FMath::Max(TLeft, T);
+        }
+
+        if (TLeft > TRight) return false;
+    }
+
+    if (bDirectionOpt)
+    {
+        Result = Line.Point + Line.Direction * (((OptVelocity | Line.Direction) > 0.0f) ? TRight : TLeft);
+    }
+    else
+    {
+        const float T = Line.Direction | (OptVelocity - Line.Point);
+        Result = Line.Point + Line.Direction * FMath::Clamp(T, TLeft, TRight);
+    }
+    return true;
+}
+
+// 逐条加入约束求解 (二维)，返回第一条无法满足的约束下标
+int32 FCrowdAvoidance::LinearProgram2(const FOrcaLineArray& Lines, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result)
+{
+    if (bDirectionOpt)
+    {
+        // 此时 OptVelocity 是单位向量
+        Result = OptVelocity * Radius;
+    }
+    else if (OptVelocity.SizeSquared() > FMath::Square(Radius))
+    {
+        Result = OptVelocity.GetSafeNormal() * Radius;
+    }
+    else
+    {
+        Result = OptVelocity;
+    }
+
+    for (int32 i = 0; i < Lines.Num(); ++i)
+    {
+        if (Det(Lines[i].Direction, Lines[i].Point - Result) > 0.0f)
+        {
+            // 当前结果违反了第 i 条约束
+            const FVector2D TempResult = Result;
+            if (!LinearProgram1(Lines, i, Radius, OptVelocity, bDirectionOpt, Result))
+            {
+                Result = TempResult;
+                return i;
+            }
+        }
+    }
+
+    return Lines.Num();
+}
+
+// 无可行解时的兜底 (三维)
+void FCrowdAvoidance::LinearProgram3(const FOrcaLineArray& Lines, int32 NumObstacleLines, int32 BeginLine, float Radius, FVector2D& Result)
+{
+    float Distance = 0.0f;
+    FOrcaLineArray ProjLines;
+
+    for (int32 i = BeginLine; i < Lines.Num(); ++i)
+    {
+        if (Det(Lines[i].Direction, Lines[i].Point - Result) <= Distance) continue;
+
+        // 障碍约束原样保留
+        ProjLines.Reset();
+        ProjLines.Append(Lines.GetData(), NumObstacleLines);
+
+        for (int32 j = NumObstacleLines; j < i; ++j)
+        {
+            FOrcaLine Line;
+            const float Determinant = Det(Lines[i].Direction, Lines[j].Direction);
+
+            if (FMath::Abs(Determinant) <= OrcaEpsilon)
+            {
+                // 同向平行的约束可以忽略
+                if ((Lines[i].Direction | Lines[j].Direction) > 0.0f) continue;
+                Line.Point = (Lines[i].Point + Lines[j].Point) * 0.5f;
+            }
+            else
+            {
+                Line.Point = Lines[i].Point + Lines[i].Direction * (Det(Lines[j].Direction, Lines[i].Point - Lines[j].Point) / Determinant);
+            }
+
+            Line.Direction = (Lines[j].Direction - Lines[i].Direction).GetSafeNormal();
+            ProjLines.Add(Line);
+        }
+
+        const FVector2D TempResult = Result;
+        if (LinearProgram2(ProjLines, Radius, FVector2D(-Lines[i].Direction.Y, Lines[i].Direction.X), true, Result) < ProjLines.Num())
+        {
+            // 理论上不会发生，浮点误差时保持原结果
+            Result = TempResult;
+        }
+
+        Distance = Det(Lines[i].Direction, Lines[i].Point - Result);
+    }
+}
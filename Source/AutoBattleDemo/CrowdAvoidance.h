@@ -0,0 +1,33 @@
+#pragma once
+#include "CoreMinimal.h"
+
+// ORCA 半平面约束：可行速度位于 Direction 的左侧
+struct FOrcaLine
+{
+    FVector2D Point = FVector2D::ZeroVector;
+    FVector2D Direction = FVector2D::ZeroVector;
+};
+
+// 一次求解的约束列表：周围的阻挡格子加上降级后的邻居上限 (12) 一般放得下，不用在工作线程上分配堆内存
+typedef TArray<FOrcaLine, TInlineAllocator<32>> FOrcaLineArray;
+
+/**
+ * ORCA (Optimal Reciprocal Collision Avoidance) 局部避让求解器
+ * 纯计算，不访问 UObject，可以在决策阶段的工作线程上调用
+ * 算法参考 RVO2：每个邻居 / 障碍生成一条半平面约束，再用二维线性规划求出最接近期望速度的可行速度
+ */
+struct FCrowdAvoidance
+{
+    // 与另一个圆形体之间的约束
+    // Responsibility: 自己承担的避让比例 (互相避让时为 0.5，对方不动时为 1)
+    static FOrcaLine MakeAgentLine(const FVector2D& RelativePosition, const FVector2D& Velocity, const FVector2D& OtherVelocity,
+        float CombinedRadius, float TimeHorizon, float DeltaTime, float Responsibility);
+
+    // 求解新速度：前 NumObstacleLines 条是静态障碍约束，无解时不会被放宽
+    static FVector2D SolveVelocity(const FOrcaLineArray& Lines, int32 NumObstacleLines, float MaxSpeed, const FVector2D& PreferredVelocity);
+
+private:
+    static bool LinearProgram1(const FOrcaLineArray& Lines, int32 LineNo, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result);
+    static int32 LinearProgram2(const FOrcaLineArray& Lines, float Radius, const FVector2D& OptVelocity, bool bDirectionOpt, FVector2D& Result);
+    static void LinearProgram3(const FOrcaLineArray& Lines, int32 NumObstacleLines, int32 BeginLine, float Radius, FVector2D& Result);
+};
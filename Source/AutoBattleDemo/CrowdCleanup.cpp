@@ -0,0 +1,87 @@
+#include "CrowdCleanup.h"
+#include "CrowdManager.h"
+#include "BaseGameEntity.h"
+#include "BaseUnit.h"
+#include "UnitPool.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_CYCLE_STAT(TEXT("Dead Entity Cleanup"), STAT_CrowdCleanup, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dead Entities Pending Cleanup"), STAT_CrowdCleanupPending, STATGROUP_RTSCrowd);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Last GC (ms)"), STAT_CrowdLastGCMs, STATGROUP_RTSCrowd);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Max GC (ms)"), STAT_CrowdMaxGCMs, STATGROUP_RTSCrowd);
+
+void FCrowdCleanupQueue::Add(ABaseGameEntity* Entity)
+{
+    if (Entity) Pending.AddUnique(Entity);
+}
+
+int32 FCrowdCleanupQueue::Process(const UObject* WorldContextObject, AUnitPool*& PoolRef, float BudgetMs)
+{
+    if (Pending.Num() == 0)
+    {
+        SET_DWORD_STAT(STAT_CrowdCleanupPending, 0);
+        return 0;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_CrowdCleanup);
+
+    // 先死的先销毁，超出预算的留到下一帧
+    const double BudgetSeconds = FMath::Max(0.0f, BudgetMs) / 1000.0;
+    const double StartTime = FPlatformTime::Seconds();
+
+    int32 Processed = 0;
+    int32 Cleaned = 0;
+    while (Processed < Pending.Num())
+    {
+        ABaseGameEntity* Entity = Pending[Processed++];
+        if (IsValid(Entity))
+        {
+            // 单位回对象池，建筑照常销毁
+            ABaseUnit* Unit = Cast<ABaseUnit>(Entity);
+            if (Unit && !IsValid(PoolRef)) PoolRef = AUnitPool::Get(WorldContextObject);
+            if (Unit && PoolRef) PoolRef->Release(Unit);
+            else Entity->Destroy();
+            ++Cleaned;
+        }
+
+        if (FPlatformTime::Seconds() - StartTime >= BudgetSeconds) break;
+    }
+    Pending.RemoveAt(0, Processed, false);
+
+    SET_DWORD_STAT(STAT_CrowdCleanupPending, Pending.Num());
+    return Cleaned;
+}
+
+void FCrowdGCTracker::Start()
+{
+    PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FCrowdGCTracker::OnPreGarbageCollect);
+    PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FCrowdGCTracker::OnPostGarbageCollect);
+}
+
+void FCrowdGCTracker::Stop()
+{
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+    PreGCHandle.Reset();
+    PostGCHandle.Reset();
+}
+
+void FCrowdGCTracker::OnPreGarbageCollect()
+{
+    StartTime = FPlatformTime::Seconds();
+}
+
+void FCrowdGCTracker::OnPostGarbageCollect()
+{
+    if (StartTime <= 0.0) return;
+
+    const float Ms = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    StartTime = 0.0;
+
+    ++Stats.Count;
+    Stats.LastMs = Ms;
+    Stats.MaxMs = FMath::Max(Stats.MaxMs, Ms);
+    Stats.TotalMs += Ms;
+    SET_FLOAT_STAT(STAT_CrowdLastGCMs, Stats.LastMs);
+    SET_FLOAT_STAT(STAT_CrowdMaxGCMs, Stats.MaxMs);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "CrowdCleanup.generated.h"
+
+class ABaseGameEntity;
+class AUnitPool;
+
+// GC 耗时统计 (用来对比延迟销毁前后的卡顿)
+struct FCrowdGCStats
+{
+    int32 Count = 0;
+    float LastMs = 0.0f;
+    float MaxMs = 0.0f;
+    float TotalMs = 0.0f;
+};
+
+/**
+ * 延迟销毁队列
+ * 死亡的实体 (已隐藏、已注销) 先排队，每帧在时间预算内按先进先出处理：单位回对象池，建筑照常销毁
+ * 大混战里一帧死几十个时不会集中 Destroy 卡一下，之后的 GC 也更轻
+ */
+USTRUCT()
+struct FCrowdCleanupQueue
+{
+    GENERATED_BODY()
+
+public:
+    void Add(ABaseGameEntity* Entity);
+
+    // 在 BudgetMs 内处理排队的实体 (至少一个)，返回本次处理的个数
+    // 对象池第一次用到时才取 (PoolRef 由调用方持有)，取不到时单位也直接销毁
+    int32 Process(const UObject* WorldContextObject, AUnitPool*& PoolRef, float BudgetMs);
+
+    int32 Num() const { return Pending.Num(); }
+
+    // 关卡结束时还没来得及清理的随世界一起销毁
+    void Reset() { Pending.Reset(); }
+
+private:
+    UPROPERTY()
+        TArray<ABaseGameEntity*> Pending;
+};
+
+/**
+ * GC 耗时统计：挂在引擎的 GC 前后回调上 (Start/Stop 与群体管理器的 BeginPlay/EndPlay 对应)
+ */
+class FCrowdGCTracker
+{
+public:
+    void Start();
+    void Stop();
+
+    const FCrowdGCStats& GetStats() const { return Stats; }
+
+private:
+    void OnPreGarbageCollect();
+    void OnPostGarbageCollect();
+
+    FCrowdGCStats Stats;
+    double StartTime = 0.0;
+    FDelegateHandle PreGCHandle;
+    FDelegateHandle PostGCHandle;
+};
@@ -0,0 +1,118 @@
+#include "CrowdDamage.h"
+#include "CrowdManager.h"
+#include "BaseGameEntity.h"
+#include "BaseBuilding.h"
+#include "GridManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Queue Resolve"), STAT_CrowdDamageResolve, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits Queued"), STAT_CrowdDamageHits, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Targets Resolved"), STAT_CrowdDamageTargets, STATGROUP_RTSCrowd);
+
+void FCrowdDamageQueue::Add(const FEntityHandle& Target, float Damage, AActor* DamageCauser)
+{
+    int32& Index = EntryIndex.FindOrAdd(Target, INDEX_NONE);
+    if (Index == INDEX_NONE)
+    {
+        Index = Entries.AddDefaulted();
+        Entries[Index].Target = Target;
+    }
+
+    FCrowdDamageEntry& Entry = Entries[Index];
+    Entry.Damage += Damage;
+    ++Entry.NumHits;
+    Entry.Causer = DamageCauser;
+    INC_DWORD_STAT(STAT_CrowdDamageHits);
+}
+
+void FCrowdDamageQueue::Resolve(ACrowdManager& Crowd, AGridManager* GridManager, TSet<FEntityHandle>& OutDestroyedWalls)
+{
+    if (Entries.Num() == 0) return;
+
+    SCOPE_CYCLE_COUNTER(STAT_CrowdDamageResolve);
+
+    TArray<FIntPoint> DestroyedWallTiles;
+    TArray<FCrowdDamageEntry> Batch;
+
+    for (int32 Round = 0; Round < 4 && Entries.Num() > 0; ++Round)
+    {
+        Batch = MoveTemp(Entries);
+        Entries.Reset();
+        EntryIndex.Reset();
+
+        for (const FCrowdDamageEntry& Entry : Batch)
+        {
+            // 墙：直接扣 GridManager 里的血，拆掉的格子最后一起解除阻挡
+            const int32 WallIndex = Crowd.GetWallIndex(Entry.Target);
+            if (WallIndex != INDEX_NONE && IsValid(GridManager))
+            {
+                Crowd.ReleasePendingDamage(Entry.Target, Entry.Damage);
+
+                const FIntPoint WallTile = GridManager->GetWall(WallIndex)->Tile;
+                if (GridManager->DamageWall(WallIndex, Entry.Damage, false))
+                {
+                    DestroyedWallTiles.Add(WallTile);
+                    OutDestroyedWalls.Add(Entry.Target);
+                }
+                INC_DWORD_STAT(STAT_CrowdDamageTargets);
+                continue;
+            }
+
+            // 排队之后被别的途径移除的 (收回兵营等)
+            ABaseGameEntity* Entity = Crowd.ResolveHandle(Entry.Target);
+            if (!Entity) continue;
+
+            Entity->ReleasePendingDamage(Entry.Damage);
+
+            const ABaseBuilding* Building = Cast<ABaseBuilding>(Entity);
+            const bool bIsWall = Building && Building->BuildingType == EBuildingType::Wall;
+            const FIntPoint Tile = Building ? FIntPoint(Building->GridX, Building->GridY) : FIntPoint(INDEX_NONE, INDEX_NONE);
+
+            FDamageEvent DamageEvent;
+            Entity->TakeDamage(Entry.Damage, DamageEvent, nullptr, Entry.Causer.Get());
+            INC_DWORD_STAT(STAT_CrowdDamageTargets);
+
+            // 死亡时句柄立即失效
+            if (bIsWall && !Crowd.ResolveHandle(Entry.Target) && Tile.X >= 0 && Tile.Y >= 0)
+            {
+                DestroyedWallTiles.Add(Tile);
+            }
+        }
+    }
+
+    // 被摧毁的墙一次性解除阻挡 (共享路径只失效一次)
+    if (DestroyedWallTiles.Num() > 0 && IsValid(GridManager))
+    {
+        GridManager->SetTilesBlocked(DestroyedWallTiles, false);
+    }
+}
+
+void FCrowdDamageQueue::Reset()
+{
+    Entries.Reset();
+    EntryIndex.Reset();
+}
+
+void FCrowdDamageQueue::CollectRadialHits(const FCrowdFrame& Frame, const FRadialDamageParams& Params, FRadialDamageHitArray& OutHits)
+{
+    if (Params.Radius <= 0.0f || Params.BaseDamage <= 0.0f) return;
+
+    Frame.ForEachEntityInRadius(Params.Center, Params.Radius, [&](const FCrowdEntityState& State)
+    {
+        if (!(Params.TeamMask & FRadialDamageParams::TeamBit(State.TeamID)) || !State.IsAlive()) return;
+
+        ERadialDamageCategory Category = ERadialDamageCategory::Building;
+        if (State.bIsUnit) Category = ERadialDamageCategory::Unit;
+        else if (State.bIsDefense) Category = ERadialDamageCategory::Defense;
+        else if (State.BuildingType == EBuildingType::Wall) Category = ERadialDamageCategory::Wall;
+
+        const float Multiplier = Params.TypeMultipliers[(int32)Category];
+        if (Multiplier <= 0.0f) return;
+
+        const float Alpha = FMath::Clamp(FVector::Dist2D(State.Location, Params.Center) / Params.Radius, 0.0f, 1.0f);
+        const float Scale = 1.0f - FMath::Clamp(Params.Falloff, 0.0f, 1.0f) * Alpha;
+
+        FRadialDamageHit& Hit = OutHits.AddDefaulted_GetRef();
+        Hit.Handle = State.Handle;
+        Hit.Damage = Params.BaseDamage * Multiplier * Scale;
+    });
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "RTSCoreTypes.h"
+#include "EntityHandle.h"
+
+class ACrowdManager;
+class AGridManager;
+struct FCrowdFrame;
+
+// 范围伤害的目标类别 (伤害倍率按类别给)
+enum class ERadialDamageCategory : uint8
+{
+    Unit,
+    Building,   // 普通建筑
+    Defense,
+    Wall,
+    MAX
+};
+
+// 范围伤害参数 (炸弹人自爆、炮弹溅射、以后的法术共用)
+struct FRadialDamageParams
+{
+    FVector Center = FVector::ZeroVector;
+    float Radius = 0.0f;
+    float BaseDamage = 0.0f;
+
+    // 线性衰减：边缘处损失的伤害比例 (0 = 不衰减，1 = 边缘为 0)
+    float Falloff = 0.0f;
+
+    // 受伤害的阵营 (1 << ETeam)，见 EnemiesOf
+    uint8 TeamMask = 0;
+
+    // 各类别的伤害倍率，0 表示不伤害这一类
+    float TypeMultipliers[(int32)ERadialDamageCategory::MAX] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    static uint8 TeamBit(ETeam Team) { return (uint8)(1 << (uint8)Team); }
+    static uint8 EnemiesOf(ETeam Team) { return (uint8)(TeamBit(ETeam::Player) | TeamBit(ETeam::Enemy)) & ~TeamBit(Team); }
+
+    void SetMultiplier(ERadialDamageCategory Category, float Multiplier) { TypeMultipliers[(int32)Category] = Multiplier; }
+};
+
+// 范围伤害结果
+struct FRadialDamageResult
+{
+    int32 NumHits = 0;
+    float TotalDamage = 0.0f;
+};
+
+// 范围伤害查出的一个目标
+struct FRadialDamageHit
+{
+    FEntityHandle Handle;
+    float Damage = 0.0f;
+};
+
+typedef TArray<FRadialDamageHit, TInlineAllocator<32>> FRadialDamageHitArray;
+
+// 伤害队列的一条：同一目标本帧受到的伤害合并成一条
+struct FCrowdDamageEntry
+{
+    FEntityHandle Target;
+    float Damage = 0.0f;
+    int32 NumHits = 0;
+    TWeakObjectPtr<AActor> Causer;   // 最后一次命中的来源 (算击杀)
+};
+
+/**
+ * 伤害队列
+ * 伤害不当场结算：同一目标本帧受到的伤害按第一次命中的顺序合并成一条，本帧模拟结束后一次性结算
+ * 每个目标只调用一次 TakeDamage (受击特效只触发一次)，死亡的墙一次性解除阻挡
+ * 预测血量 (ReservePendingDamage) 由群体管理器在排队时计入，这里只管合并和结算
+ */
+class FCrowdDamageQueue
+{
+public:
+    void Add(const FEntityHandle& Target, float Damage, AActor* DamageCauser);
+
+    bool IsEmpty() const { return Entries.Num() == 0; }
+
+    // 结算：实体走 TakeDamage，墙直接扣 GridManager 里的血；被拆掉的墙的句柄写到 OutDestroyedWalls (由调用方通知锁定它的单位)
+    // 死亡事件 (蓝图 OnDeath) 里排入的新伤害接着结算，最多几轮
+    void Resolve(ACrowdManager& Crowd, AGridManager* GridManager, TSet<FEntityHandle>& OutDestroyedWalls);
+
+    void Reset();
+
+    // 范围伤害的查询：只读快照，按快照下标顺序给出范围内每个目标该受的伤害
+    static void CollectRadialHits(const FCrowdFrame& Frame, const FRadialDamageParams& Params, FRadialDamageHitArray& OutHits);
+
+private:
+    TArray<FCrowdDamageEntry> Entries;
+    TMap<FEntityHandle, int32> EntryIndex;
+};
@@ -0,0 +1,98 @@
+#include "CrowdDefenseWatch.h"
+#include "CrowdManager.h"
+#include "Building_Defense.h"
+
+void FCrowdDefenseWatch::Register(ABuilding_Defense* Tower, float CellSize)
+{
+    if (!Tower || CellSize <= 0.0f) return;
+
+    Unregister(Tower);
+
+    // 与射程圆相交的邻居格子
+    const FVector Center = Tower->GetActorLocation();
+    const float Range = Tower->AttackRange;
+    const int32 MinX = FMath::FloorToInt((Center.X - Range) / CellSize);
+    const int32 MaxX = FMath::FloorToInt((Center.X + Range) / CellSize);
+    const int32 MinY = FMath::FloorToInt((Center.Y - Range) / CellSize);
+    const int32 MaxY = FMath::FloorToInt((Center.Y + Range) / CellSize);
+
+    TArray<FIntPoint>& Cells = WatchedCells.Add(Tower);
+    for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+    {
+        for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+        {
+            // 格子上离圆心最近的点在射程外就不用看
+            const float ClosestX = FMath::Clamp(Center.X, CellX * CellSize, (CellX + 1) * CellSize);
+            const float ClosestY = FMath::Clamp(Center.Y, CellY * CellSize, (CellY + 1) * CellSize);
+            if (FVector2D(Center.X - ClosestX, Center.Y - ClosestY).SizeSquared() > Range * Range) continue;
+
+            const FIntPoint Cell(CellX, CellY);
+            Cells.Add(Cell);
+            WatchCells.FindOrAdd(Cell).Add(Tower);
+        }
+    }
+}
+
+void FCrowdDefenseWatch::Unregister(ABuilding_Defense* Tower)
+{
+    TArray<FIntPoint> Cells;
+    if (!WatchedCells.RemoveAndCopyValue(Tower, Cells)) return;
+
+    for (const FIntPoint& Cell : Cells)
+    {
+        TArray<ABuilding_Defense*>* Watchers = WatchCells.Find(Cell);
+        if (!Watchers) continue;
+
+        Watchers->Remove(Tower);
+        if (Watchers->Num() == 0) WatchCells.Remove(Cell);
+    }
+}
+
+int32 FCrowdDefenseWatch::WakeDefenses(const FCrowdFrame& Frame)
+{
+    int32 NumWoken = 0;
+    if (WatchCells.Num() == 0) return NumWoken;
+
+    for (const auto& Pair : Frame.NeighborCells)
+    {
+        const TArray<ABuilding_Defense*>* Watchers = WatchCells.Find(Pair.Key);
+        if (!Watchers) continue;
+
+        for (ABuilding_Defense* Tower : *Watchers)
+        {
+            if (Tower->IsAwake()) continue;
+
+            // 格子只是和射程圆相交：按快照位置确认真的进了射程才叫醒，条件与 FindNearestEnemyUnit 一致
+            // 否则格子角上的敌人会让塔每帧 叫醒 -> 找不到目标 -> 休眠
+            const FVector TowerLocation = Tower->GetActorLocation();
+            const float RangeSq = FMath::Square(Tower->AttackRange);
+            for (int32 Index : Pair.Value)
+            {
+                const FCrowdEntityState& State = Frame.Entities[Index];
+                if (!State.bIsUnit || State.TeamID == Tower->TeamID || !State.IsAlive() || State.IsDoomed()) continue;
+                if (FVector::DistSquared2D(State.Location, TowerLocation) > RangeSq) continue;
+
+                Tower->WakeUp();
+                ++NumWoken;
+                break;
+            }
+        }
+    }
+    return NumWoken;
+}
+
+void FCrowdDefenseWatch::Reset()
+{
+    WatchCells.Reset();
+    WatchedCells.Reset();
+}
+
+int32 FCrowdDefenseWatch::NumAwake() const
+{
+    int32 Count = 0;
+    for (const auto& Pair : WatchedCells)
+    {
+        if (Pair.Key->IsAwake()) ++Count;
+    }
+    return Count;
+}
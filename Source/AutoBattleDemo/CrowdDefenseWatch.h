@@ -0,0 +1,33 @@
+#pragma once
+#include "CoreMinimal.h"
+
+class ABuilding_Defense;
+struct FCrowdFrame;
+
+/**
+ * 防御塔唤醒
+ * 防御塔平时休眠、不 Tick；这里登记射程圆覆盖的邻居格子，每帧只看快照里有单位的格子，
+ * 射程里真的来了敌人才唤醒 (开销只和有单位的格子数有关，与防御塔的数量无关)
+ * 不持有 UObject 引用：防御塔注销 (死亡/EndPlay) 时一定会 Unregister
+ */
+class FCrowdDefenseWatch
+{
+public:
+    // 射程变了 (升级) 就整个重新登记；CellSize 与快照的邻居格子一致
+    void Register(ABuilding_Defense* Tower, float CellSize);
+    void Unregister(ABuilding_Defense* Tower);
+
+    // 唤醒阶段，返回本帧唤醒的防御塔数
+    int32 WakeDefenses(const FCrowdFrame& Frame);
+
+    void Reset();
+
+    // 统计显示用
+    int32 NumWatched() const { return WatchedCells.Num(); }
+    int32 NumAwake() const;
+
+private:
+    // 邻居格子 -> 射程覆盖它的防御塔 / 防御塔 -> 它登记的格子
+    TMap<FIntPoint, TArray<ABuilding_Defense*>> WatchCells;
+    TMap<ABuilding_Defense*, TArray<FIntPoint>> WatchedCells;
+};
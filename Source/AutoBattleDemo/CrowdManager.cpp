@@ -0,0 +1,1202 @@
+#include "CrowdManager.h"
+#include "WorldSingleton.h"
+#include "BaseGameEntity.h"
+#include "BaseBuilding.h"
+#include "Building_Defense.h"
+#include "GridManager.h"
+#include "TargetingPolicy.h"
+#include "RTSGameMode.h"
+#include "UnitPool.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+// --- 分时 AI 的控制台变量 ---
+static TAutoConsoleVariable<int32> CVarCrowdDecisionBudget(
+    TEXT("rts.Crowd.DecisionBudget"),
+    0,
+    TEXT("Max number of full unit AI decisions per frame (0 = unlimited). Overflow is deferred to the next frame, most overdue first."));
+
+static TAutoConsoleVariable<float> CVarCrowdLODNearDistance(
+    TEXT("rts.Crowd.LODNearDistance"),
+    2000.0f,
+    TEXT("Horizontal distance to the view target below which a unit counts as near the camera."));
+
+static TAutoConsoleVariable<int32> CVarCrowdFarMoveInterval(
+    TEXT("rts.Crowd.FarMoveInterval"),
+    4,
+    TEXT("Decision interval in frames for moving units far from the camera."));
+
+// --- 自适应降级 ---
+static TAutoConsoleVariable<float> CVarCrowdFrameBudgetMs(
+    TEXT("rts.Crowd.FrameBudgetMs"),
+    4.0f,
+    TEXT("Target cost in ms of the crowd AI/pathing/combat update. Above it the governor throttles the simulation (<= 0 disables)."));
+
+static TAutoConsoleVariable<float> CVarCrowdCongestionHalfLife(
+    TEXT("rts.Crowd.CongestionHalfLife"),
+    1.0f,
+    TEXT("Half-life in seconds of the per-tile congestion layer fed to path costs (0 = no smoothing)."));
+
+static TAutoConsoleVariable<float> CVarCrowdCleanupBudgetMs(
+    TEXT("rts.Crowd.CleanupBudgetMs"),
+    0.5f,
+    TEXT("Time budget in ms per frame for destroying dead entities. At least one is destroyed per frame, the rest wait."));
+
+static TAutoConsoleVariable<int32> CVarCrowdShowGovernor(
+    TEXT("rts.Crowd.ShowGovernor"),
+    0,
+    TEXT("Show the crowd governor throttle level and frame cost on screen."));
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Tick"), STAT_CrowdTick, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttle Level"), STAT_CrowdThrottleLevel, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Decisions"), STAT_CrowdDecisions, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Suspended Units"), STAT_CrowdSuspended, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Path Requests"), STAT_CrowdDeferredPaths, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Requests"), STAT_CrowdPathRequests, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Searches"), STAT_CrowdPathSearches, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Searches Saved"), STAT_CrowdPathSearchesSaved, STATGROUP_RTSCrowd);
+DECLARE_CYCLE_STAT(TEXT("Targeting Pass"), STAT_CrowdTargeting, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Spawned"), STAT_CrowdProjectilesSpawned, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles Wasted"), STAT_CrowdProjectilesWasted, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Doomed Targets Skipped"), STAT_CrowdDoomedSkipped, STATGROUP_RTSCrowd);
+DECLARE_CYCLE_STAT(TEXT("Radial Damage"), STAT_CrowdRadialDamage, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Defenses Woken"), STAT_CrowdDefensesWoken, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Grid Walls"), STAT_CrowdGridWalls, STATGROUP_RTSCrowd);
+DECLARE_CYCLE_STAT(TEXT("Timers"), STAT_CrowdTimers, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timers Pending"), STAT_CrowdTimersPending, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timers Fired"), STAT_CrowdTimersFired, STATGROUP_RTSCrowd);
+
+// 降级档位表：下标即档位
+static const FCrowdThrottleLevel GCrowdThrottleLevels[] =
+{
+    //  寻路上限  间隔倍数  邻居上限  子弹降级
+    {   0,        1,        0,        false },
+    {   16,       1,        12,       false },
+    {   8,        2,        8,        true  },
+    {   4,        3,        4,        true  },
+};
+
+bool FCrowdFrame::CanUseTargetFields(ETeam Attacker, const FVector& Location) const
+{
+    const int32 Index = GetTargetFieldIndex(Attacker, ETargetFieldType::AnyBuilding);
+    if (!TargetFields.IsValidIndex(Index) || !TargetFields[Index]) return false;
+
+    int32 X, Y;
+    return WorldToTile(Location, X, Y) && !IsTileBlocked(X, Y);
+}
+
+const FCrowdEntityState* FCrowdFrame::FindFieldTarget(ETeam Attacker, ETargetFieldType Type, const FVector& Location, float* OutPathDistance) const
+{
+    const int32 Index = GetTargetFieldIndex(Attacker, Type);
+    if (!TargetFields.IsValidIndex(Index) || !TargetFields[Index]) return nullptr;
+
+    int32 X, Y;
+    if (!WorldToTile(Location, X, Y)) return nullptr;
+
+    const FCrowdEntityState* Target = Find(TargetFields[Index]->GetTarget(X, Y));
+    if (Target && OutPathDistance)
+    {
+        *OutPathDistance = TargetFields[Index]->GetDistance(X, Y) * TileSize;
+    }
+    return Target;
+}
+
+bool FCrowdFrame::GetFieldStep(ETeam Attacker, const FEntityHandle& Target, const FVector& Location, FVector& OutNextLocation) const
+{
+    int32 X, Y;
+    if (!Target.IsSet() || !WorldToTile(Location, X, Y)) return false;
+
+    // 目标可能是从任意一个类别的场里选出来的
+    for (int32 Type = 0; Type < (int32)ETargetFieldType::MAX; ++Type)
+    {
+        const int32 Index = GetTargetFieldIndex(Attacker, (ETargetFieldType)Type);
+        const FTargetDistanceField* Field = TargetFields.IsValidIndex(Index) ? TargetFields[Index] : nullptr;
+        if (!Field || Field->GetTarget(X, Y) != Target) continue;
+
+        FIntPoint Next;
+        if (Field->GetNextStep(X, Y, Next))
+        {
+            OutNextLocation = FVector(GridOrigin + (FVector2D(Next.X, Next.Y) + 0.5f) * TileSize, Location.Z);
+        }
+        else
+        {
+            // 已经在目标外围
+            const FCrowdEntityState* TargetState = Find(Target);
+            if (!TargetState) return false;
+            OutNextLocation = TargetState->Location;
+        }
+        return true;
+    }
+    return false;
+}
+
+ACrowdManager::ACrowdManager()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    USceneComponent* SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+    RootComponent = SceneRoot;
+
+    bParallelDecision = true;
+    NeighborCellSize = 150.0f;
+    GridManagerRef = nullptr;
+    UnitPoolRef = nullptr;
+
+    MaxSquadSize = 8;
+    SquadRadius = 400.0f;
+
+    NextBucket = 0;
+    FrameCounter = 0;
+    bFrameStale = true;
+
+    ThrottleLevel = 0;
+    SmoothedCostMs = 0.0;
+    FramesSinceLevelChange = 0;
+    HeadroomFrames = 0;
+    DeferredPathRequests = 0;
+    SuspendedAgents = 0;
+    PathRequestsThisFrame = 0;
+    PathSearchesThisFrame = 0;
+    CleanedThisFrame = 0;
+    DefensesWokenThisFrame = 0;
+    bTimersStarted = false;
+}
+
+void ACrowdManager::BeginPlay()
+{
+    Super::BeginPlay();
+
+    GCTracker.Start();
+}
+
+void ACrowdManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GCTracker.Stop();
+
+    const FCrowdGCStats& GCStats = GCTracker.GetStats();
+    if (GCStats.Count > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("[Crowd] GC: %d runs | last %.2f ms | max %.2f ms | avg %.2f ms"),
+            GCStats.Count, GCStats.LastMs, GCStats.MaxMs, GCStats.TotalMs / GCStats.Count);
+    }
+
+    // 关卡结束时还没来得及清理的随世界一起销毁
+    Cleanup.Reset();
+    DefenseWatch.Reset();
+    EntityActionTimers.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ACrowdManager::QueueCleanup(ABaseGameEntity* Entity)
+{
+    Cleanup.Add(Entity);
+}
+
+void ACrowdManager::CleanupPhase()
+{
+    CleanedThisFrame = Cleanup.Process(this, UnitPoolRef, CVarCrowdCleanupBudgetMs.GetValueOnGameThread());
+}
+
+ACrowdManager* ACrowdManager::Get(const UObject* WorldContextObject)
+{
+    return TWorldSingleton<ACrowdManager>::Get(WorldContextObject);
+}
+
+FEntityHandle ACrowdManager::RegisterEntity(ABaseGameEntity* Entity)
+{
+    if (!Entity) return FEntityHandle();
+
+    // 已经注册过 (句柄还有效) 就沿用
+    if (ResolveHandle(Entity->GetEntityHandle()) == Entity) return Entity->GetEntityHandle();
+
+    if (!Entities.Contains(Entity))
+    {
+        Entities.Add(Entity);
+        CachedStates.AddDefaulted();
+    }
+    bFrameStale = true;
+
+    ABaseUnit* Unit = Cast<ABaseUnit>(Entity);
+    if (Unit && FindAgentIndex(Unit) == INDEX_NONE)
+    {
+        Unit->SetAgentIndex(Units.Add(Unit));
+
+        FCrowdAgentSlot& Slot = AgentSlots.AddDefaulted_GetRef();
+        Slot.Bucket = NextBucket++;
+    }
+
+    // 发放句柄：优先复用空闲槽位 (代数在释放时已经加过)
+    const int32 SlotIndex = (FreeHandleSlots.Num() > 0) ? FreeHandleSlots.Pop(false) : HandleSlots.AddDefaulted();
+    HandleSlots[SlotIndex].Entity = Entity;
+    return FEntityHandle(SlotIndex, HandleSlots[SlotIndex].Generation);
+}
+
+void ACrowdManager::ReleaseHandle(const FEntityHandle& Handle)
+{
+    if (!IsHandleAlive(Handle)) return;
+
+    FEntityHandleSlot& Slot = HandleSlots[Handle.Index];
+    AttackSlots.Remove(Handle);
+    Slot.Entity = nullptr;
+    Slot.WallIndex = INDEX_NONE;
+    ++Slot.Generation;
+    FreeHandleSlots.Add(Handle.Index);
+    bFrameStale = true;
+}
+
+FEntityHandle ACrowdManager::RegisterWall(AGridManager* GridManager, int32 WallIndex)
+{
+    if (!GridManager || WallIndex == INDEX_NONE) return FEntityHandle();
+    if (!GridManagerRef) GridManagerRef = GridManager;
+
+    const int32 SlotIndex = (FreeHandleSlots.Num() > 0) ? FreeHandleSlots.Pop(false) : HandleSlots.AddDefaulted();
+    HandleSlots[SlotIndex].WallIndex = WallIndex;
+    bFrameStale = true;
+    return FEntityHandle(SlotIndex, HandleSlots[SlotIndex].Generation);
+}
+
+FGridWall* ACrowdManager::FindWall(const FEntityHandle& Handle) const
+{
+    const int32 WallIndex = GetWallIndex(Handle);
+    return (WallIndex != INDEX_NONE && IsValid(GridManagerRef)) ? GridManagerRef->GetWall(WallIndex) : nullptr;
+}
+
+bool ACrowdManager::GetTargetLocation(const FEntityHandle& Handle, FVector& OutLocation, ETeam* OutTeam) const
+{
+    if (const ABaseGameEntity* Entity = ResolveHandle(Handle))
+    {
+        OutLocation = Entity->GetActorLocation();
+        if (OutTeam) *OutTeam = Entity->TeamID;
+        return true;
+    }
+    if (const FGridWall* Wall = FindWall(Handle))
+    {
+        OutLocation = Wall->Location;
+        if (OutTeam) *OutTeam = Wall->Team;
+        return true;
+    }
+    return false;
+}
+
+void ACrowdManager::ReservePendingDamage(const FEntityHandle& Handle, float Amount)
+{
+    if (ABaseGameEntity* Entity = ResolveHandle(Handle))
+    {
+        Entity->ReservePendingDamage(Amount);
+    }
+    else if (FGridWall* Wall = FindWall(Handle))
+    {
+        Wall->PendingDamage += Amount;
+    }
+}
+
+void ACrowdManager::ReleasePendingDamage(const FEntityHandle& Handle, float Amount)
+{
+    if (ABaseGameEntity* Entity = ResolveHandle(Handle))
+    {
+        Entity->ReleasePendingDamage(Amount);
+    }
+    else if (FGridWall* Wall = FindWall(Handle))
+    {
+        Wall->PendingDamage = FMath::Max(0.0f, Wall->PendingDamage - Amount);
+    }
+}
+
+bool ACrowdManager::IsTargetDoomed(const FEntityHandle& Handle) const
+{
+    if (const ABaseGameEntity* Entity = ResolveHandle(Handle)) return Entity->IsDoomed();
+    if (const FGridWall* Wall = FindWall(Handle)) return Wall->GetPredictedHealth() <= 0.0f;
+    return false;
+}
+
+int32 ACrowdManager::ReserveAttackSlot(ABaseUnit* Unit, const FEntityHandle& Building, FVector& OutLocation)
+{
+    // 建筑或墙占的格子
+    FIntPoint TargetTile(INDEX_NONE, INDEX_NONE);
+    if (const ABaseBuilding* Target = Cast<ABaseBuilding>(ResolveHandle(Building)))
+    {
+        TargetTile = FIntPoint(Target->GridX, Target->GridY);
+    }
+    else if (const FGridWall* Wall = FindWall(Building))
+    {
+        TargetTile = Wall->Tile;
+    }
+    if (!IsValid(GridManagerRef)) return INDEX_NONE;
+
+    return AttackSlots.Reserve(*this, *GridManagerRef, Unit, Building, TargetTile, OutLocation);
+}
+
+void ACrowdManager::ReleaseAttackSlot(ABaseUnit* Unit, const FEntityHandle& Building, int32 SlotIndex)
+{
+    AttackSlots.Release(Unit, Building, SlotIndex);
+}
+
+void ACrowdManager::NoteProjectileSpawned()
+{
+    ++ProjectileStats.Spawned;
+    INC_DWORD_STAT(STAT_CrowdProjectilesSpawned);
+}
+
+void ACrowdManager::NoteProjectileWasted()
+{
+    ++ProjectileStats.Wasted;
+    INC_DWORD_STAT(STAT_CrowdProjectilesWasted);
+}
+
+void ACrowdManager::NoteDoomedTargetSkipped()
+{
+    ++ProjectileStats.DoomedSkipped;
+    INC_DWORD_STAT(STAT_CrowdDoomedSkipped);
+}
+
+void ACrowdManager::QueueDamage(ABaseGameEntity* Target, float Damage, AActor* DamageCauser)
+{
+    if (Target) QueueDamage(Target->GetEntityHandle(), Damage, DamageCauser);
+}
+
+void ACrowdManager::QueueDamage(const FEntityHandle& Handle, float Damage, AActor* DamageCauser)
+{
+    if (Damage <= 0.0f || !IsHandleAlive(Handle)) return;
+
+    DamageQueue.Add(Handle, Damage, DamageCauser);
+
+    // 结算前计入预测血量，和飞行中的子弹一样
+    ReservePendingDamage(Handle, Damage);
+}
+
+void ACrowdManager::ResolveDamageQueue()
+{
+    if (DamageQueue.IsEmpty()) return;
+
+    ARTSGameMode* GameMode = Cast<ARTSGameMode>(UGameplayStatics::GetGameMode(this));
+    if (GameMode) GameMode->BeginKillBatch();
+
+    TSet<FEntityHandle> DestroyedWalls;
+    DamageQueue.Resolve(*this, GridManagerRef, DestroyedWalls);
+
+    // 墙没有攻击者列表：锁定被拆的墙的单位在这里一起通知
+    if (DestroyedWalls.Num() > 0)
+    {
+        for (ABaseUnit* Unit : Units)
+        {
+            if (IsValid(Unit) && DestroyedWalls.Contains(Unit->GetCurrentTargetHandle()))
+            {
+                Unit->OnTargetHandleLost(Unit->GetCurrentTargetHandle());
+            }
+        }
+    }
+
+    if (GameMode) GameMode->EndKillBatch();
+}
+
+int32 ACrowdManager::ApplyRadialDamage(const FRadialDamageParams& Params, AActor* DamageCauser, FRadialDamageResult* OutResult)
+{
+    SCOPE_CYCLE_COUNTER(STAT_CrowdRadialDamage);
+
+    FRadialDamageResult LocalResult;
+    FRadialDamageResult& Result = OutResult ? *OutResult : LocalResult;
+    if (Params.Radius <= 0.0f || Params.BaseDamage <= 0.0f) return 0;
+
+    // 1. 查询：只读快照，收集范围内每个目标该受的伤害
+    FRadialDamageHitArray Hits;
+    FCrowdDamageQueue::CollectRadialHits(Frame, Params, Hits);
+
+    // 2. 按快照顺序排进伤害队列 (快照之后已经死掉的按句柄解析不到，跳过)
+    for (const FRadialDamageHit& Hit : Hits)
+    {
+        if (Hit.Damage <= 0.0f || !IsHandleAlive(Hit.Handle)) continue;
+
+        QueueDamage(Hit.Handle, Hit.Damage, DamageCauser);
+        ++Result.NumHits;
+        Result.TotalDamage += Hit.Damage;
+    }
+
+    return Result.NumHits;
+}
+
+void ACrowdManager::StartTimers()
+{
+    if (bTimersStarted) return;
+    Timers.Start(GetWorld()->GetTimeSeconds());
+    bTimersStarted = true;
+}
+
+void ACrowdManager::ScheduleEntityAction(ABaseGameEntity* Entity, float FireTime)
+{
+    // 没注册或已经死亡的不安排
+    if (!Entity || ResolveHandle(Entity->GetEntityHandle()) != Entity) return;
+
+    StartTimers();
+
+    FTimerWheelHandle& Timer = EntityActionTimers.FindOrAdd(Entity->GetEntityHandle());
+    Timers.Cancel(Timer);
+
+    FCrowdTimerPayload Payload;
+    Payload.Entity = Entity->GetEntityHandle();
+    Payload.Type = ECrowdTimerType::EntityAction;
+    Timer = Timers.Schedule(FireTime, Payload);
+}
+
+void ACrowdManager::CancelEntityAction(ABaseGameEntity* Entity)
+{
+    FTimerWheelHandle Timer;
+    if (Entity && EntityActionTimers.RemoveAndCopyValue(Entity->GetEntityHandle(), Timer))
+    {
+        Timers.Cancel(Timer);
+    }
+}
+
+bool ACrowdManager::IsEntityActionScheduled(const ABaseGameEntity* Entity) const
+{
+    const FTimerWheelHandle* Timer = Entity ? EntityActionTimers.Find(Entity->GetEntityHandle()) : nullptr;
+    return Timer && Timers.IsPending(*Timer);
+}
+
+void ACrowdManager::FireTimers()
+{
+    SCOPE_CYCLE_COUNTER(STAT_CrowdTimers);
+
+    StartTimers();
+
+    // 先取出本帧到点的全部任务再回调 (回调里会安排下一次)
+    FiredTimers.Reset();
+    Timers.Advance(Frame.TimeSeconds, FiredTimers);
+
+    for (const auto& Fired : FiredTimers)
+    {
+        // 实体已经死亡/注销：句柄解析为空，直接丢弃
+        ABaseGameEntity* Entity = ResolveHandle(Fired.Payload.Entity);
+        if (!Entity) continue;
+
+        if (Fired.Payload.Type == ECrowdTimerType::UnitWake)
+        {
+            // 冷却好了：标记为拖欠，本帧优先决策 (不等轮转分桶)
+            const int32 UnitIndex = FindAgentIndex(Cast<ABaseUnit>(Entity));
+            if (UnitIndex != INDEX_NONE) AgentSlots[UnitIndex].LastDecisionFrame = 0;
+        }
+        else
+        {
+            EntityActionTimers.Remove(Fired.Payload.Entity);
+            Entity->OnScheduledAction();
+        }
+    }
+
+    SET_DWORD_STAT(STAT_CrowdTimersFired, FiredTimers.Num());
+    SET_DWORD_STAT(STAT_CrowdTimersPending, Timers.Num());
+}
+
+void ACrowdManager::RegisterDefenseWatch(ABuilding_Defense* Tower)
+{
+    // 用管理器自己的格子尺寸，防御塔可能比第一次采集更早登记
+    DefenseWatch.Register(Tower, NeighborCellSize);
+}
+
+void ACrowdManager::UnregisterDefenseWatch(ABuilding_Defense* Tower)
+{
+    DefenseWatch.Unregister(Tower);
+}
+
+ABaseGameEntity* ACrowdManager::FindNearestEnemyUnit(const FVector& Location, float Range, ETeam Team) const
+{
+    ABaseGameEntity* Best = nullptr;
+    float BestDistSq = FLT_MAX;
+    Frame.ForEachEntityInRadius(Location, Range, [&](const FCrowdEntityState& State)
+    {
+        if (!State.bIsUnit || State.TeamID == Team || !State.IsAlive()) return;
+
+        const float DistSq = FVector::DistSquared2D(State.Location, Location);
+        if (DistSq >= BestDistSq) return;
+
+        // 快照之后可能已经死了，或者同一帧别的防御塔的子弹已经够打死它了
+        ABaseGameEntity* Entity = ResolveHandle(State.Handle);
+        if (!Entity || Entity->IsDoomed()) return;
+
+        Best = Entity;
+        BestDistSq = DistSq;
+    });
+    return Best;
+}
+
+void ACrowdManager::UnregisterEntity(ABaseGameEntity* Entity)
+{
+    // 死亡时已经释放过的话这里什么都不做
+    if (Entity) ReleaseHandle(Entity->GetEntityHandle());
+
+    // 还没到点的回调作废
+    CancelEntityAction(Entity);
+
+    // 防御塔不再需要唤醒
+    if (ABuilding_Defense* Tower = Cast<ABuilding_Defense>(Entity)) UnregisterDefenseWatch(Tower);
+
+    // 用 RemoveAt 而不是 RemoveAtSwap，保证提交顺序稳定
+    const int32 EntityIndex = Entities.Find(Entity);
+    if (EntityIndex != INDEX_NONE)
+    {
+        Entities.RemoveAt(EntityIndex);
+        CachedStates.RemoveAt(EntityIndex);
+    }
+    bFrameStale = true;
+
+    // 单位只置空，等下一帧采集前统一压缩，避免提交阶段下标错位
+    ABaseUnit* Unit = Cast<ABaseUnit>(Entity);
+    const int32 UnitIndex = FindAgentIndex(Unit);
+    if (UnitIndex != INDEX_NONE)
+    {
+        Units[UnitIndex] = nullptr;
+        Unit->SetAgentIndex(INDEX_NONE);
+        RemoveFromSquad(Unit);
+    }
+}
+
+void ACrowdManager::CreateSquads(const TArray<ABaseUnit*>& NewUnits)
+{
+    Squads.Create(NewUnits, MaxSquadSize, SquadRadius);
+}
+
+void ACrowdManager::RemoveFromSquad(ABaseUnit* Unit)
+{
+    Squads.Remove(Unit, SquadRadius);
+}
+
+void ACrowdManager::QueuePathRequest(ABaseUnit* Unit)
+{
+    FCrowdPathRequest& Request = PendingPathRequests.AddDefaulted_GetRef();
+    Request.Unit = Unit;
+    Request.Target = Unit->GetCurrentTargetHandle();
+}
+
+void ACrowdManager::FlushPathRequests()
+{
+    if (PendingPathRequests.Num() == 0) return;
+
+    if (!IsValid(GridManagerRef))
+    {
+        PendingPathRequests.Reset();
+        return;
+    }
+
+    const int32 SearchesBefore = GridManagerRef->GetSearchCount();
+
+    // 按目标格子分组 (组内保持提交顺序)
+    TMap<int32, TArray<int32>> RequestsByGoal;
+    for (int32 i = 0; i < PendingPathRequests.Num(); ++i)
+    {
+        const FCrowdPathRequest& Request = PendingPathRequests[i];
+
+        // 排队之后单位死了，或者目标死了/换了，这个请求就作废
+        FVector TargetLocation;
+        if (!IsValid(Request.Unit) || Request.Unit->GetCurrentTargetHandle() != Request.Target || !GetTargetLocation(Request.Target, TargetLocation)) continue;
+
+        int32 GoalX, GoalY;
+        if (!GridManagerRef->WorldToGrid(TargetLocation, GoalX, GoalY)) continue;
+
+        RequestsByGoal.FindOrAdd(GoalY * GridManagerRef->GetGridWidth() + GoalX).Add(i);
+        ++PathRequestsThisFrame;
+    }
+
+    TArray<FVector> Starts;
+    TArray<FGridPathRef> Paths;
+    for (const auto& Pair : RequestsByGoal)
+    {
+        const TArray<int32>& Group = Pair.Value;
+
+        Starts.Reset();
+        for (int32 RequestIndex : Group)
+        {
+            Starts.Add(PendingPathRequests[RequestIndex].Unit->GetActorLocation());
+        }
+
+        FVector Goal;
+        GetTargetLocation(PendingPathRequests[Group[0]].Target, Goal);
+        GridManagerRef->FindSharedPathsToGoal(Goal, Starts, Paths);
+
+        for (int32 k = 0; k < Group.Num(); ++k)
+        {
+            PendingPathRequests[Group[k]].Unit->ApplyPath(Paths[k]);
+        }
+    }
+
+    PathSearchesThisFrame = GridManagerRef->GetSearchCount() - SearchesBefore;
+    PendingPathRequests.Reset();
+}
+
+void ACrowdManager::RequestRetarget(ABaseUnit* Unit)
+{
+    const int32 UnitIndex = FindAgentIndex(Unit);
+    if (UnitIndex == INDEX_NONE) return;
+
+    // 保留速度，没轮到决策前继续按原速度移动
+    FCrowdAgentSlot& Slot = AgentSlots[UnitIndex];
+    Slot.Intent.NewTarget.Reset();
+    Slot.Intent.NewState = EUnitState::Idle;
+    Slot.Intent.bRequestPath = false;
+    Slot.Intent.bClearPath = false;
+    Slot.Intent.bAttack = false;
+    Slot.Intent.Wait = FUnitWait();
+
+    // 标记为拖欠：如果本帧还没提交，提交阶段只按原速度移动
+    Slot.LastDecisionFrame = 0;
+}
+
+int32 ACrowdManager::FindAgentIndex(const ABaseUnit* Unit) const
+{
+    const int32 Index = Unit ? Unit->GetAgentIndex() : INDEX_NONE;
+    return (Units.IsValidIndex(Index) && Units[Index] == Unit) ? Index : INDEX_NONE;
+}
+
+void ACrowdManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    SCOPE_CYCLE_COUNTER(STAT_CrowdTick);
+
+    ++FrameCounter;
+    const double StartTime = FPlatformTime::Seconds();
+
+    GatherFrame(DeltaTime);
+    // 唤醒阶段：射程里来了敌方单位的休眠防御塔
+    DefensesWokenThisFrame = DefenseWatch.WakeDefenses(Frame);
+    SET_DWORD_STAT(STAT_CrowdDefensesWoken, DefensesWokenThisFrame);
+    FireTimers();
+    if (ActiveAgents.Num() > 0)
+    {
+        ScheduleDecisions();
+        DecidePhase();
+        CommitPhase(DeltaTime);
+    }
+
+    // 本帧所有伤害 (包括子弹管理器先于本管理器 Tick 时结算的命中) 统一结算
+    ResolveDamageQueue();
+
+    UpdateGovernor((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    // 本帧死亡的实体已经隐藏、注销，这里按预算销毁之前排队的 (有自己的预算，不计入降级的帧开销)
+    CleanupPhase();
+}
+
+const FCrowdThrottleLevel& ACrowdManager::GetThrottle() const
+{
+    return GCrowdThrottleLevels[ThrottleLevel];
+}
+
+bool ACrowdManager::ShouldReduceProjectileFidelity() const
+{
+    return GetThrottle().bReducedProjectiles;
+}
+
+void ACrowdManager::UpdateGovernor(double FrameCostMs)
+{
+    const int32 MaxLevel = ARRAY_COUNT(GCrowdThrottleLevels) - 1;
+    const float BudgetMs = CVarCrowdFrameBudgetMs.GetValueOnGameThread();
+
+    // 平滑一下，单帧尖峰不至于直接换档
+    SmoothedCostMs = FMath::Lerp(SmoothedCostMs, FrameCostMs, 0.2);
+    ++FramesSinceLevelChange;
+
+    int32 NewLevel = ThrottleLevel;
+    if (BudgetMs <= 0.0f)
+    {
+        NewLevel = 0;
+    }
+    else if (SmoothedCostMs > BudgetMs)
+    {
+        // 超预算：很快收紧 (每 10 帧最多升一档)
+        HeadroomFrames = 0;
+        if (FramesSinceLevelChange >= 10) NewLevel = FMath::Min(ThrottleLevel + 1, MaxLevel);
+    }
+    else if (SmoothedCostMs < BudgetMs * 0.6f)
+    {
+        // 余量充足且持续一段时间才放开，避免来回抖动
+        if (++HeadroomFrames >= 60) NewLevel = FMath::Max(ThrottleLevel - 1, 0);
+    }
+    else
+    {
+        HeadroomFrames = 0;
+    }
+
+    if (NewLevel != ThrottleLevel)
+    {
+        UE_LOG(LogTemp, Log, TEXT("[Crowd] Throttle level %d -> %d (cost %.2f ms, budget %.2f ms)"), ThrottleLevel, NewLevel, SmoothedCostMs, BudgetMs);
+        ThrottleLevel = NewLevel;
+        FramesSinceLevelChange = 0;
+        HeadroomFrames = 0;
+    }
+
+    SET_DWORD_STAT(STAT_CrowdThrottleLevel, ThrottleLevel);
+    SET_DWORD_STAT(STAT_CrowdDecisions, DecisionAgents.Num());
+    SET_DWORD_STAT(STAT_CrowdSuspended, SuspendedAgents);
+    SET_DWORD_STAT(STAT_CrowdDeferredPaths, DeferredPathRequests);
+    SET_DWORD_STAT(STAT_CrowdPathRequests, PathRequestsThisFrame);
+    SET_DWORD_STAT(STAT_CrowdPathSearches, PathSearchesThisFrame);
+    SET_DWORD_STAT(STAT_CrowdPathSearchesSaved, PathRequestsThisFrame - PathSearchesThisFrame);
+
+    if (GEngine && CVarCrowdShowGovernor.GetValueOnGameThread() != 0)
+    {
+        const FCrowdGCStats& GCStats = GCTracker.GetStats();
+        const FString Msg = FString::Printf(TEXT("Crowd Governor: Level %d | %.2f / %.2f ms | Units %d | Decisions %d | Suspended %d | Deferred Paths %d | Paths %d (searches %d, saved %d) | Projectiles %d (wasted %d, doomed skipped %d) | Timers %d (fired %d) | Defenses awake %d/%d (woken %d) | Cleanup %d (pending %d) | GC last %.1f ms, max %.1f ms (%d runs)"),
+            ThrottleLevel, SmoothedCostMs, BudgetMs, ActiveAgents.Num(), DecisionAgents.Num(), SuspendedAgents, DeferredPathRequests,
+            PathRequestsThisFrame, PathSearchesThisFrame, PathRequestsThisFrame - PathSearchesThisFrame,
+            ProjectileStats.Spawned, ProjectileStats.Wasted, ProjectileStats.DoomedSkipped,
+            Timers.Num(), FiredTimers.Num(), DefenseWatch.NumAwake(), DefenseWatch.NumWatched(), DefensesWokenThisFrame,
+            CleanedThisFrame, Cleanup.Num(), GCStats.LastMs, GCStats.MaxMs, GCStats.Count);
+        GEngine->AddOnScreenDebugMessage((uint64)GetUniqueID(), 0.0f, ThrottleLevel > 0 ? FColor::Orange : FColor::Green, Msg);
+    }
+}
+
+// 1. 采集：游戏线程拷贝实体状态
+void ACrowdManager::GatherFrame(float DeltaTime)
+{
+    // 压缩已注销的单位 (调度槽同步移动，保持一一对应；顺序不变，单位身上的下标跟着改)
+    int32 WriteIndex = 0;
+    for (int32 Index = 0; Index < Units.Num(); ++Index)
+    {
+        if (!IsValid(Units[Index]))
+        {
+            Timers.Cancel(AgentSlots[Index].WakeTimer);
+            continue;
+        }
+
+        if (WriteIndex != Index)
+        {
+            Units[WriteIndex] = Units[Index];
+            AgentSlots[WriteIndex] = MoveTemp(AgentSlots[Index]);
+            Units[WriteIndex]->SetAgentIndex(WriteIndex);
+        }
+        ++WriteIndex;
+    }
+    Units.SetNum(WriteIndex, false);
+    AgentSlots.SetNum(WriteIndex, false);
+
+    Frame.TimeSeconds = GetWorld()->GetTimeSeconds();
+    Frame.DeltaTime = DeltaTime;
+
+    // 场上没有单位：没有人决策、寻路，防御塔也没有目标，上次采集的快照 (只剩建筑和墙) 一直有效
+    if (Units.Num() == 0 && !bFrameStale) return;
+    // 有单位时每帧都要重新采集；单位全部离场后还要再采集一次，把它们从快照里去掉
+    bFrameStale = (Units.Num() > 0);
+
+    Frame.NeighborCellSize = NeighborCellSize;
+    Frame.MaxNeighbors = GetThrottle().MaxNeighbors;
+    Frame.Entities.Reset();
+    Frame.EntityIndexMap.Reset();
+    Frame.HandleToEntity.Init(INDEX_NONE, HandleSlots.Num());
+    Frame.NeighborCells.Reset();
+    Frame.BuildingCells.Reset();
+
+    if (!GridManagerRef)
+    {
+        for (TActorIterator<AGridManager> It(GetWorld()); It; ++It)
+        {
+            GridManagerRef = *It;
+            break;
+        }
+    }
+
+    for (int32 EntityIndex = 0; EntityIndex < Entities.Num(); ++EntityIndex)
+    {
+        ABaseGameEntity* Entity = Entities[EntityIndex];
+        if (!IsValid(Entity)) continue;
+
+        FCrowdEntityState State;
+        FCrowdCachedState& Cached = CachedStates[EntityIndex];
+        if (Cached.bValid)
+        {
+            // 建筑：只有血量和可攻击标记会变
+            State = Cached.State;
+            State.CurrentHealth = Entity->CurrentHealth;
+            State.PredictedHealth = Entity->GetPredictedHealth();
+            State.bIsTargetable = Entity->bIsTargetable;
+        }
+        else
+        {
+            MakeEntityState(Entity, State);
+            if (!State.bIsUnit)
+            {
+                Cached.State = State;
+                Cached.bValid = true;
+            }
+        }
+
+        const int32 Index = Frame.Entities.Add(State);
+        Frame.EntityIndexMap.Add(Entity, Index);
+        // 已经死亡 (句柄已释放，槽位可能被新实体复用) 的实体按句柄查不到
+        if (ResolveHandle(State.Handle) == Entity) Frame.HandleToEntity[State.Handle.Index] = Index;
+
+        // 只有活着且开启碰撞的单位参与避让 (被玩家拿起的兵会关闭碰撞)
+        if (State.bIsUnit && State.IsAlive() && Entity->GetActorEnableCollision())
+        {
+            Frame.NeighborCells.FindOrAdd(Frame.GetCell(State.Location)).Add(Index);
+        }
+        else if (!State.bIsUnit && State.IsAlive())
+        {
+            Frame.BuildingCells.FindOrAdd(Frame.GetCell(State.Location)).Add(Index);
+        }
+    }
+
+    // 墙：GridManager 里的数据，没有 Actor (包围盒取实例网格体的水平尺寸)
+    int32 NumWalls = 0;
+    if (IsValid(GridManagerRef))
+    {
+        const FVector2D HalfExtent = GridManagerRef->GetWallHalfExtent();
+        for (const FGridWall& Wall : GridManagerRef->GetWalls())
+        {
+            if (!IsHandleAlive(Wall.Handle)) continue;
+
+            FCrowdEntityState State;
+            State.Handle = Wall.Handle;
+            State.Location = Wall.Location;
+            State.TeamID = Wall.Team;
+            State.CurrentHealth = Wall.Health;
+            State.PredictedHealth = Wall.GetPredictedHealth();
+            State.bIsTargetable = true;
+            State.BuildingType = EBuildingType::Wall;
+            State.GridTile = Wall.Tile;
+            State.BoxCenter = FVector2D(Wall.Location);
+            State.BoxExtent = HalfExtent;
+
+            const int32 Index = Frame.Entities.Add(State);
+            Frame.HandleToEntity[Wall.Handle.Index] = Index;
+            Frame.BuildingCells.FindOrAdd(Frame.GetCell(State.Location)).Add(Index);
+            ++NumWalls;
+        }
+    }
+    SET_DWORD_STAT(STAT_CrowdGridWalls, NumWalls);
+
+    // 阻挡格子 (决策阶段不直接访问 GridManager)
+    Frame.BlockedTiles.Reset();
+    Frame.GridWidth = 0;
+    Frame.GridHeight = 0;
+    Frame.TileSize = 0.0f;
+    if (IsValid(GridManagerRef) && GridManagerRef->GetTileSize() > 0.0f)
+    {
+        Frame.GridOrigin = FVector2D(GridManagerRef->GetActorLocation());
+        Frame.TileSize = GridManagerRef->GetTileSize();
+        Frame.GridWidth = GridManagerRef->GetGridWidth();
+        Frame.GridHeight = GridManagerRef->GetGridHeight();
+        Frame.BlockedTiles.SetNumUninitialized(Frame.GridWidth * Frame.GridHeight);
+        for (int32 Y = 0; Y < Frame.GridHeight; ++Y)
+        {
+            for (int32 X = 0; X < Frame.GridWidth; ++X)
+            {
+                Frame.BlockedTiles[Y * Frame.GridWidth + X] = GridManagerRef->IsTileBlocked(X, Y);
+            }
+        }
+    }
+
+    TargetFields.Update(Frame);
+    UpdateCongestion();
+
+    // 镜头位置 (取观察目标，也就是 RTS 相机 Pawn 的地面位置)
+    bool bHasView = false;
+    FVector ViewLocation = FVector::ZeroVector;
+    if (APlayerController* PC = GetWorld()->GetFirstPlayerController())
+    {
+        if (AActor* ViewTarget = PC->GetViewTarget())
+        {
+            ViewLocation = ViewTarget->GetActorLocation();
+            bHasView = true;
+        }
+    }
+    const float NearDistSq = FMath::Square(CVarCrowdLODNearDistance.GetValueOnGameThread());
+
+    ActiveAgents.Reset();
+    ActiveNearCamera.Reset();
+    for (int32 Index = 0; Index < Units.Num(); ++Index)
+    {
+        ABaseUnit* Unit = Units[Index];
+        if (Unit->IsUnitActive())
+        {
+            ActiveAgents.Add(Index);
+            ActiveNearCamera.Add(!bHasView || FVector::DistSquared2D(Unit->GetActorLocation(), ViewLocation) <= NearDistSq);
+        }
+    }
+}
+
+// 实体的完整快照 (单位每帧调用，建筑只在第一次采集时调用)
+void ACrowdManager::MakeEntityState(ABaseGameEntity* Entity, FCrowdEntityState& OutState) const
+{
+    OutState.Entity = Entity;
+    OutState.Handle = Entity->GetEntityHandle();
+    OutState.Location = Entity->GetActorLocation();
+    OutState.TeamID = Entity->TeamID;
+    OutState.CurrentHealth = Entity->CurrentHealth;
+    OutState.PredictedHealth = Entity->GetPredictedHealth();
+    OutState.bIsTargetable = Entity->bIsTargetable;
+    OutState.bIsUnit = Entity->IsA<ABaseUnit>();
+    OutState.bIsDefense = Entity->IsA<ABuilding_Defense>();
+    OutState.Velocity = FVector2D(Entity->GetVelocity());
+
+    if (ABaseUnit* Unit = Cast<ABaseUnit>(Entity))
+    {
+        OutState.Radius = Unit->AvoidanceRadius;
+        OutState.UnitState = Unit->GetUnitState();
+        OutState.Target = Unit->GetCurrentTargetHandle();
+        OutState.bIsActiveUnit = Unit->IsUnitActive();
+    }
+
+    if (ABaseBuilding* Building = Cast<ABaseBuilding>(Entity))
+    {
+        OutState.BuildingType = Building->BuildingType;
+        OutState.GridTile = FIntPoint(Building->GridX, Building->GridY);
+    }
+
+    // 与原来的表面距离一致：优先根组件，其次静态网格体
+    UPrimitiveComponent* Prim = Cast<UPrimitiveComponent>(Entity->GetRootComponent());
+    if (!Prim) Prim = Entity->FindComponentByClass<UStaticMeshComponent>();
+
+    OutState.BoxCenter = FVector2D(OutState.Location);
+    if (Prim)
+    {
+        // 碰撞体在组件自身坐标系里的包围盒 (带缩放不带旋转)，再按组件的朝向摆到世界里：
+        // 转过的建筑也按实际的碰撞面算距离，不会被世界坐标轴对齐的包围盒放大
+        const FTransform& ComponentTransform = Prim->GetComponentTransform();
+        const FTransform ScaleOnly(FQuat::Identity, FVector::ZeroVector, ComponentTransform.GetScale3D());
+        UBodySetup* BodySetup = Prim->GetBodySetup();
+        FBox LocalBox = BodySetup ? BodySetup->AggGeom.CalcAABB(ScaleOnly) : FBox(ForceInit);
+        if (!LocalBox.IsValid) LocalBox = Prim->CalcBounds(ScaleOnly).GetBox();
+
+        const FQuat Rotation = ComponentTransform.GetRotation();
+        OutState.BoxCenter = FVector2D(ComponentTransform.GetLocation() + Rotation.RotateVector(LocalBox.GetCenter()));
+        OutState.BoxExtent = FVector2D(LocalBox.GetExtent());
+        OutState.BoxAxisX = FVector2D(Rotation.GetAxisX()).GetSafeNormal();
+        if (OutState.BoxAxisX.IsNearlyZero()) OutState.BoxAxisX = FVector2D(1.0f, 0.0f);
+    }
+}
+
+bool ACrowdManager::ShouldWake(const ABaseUnit* Unit, const FUnitWait& Wait) const
+{
+    const FCrowdEntityState* Self = Frame.Find(Unit->GetEntityHandle());
+    if (!Self) return true;
+
+    if (Wait.WakeFlags & (Wake_TargetLost | Wake_TargetOutOfRange))
+    {
+        const FCrowdEntityState* Target = Frame.Find(Unit->GetCurrentTargetHandle());
+        if (!Target || !Target->bIsTargetable) return true;
+
+        if ((Wait.WakeFlags & Wake_TargetOutOfRange) && Target->GetSurfaceDistance(Self->Location) > Wait.WakeRange) return true;
+    }
+
+    if (Wait.WakeFlags & Wake_NeighborNear)
+    {
+        bool bNeighborNear = false;
+        Frame.ForEachNeighbor(Self->Location, [&](const FCrowdEntityState& Other)
+        {
+            if (!bNeighborNear && Other.Entity != Unit && FVector::DistSquared2D(Other.Location, Self->Location) <= FMath::Square(Wait.WakeRange))
+            {
+                bNeighborNear = true;
+            }
+        });
+        if (bNeighborNear) return true;
+    }
+
+    return false;
+}
+
+int32 ACrowdManager::GetDecisionInterval(const ABaseUnit* Unit, bool bNearCamera) const
+{
+    const int32 FarMoveInterval = FMath::Max(1, CVarCrowdFarMoveInterval.GetValueOnGameThread());
+    const int32 Scale = GetThrottle().IntervalScale;
+
+    // 攻击中的单位不受降级影响，保证攻击节奏
+    switch (Unit->GetUnitState())
+    {
+    case EUnitState::Attacking:
+        return bNearCamera ? 1 : 2;
+    case EUnitState::Moving:
+        return (bNearCamera ? 2 : FarMoveInterval) * Scale;
+    default:
+        // 待机的单位要尽快找到目标
+        return (bNearCamera ? 1 : 2) * Scale;
+    }
+}
+
+void ACrowdManager::UpdateCongestion()
+{
+    if (Frame.GridWidth <= 0 || Frame.GridHeight <= 0) return;
+
+    // 每个格子上的单位数 (只数活着且激活的，放在兵营里的不算)
+    CongestionCounts.Reset();
+    CongestionCounts.AddZeroed(Frame.GridWidth * Frame.GridHeight);
+    for (const FCrowdEntityState& State : Frame.Entities)
+    {
+        int32 X, Y;
+        if (!State.bIsUnit || !State.bIsActiveUnit || !State.IsAlive() || !Frame.WorldToTile(State.Location, X, Y)) continue;
+
+        uint16& Count = CongestionCounts[Y * Frame.GridWidth + X];
+        if (Count < MAX_uint16) ++Count;
+    }
+
+    GridManagerRef->GetCongestionLayer().Update(Frame.GridWidth, Frame.GridHeight, CongestionCounts, Frame.DeltaTime,
+        CVarCrowdCongestionHalfLife.GetValueOnGameThread());
+}
+
+// 分时调度：轮到自己分桶的单位才做完整决策，超出预算的顺延到下一帧
+void ACrowdManager::ScheduleDecisions()
+{
+    DecisionAgents.Reset();
+    SuspendedAgents = 0;
+    for (int32 i = 0; i < ActiveAgents.Num(); ++i)
+    {
+        const int32 Index = ActiveAgents[i];
+        FCrowdAgentSlot& Slot = AgentSlots[Index];
+
+        // 挂起中：条件没触发就什么都不做 (提交阶段沿用挂起前的速度)
+        FUnitWait& Wait = Slot.Intent.Wait;
+        if (Wait.IsSuspended(Frame.TimeSeconds))
+        {
+            // 只等冷却的 (目标死亡会通过 OnTargetLost 通知)：交给时间轮，到点前不再检查条件
+            if (Wait.WakeFlags == Wake_TargetLost && !Timers.IsPending(Slot.WakeTimer))
+            {
+                FCrowdTimerPayload Payload;
+                Payload.Entity = Units[Index]->GetEntityHandle();
+                Payload.Type = ECrowdTimerType::UnitWake;
+                Slot.WakeTimer = Timers.Schedule(Wait.WakeTime, Payload);
+            }
+
+            if (Timers.IsPending(Slot.WakeTimer) || !ShouldWake(Units[Index], Wait))
+            {
+                ++SuspendedAgents;
+                continue;
+            }
+            Wait = FUnitWait();
+        }
+
+        // 已经醒了 (到点或被 RequestRetarget 打断)：时间轮上剩下的唤醒作废
+        Timers.Cancel(Slot.WakeTimer);
+        const uint32 Interval = (uint32)GetDecisionInterval(Units[Index], ActiveNearCamera[i]);
+
+        // 到点了，或者因为预算被拖欠了
+        if ((FrameCounter + Slot.Bucket) % Interval == 0 || FrameCounter - Slot.LastDecisionFrame >= Interval)
+        {
+            DecisionAgents.Add(Index);
+        }
+    }
+
+    const int32 Budget = CVarCrowdDecisionBudget.GetValueOnGameThread();
+    if (Budget > 0 && DecisionAgents.Num() > Budget)
+    {
+        // 拖欠最久的优先，同样拖欠的按注册顺序
+        DecisionAgents.StableSort([this](int32 A, int32 B)
+        {
+            return (FrameCounter - AgentSlots[A].LastDecisionFrame) > (FrameCounter - AgentSlots[B].LastDecisionFrame);
+        });
+        DecisionAgents.SetNum(Budget);
+        DecisionAgents.Sort();
+    }
+
+    for (int32 Index : DecisionAgents)
+    {
+        AgentSlots[Index].LastDecisionFrame = FrameCounter;
+    }
+}
+
+// 批量选目标：本帧要决策、待机且没有目标的单位按 (兵种, 阵营) 分组，每组按兵种的策略跑一遍
+void ACrowdManager::TargetingPhase()
+{
+    SCOPE_CYCLE_COUNTER(STAT_CrowdTargeting);
+
+    Frame.SelectedTargets.Init(INDEX_NONE, Frame.Entities.Num());
+
+    TMap<uint32, TArray<FTargetingAgent>> Groups;
+    for (int32 Index : DecisionAgents)
+    {
+        const ABaseUnit* Unit = Units[Index];
+        if (Unit->GetUnitState() != EUnitState::Idle || Frame.Find(Unit->GetCurrentTargetHandle())) continue;
+
+        const FCrowdEntityState* UnitState = Frame.Find(Unit->GetEntityHandle());
+        if (!UnitState) continue;
+
+        FTargetingAgent& Agent = Groups.FindOrAdd(((uint32)Unit->UnitType << 8) | (uint32)Unit->TeamID).AddDefaulted_GetRef();
+        Agent.EntityIndex = UnitState - Frame.Entities.GetData();
+        Agent.AttackRange = Unit->AttackRange;
+    }
+
+    for (const auto& Pair : Groups)
+    {
+        const EUnitType UnitType = (EUnitType)(Pair.Key >> 8);
+        const ETeam Team = (ETeam)(Pair.Key & 0xFF);
+
+        // 兵种 -> 选目标策略 (新兵种默认选最近的，有偏好的在这里声明)
+        switch (UnitType)
+        {
+        case EUnitType::Giant:
+            TTargetingPass<FDefenseFirstTargeting>::Run(Frame, Team, Pair.Value, Frame.SelectedTargets, !bParallelDecision);
+            break;
+        case EUnitType::Bomber:
+            TTargetingPass<FWallFirstTargeting>::Run(Frame, Team, Pair.Value, Frame.SelectedTargets, !bParallelDecision);
+            break;
+        default:
+            TTargetingPass<FNearestTargeting>::Run(Frame, Team, Pair.Value, Frame.SelectedTargets, !bParallelDecision);
+            break;
+        }
+    }
+}
+
+// 2. 决策：只读快照，每个单位只写自己的意图槽
+void ACrowdManager::DecidePhase()
+{
+    TargetingPhase();
+
+    const FCrowdFrame& ReadFrame = Frame;
+    ParallelFor(DecisionAgents.Num(), [this, &ReadFrame](int32 i)
+    {
+        const int32 Index = DecisionAgents[i];
+        Units[Index]->DecideIntent(ReadFrame, AgentSlots[Index].Intent);
+    }, !bParallelDecision);
+}
+
+// 3. 提交：按固定顺序串行应用，产生副作用的操作都在这里
+void ACrowdManager::CommitPhase(float DeltaTime)
+{
+    const int32 MaxPathRequests = GetThrottle().MaxPathRequests;
+    int32 PathRequests = 0;
+    DeferredPathRequests = 0;
+    PathRequestsThisFrame = 0;
+    PathSearchesThisFrame = 0;
+
+    for (int32 Index : ActiveAgents)
+    {
+        ABaseUnit* Unit = Units[Index];
+
+        // 本帧提交过程中可能已被打死或自爆
+        if (!IsValid(Unit)) continue;
+
+        FCrowdAgentSlot& Slot = AgentSlots[Index];
+        if (Slot.LastDecisionFrame == FrameCounter)
+        {
+            if (Slot.Intent.bRequestPath && MaxPathRequests > 0 && PathRequests >= MaxPathRequests)
+            {
+                // 本帧寻路次数用完：这次不寻路，标记为拖欠让它下一帧优先重新决策
+                FUnitIntent Deferred = Slot.Intent;
+                Deferred.bRequestPath = false;
+                Deferred.Wait = FUnitWait();
+                if (Deferred.NewState == EUnitState::Idle) Deferred.NewTarget.Reset(); // 待机时下次重新选目标并寻路
+                Slot.LastDecisionFrame = 0;
+                ++DeferredPathRequests;
+
+                Unit->CommitIntent(Deferred, DeltaTime);
+                continue;
+            }
+
+            if (Slot.Intent.bRequestPath) ++PathRequests;
+            Unit->CommitIntent(Slot.Intent, DeltaTime);
+        }
+        else
+        {
+            // 没轮到决策的帧：在两次决策之间插值，沿路径走、不越过路点
+            Unit->InterpolateMovement(Slot.Intent.Velocity, DeltaTime);
+        }
+    }
+
+    // 所有意图提交完后统一寻路
+    FlushPathRequests();
+}
@@ -0,0 +1,584 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BaseUnit.h"
+#include "TargetDistanceField.h"
+#include "TimerWheel.h"
+#include "CrowdDamage.h"
+#include "CrowdCleanup.h"
+#include "CrowdDefenseWatch.h"
+#include "CrowdSquads.h"
+#include "CrowdTargetFields.h"
+#include "CrowdManager.generated.h"
+
+// 群体模拟各阶段和子系统 (Crowd*.cpp) 共用的统计分组
+DECLARE_STATS_GROUP(TEXT("RTSCrowd"), STATGROUP_RTSCrowd, STATCAT_Advanced);
+
+class ABaseGameEntity;
+class ABuilding_Defense;
+struct FGridWall;
+
+// 实体快照：决策阶段只读这份数据，工作线程不直接访问 UObject 状态
+struct FCrowdEntityState
+{
+    ABaseGameEntity* Entity = nullptr;
+    FEntityHandle Handle;
+    FVector Location = FVector::ZeroVector;
+    // 碰撞体在水平面上的有向包围盒（用于表面距离，跟着 Actor 旋转）
+    FVector2D BoxCenter = FVector2D::ZeroVector;
+    FVector2D BoxExtent = FVector2D::ZeroVector;    // 半尺寸 (盒子自己的坐标轴上)
+    FVector2D BoxAxisX = FVector2D(1.0f, 0.0f);     // 盒子 X 轴在世界中的方向 (单位向量)
+    FVector2D Velocity = FVector2D::ZeroVector;    // 上一帧的移动速度 (避让用)
+    float Radius = 0.0f;                            // 避让半径 (只有单位有)
+
+    // 以下只有单位有 (小队队员跟随队长用)
+    EUnitState UnitState = EUnitState::Idle;
+    FEntityHandle Target;
+    bool bIsActiveUnit = false;
+    ETeam TeamID = ETeam::Enemy;
+    float CurrentHealth = 0.0f;
+    float PredictedHealth = 0.0f;                   // 扣掉飞行中子弹的伤害
+    bool bIsTargetable = false;
+    bool bIsUnit = false;
+    bool bIsDefense = false;                        // 是否为防御塔 (巨人优先)
+    EBuildingType BuildingType = EBuildingType::None;
+    FIntPoint GridTile = FIntPoint(INDEX_NONE, INDEX_NONE);  // 建筑占的格子
+
+    bool IsAlive() const { return CurrentHealth > 0.0f; }
+
+    // 还活着，但在路上的子弹已经够打死它了 (不再选它做目标)
+    bool IsDoomed() const { return PredictedHealth <= 0.0f; }
+
+    // 水平面上到碰撞体表面的距离（在包围盒内部时为 0）
+    float GetSurfaceDistance(const FVector& From) const
+    {
+        const FVector2D Offset = FVector2D(From) - BoxCenter;
+        const float LocalX = FVector2D::DotProduct(Offset, BoxAxisX);
+        const float LocalY = FVector2D::DotProduct(Offset, FVector2D(-BoxAxisX.Y, BoxAxisX.X));
+        const float OutsideX = FMath::Max(FMath::Abs(LocalX) - BoxExtent.X, 0.0f);
+        const float OutsideY = FMath::Max(FMath::Abs(LocalY) - BoxExtent.Y, 0.0f);
+        return FVector2D(OutsideX, OutsideY).Size();
+    }
+};
+
+// 每帧的世界快照 (采集阶段写入，决策阶段只读)
+struct FCrowdFrame
+{
+    float TimeSeconds = 0.0f;
+    float DeltaTime = 0.0f;
+
+    TArray<FCrowdEntityState> Entities;
+    TMap<const AActor*, int32> EntityIndexMap;
+    TArray<int32> HandleToEntity;   // 句柄槽位 -> Entities 下标
+
+    // 邻居网格：格子 -> 单位在 Entities 中的下标
+    float NeighborCellSize = 100.0f;
+    TMap<FIntPoint, TArray<int32>> NeighborCells;
+
+    // 建筑也按同样的格子分桶 (范围伤害查询用，避让不看)
+    TMap<FIntPoint, TArray<int32>> BuildingCells;
+
+    // 每次查询最多访问的邻居数 (0 = 不限，由降级档位设置)
+    int32 MaxNeighbors = 0;
+
+    // 阻挡格子 (从 GridManager 拷贝，避让时作为静态障碍)
+    FVector2D GridOrigin = FVector2D::ZeroVector;
+    float TileSize = 0.0f;
+    int32 GridWidth = 0;
+    int32 GridHeight = 0;
+    TArray<bool> BlockedTiles;
+
+    bool IsTileBlocked(int32 X, int32 Y) const
+    {
+        return X >= 0 && X < GridWidth && Y >= 0 && Y < GridHeight && BlockedTiles[Y * GridWidth + X];
+    }
+
+    bool WorldToTile(const FVector& Location, int32& OutX, int32& OutY) const
+    {
+        if (TileSize <= 0.0f) return false;
+        OutX = FMath::FloorToInt((Location.X - GridOrigin.X) / TileSize);
+        OutY = FMath::FloorToInt((Location.Y - GridOrigin.Y) / TileSize);
+        return OutX >= 0 && OutX < GridWidth && OutY >= 0 && OutY < GridHeight;
+    }
+
+    // 批量选目标的结果：单位的快照下标 -> 目标的快照下标 (只有本帧待机且没有目标的单位才有)
+    TArray<int32> SelectedTargets;
+
+    FEntityHandle GetSelectedTarget(const FEntityHandle& Unit) const
+    {
+        const FCrowdEntityState* State = Find(Unit);
+        const int32 TargetIndex = State ? SelectedTargets[State - Entities.GetData()] : INDEX_NONE;
+        return (TargetIndex != INDEX_NONE) ? Entities[TargetIndex].Handle : FEntityHandle();
+    }
+
+    // 目标距离场 (按进攻方阵营和目标类别，没有维护的为空)
+    TArray<const FTargetDistanceField*> TargetFields;
+
+    static int32 GetTargetFieldIndex(ETeam Attacker, ETargetFieldType Type)
+    {
+        return (int32)Attacker * (int32)ETargetFieldType::MAX + (int32)Type;
+    }
+
+    // 站在可走的格子上且距离场可用时才能查表，否则退回逐个比较表面距离
+    bool CanUseTargetFields(ETeam Attacker, const FVector& Location) const;
+
+    // 按路径距离最近的目标 (走不到任何目标时为空)，OutPathDistance 为世界单位
+    const FCrowdEntityState* FindFieldTarget(ETeam Attacker, ETargetFieldType Type, const FVector& Location, float* OutPathDistance = nullptr) const;
+
+    // 距离场是否正指向 Target：是的话给出下一步要去的位置 (已在外围时就是目标本身)
+    bool GetFieldStep(ETeam Attacker, const FEntityHandle& Target, const FVector& Location, FVector& OutNextLocation) const;
+
+    const FCrowdEntityState* Find(const AActor* Actor) const
+    {
+        const int32* Index = Actor ? EntityIndexMap.Find(Actor) : nullptr;
+        return Index ? &Entities[*Index] : nullptr;
+    }
+
+    // 按句柄查找：越界检查 + 代数比较，已经死亡的实体查不到
+    const FCrowdEntityState* Find(const FEntityHandle& Handle) const
+    {
+        if (!HandleToEntity.IsValidIndex(Handle.Index)) return nullptr;
+
+        const int32 Index = HandleToEntity[Handle.Index];
+        return (Index != INDEX_NONE && Entities[Index].Handle == Handle) ? &Entities[Index] : nullptr;
+    }
+
+    FIntPoint GetCell(const FVector& Location) const
+    {
+        return FIntPoint(FMath::FloorToInt(Location.X / NeighborCellSize), FMath::FloorToInt(Location.Y / NeighborCellSize));
+    }
+
+    // 遍历半径内的所有单位（只查周围 3x3 个格子，半径不要超过格子尺寸）
+    // 先查自己所在的格子，达到 MaxNeighbors 后提前结束
+    template <typename FuncType>
+    void ForEachNeighbor(const FVector& Location, FuncType Func) const
+    {
+        static const FIntPoint Offsets[9] = {
+            FIntPoint(0, 0), FIntPoint(-1, 0), FIntPoint(1, 0), FIntPoint(0, -1), FIntPoint(0, 1),
+            FIntPoint(-1, -1), FIntPoint(-1, 1), FIntPoint(1, -1), FIntPoint(1, 1) };
+
+        const FIntPoint Center = GetCell(Location);
+        int32 Visited = 0;
+        for (const FIntPoint& Offset : Offsets)
+        {
+            if (const TArray<int32>* Cell = NeighborCells.Find(Center + Offset))
+            {
+                for (int32 Index : *Cell)
+                {
+                    if (MaxNeighbors > 0 && Visited++ >= MaxNeighbors) return;
+                    Func(Entities[Index]);
+                }
+            }
+        }
+    }
+
+    // 遍历中心距离在 Radius 内的所有实体 (单位 + 建筑)，半径可以任意大，只查覆盖到的格子
+    // 按快照下标顺序回调，结果与格子遍历顺序无关
+    template <typename FuncType>
+    void ForEachEntityInRadius(const FVector& Center, float Radius, FuncType Func) const
+    {
+        TArray<int32, TInlineAllocator<64>> Found;
+        const FIntPoint MinCell = GetCell(Center - FVector(Radius, Radius, 0.0f));
+        const FIntPoint MaxCell = GetCell(Center + FVector(Radius, Radius, 0.0f));
+        const float RadiusSq = Radius * Radius;
+        for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+        {
+            for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+            {
+                for (const TMap<FIntPoint, TArray<int32>>* Cells : { &NeighborCells, &BuildingCells })
+                {
+                    const TArray<int32>* Cell = Cells->Find(FIntPoint(CellX, CellY));
+                    if (!Cell) continue;
+
+                    for (int32 Index : *Cell)
+                    {
+                        if (FVector::DistSquared2D(Entities[Index].Location, Center) <= RadiusSq) Found.Add(Index);
+                    }
+                }
+            }
+        }
+
+        Found.Sort();
+        for (int32 Index : Found)
+        {
+            Func(Entities[Index]);
+        }
+    }
+};
+
+// 挂起后的唤醒条件：满足任意一个，或者到了 WakeTime，就恢复决策
+enum ECrowdWakeFlags : uint8
+{
+    Wake_None = 0,
+    Wake_TargetLost = 1 << 0,         // 目标死亡/不在快照里
+    Wake_TargetOutOfRange = 1 << 1,   // 目标 (会走动的单位) 离开 WakeRange
+    Wake_NeighborNear = 1 << 2,       // 有别的单位进入 WakeRange (需要避让了)
+};
+
+/**
+ * 行为的挂起点 (协程式的 yield)
+ * 决策阶段发现接下来一段时间的结果是确定的 (等攻击冷却、沿路径直线走到下一个路点)，就给出挂起条件；
+ * 调度阶段只检查条件，不再为它做完整决策，挂起期间沿用挂起前的速度，醒来后从当前状态继续
+ */
+struct FUnitWait
+{
+    float WakeTime = 0.0f;        // 到这个时间恢复 (0 = 没有挂起)
+    uint8 WakeFlags = Wake_None;
+    float WakeRange = 0.0f;       // Wake_TargetOutOfRange / Wake_NeighborNear 的距离
+
+    bool IsSuspended(float TimeSeconds) const { return WakeTime > TimeSeconds; }
+};
+
+// 单位意图：决策阶段的输出，提交阶段统一应用
+struct FUnitIntent
+{
+    EUnitState NewState = EUnitState::Idle;
+    FEntityHandle NewTarget;
+    int32 NewPathIndex = 0;
+    FVector Velocity = FVector::ZeroVector;
+
+    bool bRequestPath = false;   // 需要重新寻路（寻路成功后切到 Moving）
+    bool bClearPath = false;     // 进入攻击状态，丢弃剩余路点
+    bool bAttack = false;        // 冷却已好，执行一次攻击
+    bool bDropDoomedTarget = false; // 目标已经必死，放弃它 (统计用)
+
+    FUnitWait Wait;              // 挂起条件 (调度阶段检查)
+};
+
+// 子弹统计 (累计值，用来对比伤害预约前后浪费了多少子弹)
+struct FCrowdProjectileStats
+{
+    int32 Spawned = 0;          // 发射的子弹
+    int32 Wasted = 0;           // 没命中就销毁的 (目标先死了/超时)
+    int32 DoomedSkipped = 0;    // 目标已经必死，放弃开火/换目标的次数
+};
+
+// 建筑的快照缓存：与 Entities 下标一一对应 (单位的项不用)
+struct FCrowdCachedState
+{
+    FCrowdEntityState State;
+    bool bValid = false;
+};
+
+// 单位调度槽：与 Units 下标一一对应，跨帧保留上一次的意图
+struct FCrowdAgentSlot
+{
+    FUnitIntent Intent;
+    int32 Bucket = 0;               // 轮转分桶，错开同频单位的决策帧
+    uint32 LastDecisionFrame = 0;   // 上次完整决策的帧号
+    FTimerWheelHandle WakeTimer;    // 只等冷却的挂起交给时间轮，到点前调度阶段不再检查
+};
+
+// 时间轮任务的类型
+enum class ECrowdTimerType : uint8
+{
+    EntityAction,   // 实体自己安排的回调 (防御塔开火、资源生产)
+    UnitWake,       // 单位攻击冷却结束 (挂起的单位本帧优先决策)
+};
+
+struct FCrowdTimerPayload
+{
+    FEntityHandle Entity;
+    ECrowdTimerType Type = ECrowdTimerType::EntityAction;
+};
+
+// 降级档位：帧开销超出预算时逐级收紧，有余量时再逐级恢复
+struct FCrowdThrottleLevel
+{
+    int32 MaxPathRequests;      // 每帧最多寻路次数 (0 = 不限)，超出的顺延
+    int32 IntervalScale;        // 待机/移动单位的决策间隔倍数 (重新选目标变慢)
+    int32 MaxNeighbors;         // 避让时最多访问的邻居数 (0 = 不限)
+    bool bReducedProjectiles;   // 子弹降低表现精度 (关阴影、降低 Tick 频率)
+};
+
+// 句柄槽位：代数在释放时加一，旧句柄随之失效
+// Entity 不需要 UPROPERTY：实体 EndPlay 时一定会释放槽位
+// 墙没有 Actor，槽位里记的是它在 GridManager 里的下标
+struct FEntityHandleSlot
+{
+    ABaseGameEntity* Entity = nullptr;
+    int32 WallIndex = INDEX_NONE;
+    uint32 Generation = 1;
+};
+
+// 提交阶段收集的寻路请求 (记录请求时的目标，目标变了就作废)
+struct FCrowdPathRequest
+{
+    ABaseUnit* Unit = nullptr;
+    FEntityHandle Target;
+};
+
+/**
+ * 群体模拟管理器：所有单位的 AI、战斗结算和死亡清理都在这里分阶段推进，每帧的顺序：
+ * 采集快照 -> 唤醒防御塔 -> 时间轮回调 -> 分时调度 -> 批量选目标 -> 并行决策 -> 串行提交 (含合并寻路)
+ * -> 结算伤害队列 -> 调整降级档位 -> 清理死亡实体
+ * 决策阶段只读快照，其余阶段都在游戏线程按注册顺序执行，结果与线程数无关
+ * 管理器只负责快照、调度、决策和提交；伤害队列 (CrowdDamage)、延迟销毁 (CrowdCleanup)、防御塔唤醒 (CrowdDefenseWatch)、
+ * 小队与攻击位 (CrowdSquads)、目标距离场 (CrowdTargetFields) 各自独立，由对应的阶段调用
+ */
+UCLASS()
+class AUTOBATTLEDEMO_API ACrowdManager : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    ACrowdManager();
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void Tick(float DeltaTime) override;
+
+    // 获取当前世界的管理器（没有则自动生成一个，之后按 World 缓存，见 WorldSingleton.h）
+    static ACrowdManager* Get(const UObject* WorldContextObject);
+
+    // 实体注册 (ABaseGameEntity 的 BeginPlay/EndPlay 调用)，注册时发放句柄
+    FEntityHandle RegisterEntity(ABaseGameEntity* Entity);
+    void UnregisterEntity(ABaseGameEntity* Entity);
+
+    // 句柄解析：实体已死亡/注销时返回空，不访问 UObject
+    ABaseGameEntity* ResolveHandle(const FEntityHandle& Handle) const
+    {
+        return (HandleSlots.IsValidIndex(Handle.Index) && HandleSlots[Handle.Index].Generation == Handle.Generation) ? HandleSlots[Handle.Index].Entity : nullptr;
+    }
+
+    // 让句柄失效 (死亡时立即调用，注销时兜底)，槽位回收复用
+    void ReleaseHandle(const FEntityHandle& Handle);
+
+    // 墙的句柄 (GridManager 放墙时调用，拆墙时 ReleaseHandle)
+    // 墙没有 Actor，ResolveHandle 解析为空；要位置/存活的地方用下面按句柄的查询
+    FEntityHandle RegisterWall(class AGridManager* GridManager, int32 WallIndex);
+
+    // 句柄还有效 (实体或墙都算)
+    bool IsHandleAlive(const FEntityHandle& Handle) const
+    {
+        if (!HandleSlots.IsValidIndex(Handle.Index) || HandleSlots[Handle.Index].Generation != Handle.Generation) return false;
+        return HandleSlots[Handle.Index].Entity || HandleSlots[Handle.Index].WallIndex != INDEX_NONE;
+    }
+
+    // 句柄对应的墙下标 (不是墙或已失效时返回 INDEX_NONE)
+    int32 GetWallIndex(const FEntityHandle& Handle) const
+    {
+        return (HandleSlots.IsValidIndex(Handle.Index) && HandleSlots[Handle.Index].Generation == Handle.Generation) ? HandleSlots[Handle.Index].WallIndex : INDEX_NONE;
+    }
+
+    // 按句柄取目标的位置/阵营，实体和墙通用 (失效时返回 false)
+    bool GetTargetLocation(const FEntityHandle& Handle, FVector& OutLocation, ETeam* OutTeam = nullptr) const;
+
+    // 按句柄预约/归还伤害 (子弹发射、命中时调用)，实体和墙通用
+    void ReservePendingDamage(const FEntityHandle& Handle, float Amount);
+    void ReleasePendingDamage(const FEntityHandle& Handle, float Amount);
+    bool IsTargetDoomed(const FEntityHandle& Handle) const;
+
+    // 把一起部署的兵编成小队 (同兵种且相邻的编在一起)
+    // 只有队长寻路，队员按阵型偏移跟随，掉队时才自己寻路
+    void CreateSquads(const TArray<ABaseUnit*>& NewUnits);
+
+    // 寻路请求：提交阶段末尾统一处理，同一目标格子的请求合并成一次反向搜索
+    void QueuePathRequest(ABaseUnit* Unit);
+
+    // 攻击位：近战单位选中建筑目标时预约离自己最近的空位，切换目标时归还
+    // 返回攻击位下标 (没有空位/目标不是建筑时返回 INDEX_NONE)
+    int32 ReserveAttackSlot(ABaseUnit* Unit, const FEntityHandle& Building, FVector& OutLocation);
+    void ReleaseAttackSlot(ABaseUnit* Unit, const FEntityHandle& Building, int32 SlotIndex);
+
+    // 单位的目标死了：丢弃它本帧的意图，下一帧优先重新决策 (受 DecisionBudget 限制，分批完成)
+    void RequestRetarget(ABaseUnit* Unit);
+
+    // 伤害队列：伤害不再当场结算，先按目标合并，本帧模拟结束后一次性结算
+    // 排队的伤害计入目标的预测血量 (同一帧后面的攻击者能看出它已经必死)
+    void QueueDamage(ABaseGameEntity* Target, float Damage, AActor* DamageCauser);
+    void QueueDamage(const FEntityHandle& Target, float Damage, AActor* DamageCauser);
+
+    // 范围伤害：在快照的空间格子上查出范围内的目标，按目标排进伤害队列，返回命中数
+    int32 ApplyRadialDamage(const FRadialDamageParams& Params, AActor* DamageCauser, FRadialDamageResult* OutResult = nullptr);
+
+    // 定时器服务 (实体的 ScheduleAction 调用)：到 FireTime 回调 Entity->OnScheduledAction
+    // 挂在层级时间轮上 (TimerWheel.h)，只等冷却的实体不用 Tick
+    void ScheduleEntityAction(ABaseGameEntity* Entity, float FireTime);
+    void CancelEntityAction(ABaseGameEntity* Entity);
+    bool IsEntityActionScheduled(const ABaseGameEntity* Entity) const;
+
+    // 防御塔的射程格子 (BeginPlay、升级改射程时登记，注销实体时一并移除)
+    // 防御塔平时不 Tick，有敌方单位走进这些格子时由 WakeDefenses 唤醒
+    void RegisterDefenseWatch(ABuilding_Defense* Tower);
+    void UnregisterDefenseWatch(ABuilding_Defense* Tower);
+
+    // 查本帧快照：Range 内最近的敌方单位 (活着、不是必死)，返回解析后的实体
+    ABaseGameEntity* FindNearestEnemyUnit(const FVector& Location, float Range, ETeam Team) const;
+
+    // 死亡的实体 (已隐藏、已注销) 排队，在清理阶段按时间预算销毁 (单位回对象池)
+    void QueueCleanup(ABaseGameEntity* Entity);
+
+    const FCrowdGCStats& GetGCStats() const { return GCTracker.GetStats(); }
+
+    // 子弹统计 (子弹和射手调用)
+    void NoteProjectileSpawned();
+    void NoteProjectileWasted();
+    void NoteDoomedTargetSkipped();
+    const FCrowdProjectileStats& GetProjectileStats() const { return ProjectileStats; }
+
+    // 当前降级档位 (0 = 全精度)
+    int32 GetThrottleLevel() const { return ThrottleLevel; }
+    bool ShouldReduceProjectileFidelity() const;
+
+protected:
+    // 关闭后决策阶段退化为单线程（调试/对比用）
+    UPROPERTY(EditAnywhere, Category = "Crowd")
+        bool bParallelDecision;
+
+    // 邻居网格尺寸，即避让时考虑邻居的范围
+    UPROPERTY(EditAnywhere, Category = "Crowd")
+        float NeighborCellSize;
+
+    // 编队参数：每队人数上限 / 与队长的最大距离 (也是阵型偏移的上限)
+    UPROPERTY(EditAnywhere, Category = "Crowd|Squad")
+        int32 MaxSquadSize;
+
+    UPROPERTY(EditAnywhere, Category = "Crowd|Squad")
+        float SquadRadius;
+
+private:
+    // 采集：在游戏线程把实体状态拷贝成快照
+    void GatherFrame(float DeltaTime);
+    void MakeEntityState(ABaseGameEntity* Entity, FCrowdEntityState& OutState) const;
+
+    // 分时调度：近处攻击中的单位每帧决策，远处移动的每 N 帧一次，挂起 (FUnitWait) 的到点或条件触发才醒
+    // 每帧决策数的上限由 rts.Crowd.DecisionBudget 控制，没轮到的单位沿用上次的速度
+    void ScheduleDecisions();
+
+    // 按兵种的策略批量选目标 (TargetingPolicy.h)
+    void TargetingPhase();
+
+    // 决策：ParallelFor 并行计算每个单位的意图，只读快照
+    void DecidePhase();
+
+    // 提交：按注册顺序串行执行移动、攻击，最后统一寻路
+    void CommitPhase(float DeltaTime);
+
+    // 处理本帧收集的寻路请求
+    void FlushPathRequests();
+
+    // 统计各格子的单位数，更新 GridManager 的拥堵层 (寻路成本用，拥堵的格子更贵，后来的单位会分流)
+    void UpdateCongestion();
+
+    // 推进时间轮，回调本帧到点的任务 (在采集之后、决策之前)
+    void FireTimers();
+
+    // 时间轮的起点 (第一次安排或推进时，管理器可能比实体晚 BeginPlay)
+    void StartTimers();
+
+    // 结算伤害队列：每个目标只调用一次 TakeDamage (受击特效只触发一次)，
+    // 死亡的墙一次性解除阻挡，胜负只判一次
+    void ResolveDamageQueue();
+
+    // 清理阶段：在 rts.Crowd.CleanupBudgetMs 内处理排队的死亡实体 (每帧至少一个)，单位回池，建筑销毁
+    void CleanupPhase();
+
+    // 队员离队 (死亡/移除)，队长没了就顺位接任
+    void RemoveFromSquad(ABaseUnit* Unit);
+
+    // 单位的调度槽下标 (存在单位身上，O(1)；已注销返回 INDEX_NONE)
+    int32 FindAgentIndex(const ABaseUnit* Unit) const;
+
+    // 按句柄找墙 (不是墙或已失效时返回空)
+    FGridWall* FindWall(const FEntityHandle& Handle) const;
+
+    // 挂起的单位是否该醒了 (只查时间和快照，比完整决策便宜得多)
+    bool ShouldWake(const ABaseUnit* Unit, const FUnitWait& Wait) const;
+
+    // 按状态和离镜头的远近决定决策间隔 (帧)
+    int32 GetDecisionInterval(const ABaseUnit* Unit, bool bNearCamera) const;
+
+    // 根据本帧耗时调整降级档位：超过 rts.Crowd.FrameBudgetMs 时逐级限制寻路次数、选目标频率、避让邻居数和子弹表现，
+    // 有余量后逐级恢复 (rts.Crowd.ShowGovernor 显示)
+    void UpdateGovernor(double FrameCostMs);
+    const FCrowdThrottleLevel& GetThrottle() const;
+
+    // 阻挡格子的来源
+    UPROPERTY()
+        class AGridManager* GridManagerRef;
+
+    // 死亡单位回收到这里 (第一次清理单位时取，之后不再查找)
+    UPROPERTY()
+        class AUnitPool* UnitPoolRef;
+
+    // 句柄槽位 (下标即句柄的 Index)
+    TArray<FEntityHandleSlot> HandleSlots;
+    TArray<int32> FreeHandleSlots;
+
+    // 已注册的实体 (兵 + 建筑)，保持注册顺序
+    UPROPERTY()
+        TArray<ABaseGameEntity*> Entities;
+
+    // 建筑不会移动：类型、格子、包围盒第一次采集时算好，之后每帧只刷新血量 (注册/注销时同步增删)
+    TArray<FCrowdCachedState> CachedStates;
+
+    // 已注册的单位，提交阶段按这个顺序执行
+    // 注销时只置空，下一帧采集前再压缩 (提交阶段可能有单位死亡)
+    UPROPERTY()
+        TArray<ABaseUnit*> Units;
+
+    TArray<FCrowdAgentSlot> AgentSlots;
+    int32 NextBucket;
+    uint32 FrameCounter;
+
+    // 小队 / 各建筑的攻击位
+    FCrowdSquadSet Squads;
+    FCrowdAttackSlotTable AttackSlots;
+
+    // 本帧快照
+    FCrowdFrame Frame;
+
+    // 场上没有单位时快照只在实体/墙注册、注销后重新采集一次，其余帧直接沿用
+    bool bFrameStale;
+
+    // 本帧激活的单位 / 本帧需要完整决策的单位 (都是 Units 的下标)
+    TArray<int32> ActiveAgents;
+    TArray<int32> DecisionAgents;
+
+    // 本帧是否离镜头近 (下标与 ActiveAgents 对应)
+    TArray<bool> ActiveNearCamera;
+
+    // --- 自适应降级 ---
+    int32 ThrottleLevel;
+    double SmoothedCostMs;          // 平滑后的每帧耗时
+    int32 FramesSinceLevelChange;   // 距上次换档的帧数 (防止来回抖动)
+    int32 HeadroomFrames;           // 连续有余量的帧数
+    int32 DeferredPathRequests;     // 本帧被顺延的寻路请求 (显示用)
+    int32 SuspendedAgents;          // 本帧挂起、跳过决策的单位 (显示用)
+
+    // --- 寻路合并 ---
+    TArray<FCrowdPathRequest> PendingPathRequests;
+    int32 PathRequestsThisFrame;    // 本帧处理的寻路请求数
+    int32 PathSearchesThisFrame;    // 本帧实际执行的搜索次数 (两者之差就是省下的搜索)
+
+    // --- 伤害预约 ---
+    FCrowdProjectileStats ProjectileStats;
+
+    // --- 目标距离场 (采集阶段末尾增量更新) ---
+    FCrowdTargetFields TargetFields;
+
+    // --- 拥堵层：每帧各格子的单位数 (复用缓冲) ---
+    TArray<uint16> CongestionCounts;
+
+    // --- 伤害队列 (按第一次命中的顺序结算) ---
+    FCrowdDamageQueue DamageQueue;
+
+    // --- 定时器服务：实体句柄 -> 它当前的回调 ---
+    THierarchicalTimerWheel<FCrowdTimerPayload> Timers;
+    TMap<FEntityHandle, FTimerWheelHandle> EntityActionTimers;
+    TArray<THierarchicalTimerWheel<FCrowdTimerPayload>::FEntry> FiredTimers;
+    bool bTimersStarted;
+
+    // --- 防御塔唤醒 ---
+    FCrowdDefenseWatch DefenseWatch;
+    int32 DefensesWokenThisFrame;
+
+    // --- 延迟销毁 (先进先出) ---
+    UPROPERTY()
+        FCrowdCleanupQueue Cleanup;
+    int32 CleanedThisFrame;
+
+    // --- GC 统计 ---
+    FCrowdGCTracker GCTracker;
+};
@@ -0,0 +1,164 @@
+#include "CrowdSquads.h"
+#include "CrowdManager.h"
+#include "BaseUnit.h"
+#include "GridManager.h"
+
+void FCrowdSquadSet::Create(const TArray<ABaseUnit*>& NewUnits, int32 MaxSquadSize, float SquadRadius)
+{
+    TArray<ABaseUnit*> Pending;
+    for (ABaseUnit* Unit : NewUnits)
+    {
+        if (IsValid(Unit) && Unit->GetSquadID() == INDEX_NONE) Pending.Add(Unit);
+    }
+
+    // 按传入顺序贪心分组：第一个没分组的当队长，把附近同兵种的拉进来
+    while (Pending.Num() > 0)
+    {
+        ABaseUnit* Leader = Pending[0];
+        Pending.RemoveAt(0);
+
+        FCrowdSquad Squad;
+        Squad.Members.Add(Leader);
+
+        const FVector LeaderLoc = Leader->GetActorLocation();
+        for (int32 i = 0; i < Pending.Num() && Squad.Members.Num() < MaxSquadSize; )
+        {
+            ABaseUnit* Unit = Pending[i];
+            if (Unit->UnitType == Leader->UnitType && FVector::Dist2D(Unit->GetActorLocation(), LeaderLoc) <= SquadRadius)
+            {
+                Squad.Members.Add(Unit);
+                Pending.RemoveAt(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // 只有一个人就不算小队
+        if (Squad.Members.Num() < 2) continue;
+
+        const int32 SquadID = NextSquadID++;
+        for (ABaseUnit* Member : Squad.Members)
+        {
+            // 阵型保持部署时的相对位置
+            FVector Offset = Member->GetActorLocation() - LeaderLoc;
+            Offset.Z = 0;
+            Member->SetSquad(SquadID, Leader, Offset.GetClampedToMaxSize(SquadRadius));
+        }
+        Squads.Add(SquadID, MoveTemp(Squad));
+    }
+}
+
+void FCrowdSquadSet::Remove(ABaseUnit* Unit, float SquadRadius)
+{
+    if (!Unit) return;
+
+    // 不管小队还在不在，离队的单位都清掉小队字段 (对象池回收的单位复用时不能带着旧队长)
+    const int32 SquadID = Unit->GetSquadID();
+    Unit->SetSquad(INDEX_NONE, nullptr, FVector::ZeroVector);
+
+    FCrowdSquad* Squad = Squads.Find(SquadID);
+    if (!Squad) return;
+
+    const bool bWasLeader = (Squad->Members.Num() > 0 && Squad->Members[0] == Unit);
+    Squad->Members.Remove(Unit);
+
+    // 只剩一个人，解散
+    if (Squad->Members.Num() < 2)
+    {
+        for (ABaseUnit* Member : Squad->Members)
+        {
+            if (IsValid(Member)) Member->SetSquad(INDEX_NONE, nullptr, FVector::ZeroVector);
+        }
+        Squads.Remove(SquadID);
+        return;
+    }
+
+    if (bWasLeader)
+    {
+        // 顺位接任，阵型以新队长为中心重新计算
+        ABaseUnit* NewLeader = Squad->Members[0];
+        const FVector LeaderLoc = NewLeader->GetActorLocation();
+        for (ABaseUnit* Member : Squad->Members)
+        {
+            FVector Offset = Member->GetActorLocation() - LeaderLoc;
+            Offset.Z = 0;
+            Member->SetSquad(SquadID, NewLeader, Offset.GetClampedToMaxSize(SquadRadius));
+        }
+    }
+}
+
+int32 FCrowdAttackSlotTable::Reserve(const ACrowdManager& Crowd, const AGridManager& GridManager, ABaseUnit* Unit, const FEntityHandle& Building, const FIntPoint& TargetTile, FVector& OutLocation)
+{
+    if (!Unit || GridManager.GetTileSize() <= 0.0f) return INDEX_NONE;
+
+    const int32 Width = GridManager.GetGridWidth();
+    const int32 Height = GridManager.GetGridHeight();
+    if (TargetTile.X < 0 || TargetTile.X >= Width || TargetTile.Y < 0 || TargetTile.Y >= Height) return INDEX_NONE;
+
+    FCrowdAttackSlots* BuildingSlots = Slots.Find(Building);
+    if (!BuildingSlots)
+    {
+        BuildingSlots = &Slots.Add(Building);
+
+        // 半格为单位的偏移，只取最外圈 (|DX| 或 |DY| 为 2)：8 个邻格中心 + 8 个邻格交界点
+        const float HalfTile = GridManager.GetTileSize() * 0.5f;
+        const FVector Center = GridManager.GridToWorld(TargetTile.X, TargetTile.Y);
+        for (int32 DY = -2; DY <= 2; ++DY)
+        {
+            for (int32 DX = -2; DX <= 2; ++DX)
+            {
+                if (FMath::Max(FMath::Abs(DX), FMath::Abs(DY)) != 2) continue;
+
+                // 奇数偏移落在两个格子的交界上，两边都要能站
+                bool bWalkable = true;
+                for (int32 TX = FMath::FloorToInt(DX * 0.5f); TX <= FMath::CeilToInt(DX * 0.5f); ++TX)
+                {
+                    for (int32 TY = FMath::FloorToInt(DY * 0.5f); TY <= FMath::CeilToInt(DY * 0.5f); ++TY)
+                    {
+                        const int32 X = TargetTile.X + TX;
+                        const int32 Y = TargetTile.Y + TY;
+                        if (X < 0 || X >= Width || Y < 0 || Y >= Height || GridManager.IsTileBlocked(X, Y)) bWalkable = false;
+                    }
+                }
+                if (!bWalkable) continue;
+
+                BuildingSlots->Locations.Add(Center + FVector(DX * HalfTile, DY * HalfTile, 0.0f));
+                BuildingSlots->Owners.AddDefaulted();
+            }
+        }
+    }
+
+    // 离自己最近的空位 (提交阶段按固定顺序预约，结果确定)
+    const FVector UnitLoc = Unit->GetActorLocation();
+    int32 Best = INDEX_NONE;
+    float BestDistSq = FLT_MAX;
+    for (int32 SlotIndex = 0; SlotIndex < BuildingSlots->Locations.Num(); ++SlotIndex)
+    {
+        const ABaseGameEntity* Owner = Crowd.ResolveHandle(BuildingSlots->Owners[SlotIndex]);
+        if (Owner && Owner != Unit) continue;
+
+        const float DistSq = FVector::DistSquared2D(UnitLoc, BuildingSlots->Locations[SlotIndex]);
+        if (DistSq < BestDistSq)
+        {
+            Best = SlotIndex;
+            BestDistSq = DistSq;
+        }
+    }
+
+    if (Best != INDEX_NONE)
+    {
+        BuildingSlots->Owners[Best] = Unit->GetEntityHandle();
+        OutLocation = BuildingSlots->Locations[Best];
+    }
+    return Best;
+}
+
+void FCrowdAttackSlotTable::Release(ABaseUnit* Unit, const FEntityHandle& Building, int32 SlotIndex)
+{
+    FCrowdAttackSlots* BuildingSlots = Slots.Find(Building);
+    if (!Unit || !BuildingSlots || !BuildingSlots->Owners.IsValidIndex(SlotIndex)) return;
+
+    if (BuildingSlots->Owners[SlotIndex] == Unit->GetEntityHandle()) BuildingSlots->Owners[SlotIndex].Reset();
+}
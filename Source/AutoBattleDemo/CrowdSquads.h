@@ -0,0 +1,61 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "EntityHandle.h"
+
+class ABaseUnit;
+class ACrowdManager;
+class AGridManager;
+
+// 小队：Members[0] 是队长
+struct FCrowdSquad
+{
+    TArray<ABaseUnit*> Members;
+};
+
+/**
+ * 小队编组
+ * 一起部署的兵编成小队 (同兵种且相邻的编在一起)：只有队长寻路，队员按阵型偏移跟随，掉队时才自己寻路
+ * 不持有 UObject 引用：队员注销 (死亡/回池) 时一定会 Remove
+ */
+class FCrowdSquadSet
+{
+public:
+    // 按传入顺序贪心分组 (已经在小队里的跳过)
+    void Create(const TArray<ABaseUnit*>& NewUnits, int32 MaxSquadSize, float SquadRadius);
+
+    // 队员离队并清掉它身上的小队字段，队长没了就顺位接任，只剩一个人就解散
+    void Remove(ABaseUnit* Unit, float SquadRadius);
+
+    void Reset() { Squads.Reset(); }
+
+private:
+    TMap<int32, FCrowdSquad> Squads;
+    int32 NextSquadID = 0;
+};
+
+// 建筑外围的攻击位：以建筑格子为中心、边长两格的方框上每半格一个 (被阻挡的格子上不放)
+// Owners 记录占用者的句柄，占用者死亡后句柄失效，攻击位自动空出来
+struct FCrowdAttackSlots
+{
+    TArray<FVector> Locations;
+    TArray<FEntityHandle> Owners;
+};
+
+/**
+ * 攻击位预约
+ * 近战单位选中建筑目标时预约离自己最近的空位，切换目标时归还，单位不会全挤在建筑的同一侧
+ * 第一次有单位预约时生成，建筑死亡 (句柄释放) 时移除
+ */
+class FCrowdAttackSlotTable
+{
+public:
+    // TargetTile 为建筑或墙占的格子，返回攻击位下标 (没有空位时返回 INDEX_NONE)
+    int32 Reserve(const ACrowdManager& Crowd, const AGridManager& GridManager, ABaseUnit* Unit, const FEntityHandle& Building, const FIntPoint& TargetTile, FVector& OutLocation);
+    void Release(ABaseUnit* Unit, const FEntityHandle& Building, int32 SlotIndex);
+
+    void Remove(const FEntityHandle& Building) { Slots.Remove(Building); }
+    void Reset() { Slots.Reset(); }
+
+private:
+    TMap<FEntityHandle, FCrowdAttackSlots> Slots;
+};
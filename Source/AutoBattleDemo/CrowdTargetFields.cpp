@@ -0,0 +1,75 @@
+#include "CrowdTargetFields.h"
+#include "CrowdManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Target Field Update"), STAT_CrowdTargetFields, STATGROUP_RTSCrowd);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Target Field Tiles Updated"), STAT_CrowdTargetFieldTiles, STATGROUP_RTSCrowd);
+
+void FCrowdTargetFields::Update(FCrowdFrame& Frame)
+{
+    SCOPE_CYCLE_COUNTER(STAT_CrowdTargetFields);
+
+    const int32 NumFields = ARRAY_COUNT(Fields);
+    Frame.TargetFields.Init(nullptr, NumFields);
+
+    if (Frame.TileSize <= 0.0f)
+    {
+        Reset();
+        SET_DWORD_STAT(STAT_CrowdTargetFieldTiles, 0);
+        return;
+    }
+
+    // 只有场上有激活单位的阵营才需要距离场
+    bool bTeamAttacking[NumTeams] = {};
+    for (const FCrowdEntityState& State : Frame.Entities)
+    {
+        if (State.bIsUnit && State.bIsActiveUnit && (int32)State.TeamID < NumTeams)
+        {
+            bTeamAttacking[(int32)State.TeamID] = true;
+        }
+    }
+
+    int32 UpdatedTiles = 0;
+    TArray<FTargetFieldSource> Sources;
+    for (int32 Team = 0; Team < NumTeams; ++Team)
+    {
+        for (int32 Type = 0; Type < (int32)ETargetFieldType::MAX; ++Type)
+        {
+            const int32 Index = FCrowdFrame::GetTargetFieldIndex((ETeam)Team, (ETargetFieldType)Type);
+            FTargetDistanceField& Field = Fields[Index];
+
+            // 没有进攻的阵营：丢掉旧场，下次需要时重建
+            if (!bTeamAttacking[Team])
+            {
+                Field.Reset();
+                continue;
+            }
+
+            // 源：活着、可被攻击的敌方建筑 (按注册顺序)
+            // 子弹在路上的建筑 (IsDoomed) 照样留在场里，直到真的死了才移除；否则子弹一落空就要整片重算，选目标时再跳过它
+            Sources.Reset();
+            for (const FCrowdEntityState& State : Frame.Entities)
+            {
+                if (State.bIsUnit || (int32)State.TeamID == Team) continue;
+                if (!State.IsAlive() || !State.bIsTargetable || State.GridTile.X == INDEX_NONE) continue;
+                if (Type == (int32)ETargetFieldType::Defense && !State.bIsDefense) continue;
+                if (Type == (int32)ETargetFieldType::Wall && State.BuildingType != EBuildingType::Wall) continue;
+
+                FTargetFieldSource& Source = Sources.AddDefaulted_GetRef();
+                Source.Target = State.Handle;
+                Source.TileX = State.GridTile.X;
+                Source.TileY = State.GridTile.Y;
+            }
+
+            Field.Update(Frame.GridWidth, Frame.GridHeight, Frame.BlockedTiles, Sources);
+            UpdatedTiles += Field.GetLastUpdatedTiles();
+            Frame.TargetFields[Index] = &Field;
+        }
+    }
+
+    SET_DWORD_STAT(STAT_CrowdTargetFieldTiles, UpdatedTiles);
+}
+
+void FCrowdTargetFields::Reset()
+{
+    for (FTargetDistanceField& Field : Fields) Field.Reset();
+}
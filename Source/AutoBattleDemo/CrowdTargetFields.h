@@ -0,0 +1,23 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "TargetDistanceField.h"
+
+struct FCrowdFrame;
+
+/**
+ * 各进攻阵营的目标距离场
+ * 每帧按快照收集源 (活着、可被攻击的敌方建筑)，交给 FTargetDistanceField 增量重算，再挂到快照上供选目标查表
+ * 场上没有激活单位的阵营不维护 (丢掉旧场，下次需要时重建)
+ */
+class FCrowdTargetFields
+{
+public:
+    // 采集阶段末尾调用：重算并把可用的场填进 Frame.TargetFields
+    void Update(FCrowdFrame& Frame);
+
+    void Reset();
+
+private:
+    static const int32 NumTeams = 2;
+    FTargetDistanceField Fields[NumTeams * (int32)ETargetFieldType::MAX];
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * 实体句柄：注册表 (ACrowdManager) 的槽位下标 + 代数
+ * 实体死亡或注销时槽位代数加一，旧句柄自然失效
+ * 解析只是一次越界检查加一次代数比较，判断目标是否还活着不用访问 UObject
+ */
+struct FEntityHandle
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    FEntityHandle() {}
+    FEntityHandle(int32 InIndex, uint32 InGeneration) : Index(InIndex), Generation(InGeneration) {}
+
+    // 只表示“指向过某个实体”，是否还活着要通过注册表解析
+    bool IsSet() const { return Index != INDEX_NONE; }
+    void Reset() { *this = FEntityHandle(); }
+
+    bool operator==(const FEntityHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+    bool operator!=(const FEntityHandle& Other) const { return !(*this == Other); }
+
+    friend uint32 GetTypeHash(const FEntityHandle& Handle)
+    {
+        return HashCombine(GetTypeHash(Handle.Index), GetTypeHash(Handle.Generation));
+    }
+};
@@ -0,0 +1,27 @@
+#include "GridCongestion.h"
+
+void FGridCongestionLayer::Update(int32 Width, int32 Height, const TArray<uint16>& Counts, float DeltaTime, float HalfLife)
+{
+    const int32 NumTiles = Width * Height;
+    if (NumTiles <= 0 || Counts.Num() != NumTiles)
+    {
+        Reset();
+        return;
+    }
+
+    // 尺寸变了 (换关卡) 从零开始
+    if (Data.Width != Width || Data.Height != Height || Data.Values.Num() != NumTiles)
+    {
+        Data.Width = Width;
+        Data.Height = Height;
+        Data.Values.Init(0.0f, NumTiles);
+    }
+
+    // 半衰期内拥堵值向当前单位数靠拢一半
+    const float Alpha = (HalfLife > 0.0f) ? 1.0f - FMath::Pow(0.5f, DeltaTime / HalfLife) : 1.0f;
+    TArray<float>& Values = Data.Values;
+    for (int32 Index = 0; Index < NumTiles; ++Index)
+    {
+        Values[Index] += (Counts[Index] - Values[Index]) * Alpha;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "CoreMinimal.h"
+
+// 拥堵值：每个格子平滑后的单位数
+struct FGridCongestion
+{
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<float> Values;
+
+    float Get(int32 Index) const { return Values.IsValidIndex(Index) ? Values[Index] : 0.0f; }
+};
+
+/**
+ * 拥堵层
+ * 群体管理器每帧把各格子的单位数交给它，按半衰期做指数平滑 (人走了拥堵慢慢消退，不会一帧一变)
+ * 寻路时按 (1 + 权重 * 拥堵) 放大格子成本，让后来的单位分流到别的路线上
+ * 更新和寻路都在游戏线程 (寻路在群体管理器的 FlushPathRequests 里串行执行)，原地更新即可
+ */
+class FGridCongestionLayer
+{
+public:
+    // Counts 为本帧每个格子的单位数 (Width * Height)
+    void Update(int32 Width, int32 Height, const TArray<uint16>& Counts, float DeltaTime, float HalfLife);
+
+    void Reset() { Data = FGridCongestion(); }
+
+    // 当前拥堵值 (还没统计过时为空)
+    const FGridCongestion* Get() const { return (Data.Values.Num() > 0) ? &Data : nullptr; }
+
+private:
+    FGridCongestion Data;
+};
@@ -4,17 +4,51 @@
 #include "Misc/AssertionMacros.h"
 #include "LevelDataAsset.h"
 #include "BaseBuilding.h"
+#include "CrowdManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Particles/ParticleSystem.h"
+
+static TAutoConsoleVariable<float> CVarPathCongestionWeight(
+    TEXT("rts.Path.CongestionWeight"),
+    0.5f,
+    TEXT("Extra path cost per (smoothed) unit standing on a tile, as a fraction of the tile cost (0 disables congestion-aware paths)."));
+
+static TAutoConsoleVariable<float> CVarPathCacheLifetime(
+    TEXT("rts.Path.CacheLifetime"),
+    1.0f,
+    TEXT("Seconds a shared path stays reusable while congestion-aware paths are on, so new congestion reaches later searches (0 = reuse only within the same frame)."));
 
 // 构造函数：初始化组件与默认参数
 AGridManager::AGridManager()
 {
     PrimaryActorTick.bCanEverTick = false;
     bDrawDebug = true;
+    SearchCount = 0;
 
     // 创建根组件
     USceneComponent* SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
     RootComponent = SceneRoot;
+
+    // 墙的实例化网格体 (碰撞与 ABaseBuilding 的模型一致，点选/移除靠射线打到实例)
+    WallInstances = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("WallInstances"));
+    WallInstances->SetupAttachment(SceneRoot);
+    WallInstances->SetMobility(EComponentMobility::Movable);   // 运行时增删实例
+    WallInstances->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    WallInstances->SetCollisionObjectType(ECC_WorldStatic);
+    WallInstances->SetCollisionResponseToAllChannels(ECR_Block);
+    WallInstances->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
+
+    WallClass = nullptr;
+    WallDestroyedVFX = nullptr;
+    bWallArchetypeReady = false;
+    WallMaxHealth = 500.0f;
+    WallMaxLevel = 5;
+    WallZOffset = 0.0f;
+    WallHalfExtent = FVector2D::ZeroVector;
 }
 
 // 开始播放：初始化网格（默认值）
@@ -32,6 +66,8 @@ void AGridManager::GenerateGrid(int32 Width, int32 Height, float CellSize)
     TileSize = CellSize;
     GridNodes.Empty();
     GridNodes.Reserve(Width * Height);
+    CongestionLayer.Reset();
+    SharedPaths.Empty();   // 旧网格上的路径不能再复用 (已发出去的照常走完)
 
     // 按行列生成格子
     for (int32 Y = 0; Y < Height; Y++)
@@ -51,6 +87,8 @@ void AGridManager::GenerateGrid(int32 Width, int32 Height, float CellSize)
             GridNodes.Add(NewNode);
         }
     }
+
+    RefreshWallsAfterGridChange();
 }
 
 // 绘制网格调试可视化：显示格子状态（正常/阻挡/悬停）
@@ -177,6 +215,11 @@ TArray<FVector> AGridManager::FindPath(const FVector& StartWorldLoc, const FVect
 
 
     // A* 算法标准流程 (逻辑不变)
+    ++SearchCount;
+
+    // 拥堵值只在群体管理器的采集阶段更新，搜索期间不会变
+    const FGridCongestion* Congestion = CongestionLayer.Get();
+    const float CongestionWeight = CVarPathCongestionWeight.GetValueOnGameThread();
 
     // 初始化A*算法容器
     TArray<FAStarNode*> OpenList;
@@ -235,7 +278,7 @@ TArray<FVector> AGridManager::FindPath(const FVector& StartWorldLoc, const FVect
             const float MoveCost = FVector::Dist(
                 GridToWorld(CurrentNode->X, CurrentNode->Y),
                 GridToWorld(NeighborPos.X, NeighborPos.Y)
-            ) * GridNodes[NeighborPos.Y * GridWidthCount + NeighborPos.X].Cost;
+            ) * GetTileCost(NeighborPos.Y * GridWidthCount + NeighborPos.X, Congestion, CongestionWeight);
 
             const float NewGCost = CurrentNode->G + MoveCost;
             FAStarNode* NeighborNode = nullptr;
@@ -267,6 +310,200 @@ TArray<FVector> AGridManager::FindPath(const FVector& StartWorldLoc, const FVect
     return Path;
 }
 
+// 共享寻路：先查路径表，没有再跑 A*
+FGridPathRef AGridManager::FindSharedPath(const FVector& StartWorldLoc, const FVector& EndWorldLoc)
+{
+    int32 StartX, StartY, EndX, EndY;
+    if (!WorldToGrid(StartWorldLoc, StartX, StartY) || !WorldToGrid(EndWorldLoc, EndX, EndY))
+    {
+        return nullptr;
+    }
+
+    const uint64 Key = MakePathKey(StartX, StartY, EndX, EndY);
+    if (FGridPathRef Path = FindCachedPath(Key)) return Path;
+
+    TArray<FVector> Points = FindPath(StartWorldLoc, EndWorldLoc);
+    if (Points.Num() == 0) return nullptr;
+
+    return AddSharedPath(Key, MoveTemp(Points));
+}
+
+// 批量寻路：反向 Dijkstra，从终点 (或终点周围可站的格子) 一直扩展到所有起点都被访问
+void AGridManager::FindSharedPathsToGoal(const FVector& EndWorldLoc, const TArray<FVector>& StartWorldLocs, TArray<FGridPathRef>& OutPaths)
+{
+    OutPaths.Reset();
+    OutPaths.SetNum(StartWorldLocs.Num());
+
+    int32 EndX, EndY;
+    if (!WorldToGrid(EndWorldLoc, EndX, EndY)) return;
+
+    // 1. 先查共享路径表，剩下的按起点格子归并
+    TMap<int32, TArray<int32>> PendingByStart;   // 起点格子下标 -> 请求下标
+    for (int32 i = 0; i < StartWorldLocs.Num(); ++i)
+    {
+        int32 StartX, StartY;
+        if (!WorldToGrid(StartWorldLocs[i], StartX, StartY)) continue;
+
+        OutPaths[i] = FindCachedPath(MakePathKey(StartX, StartY, EndX, EndY));
+        if (OutPaths[i].IsValid()) continue;
+
+        // 站在阻挡格子上的起点反向搜不到，单独走 A*
+        if (!IsTileWalkable(StartX, StartY))
+        {
+            OutPaths[i] = FindSharedPath(StartWorldLocs[i], EndWorldLoc);
+            continue;
+        }
+
+        PendingByStart.FindOrAdd(StartY * GridWidthCount + StartX).Add(i);
+    }
+
+    if (PendingByStart.Num() == 0) return;
+
+    // 只剩一个起点，普通 A* 更快
+    if (PendingByStart.Num() == 1)
+    {
+        for (const auto& Pair : PendingByStart)
+        {
+            FGridPathRef Path = FindSharedPath(StartWorldLocs[Pair.Value[0]], EndWorldLoc);
+            for (int32 RequestIndex : Pair.Value) OutPaths[RequestIndex] = Path;
+        }
+        return;
+    }
+
+    // 2. 种子：终点可走就是终点，否则和 FindPath 一样取周围 4 格内可站的格子
+    TArray<int32> Seeds;
+    if (IsTileWalkable(EndX, EndY))
+    {
+        Seeds.Add(EndY * GridWidthCount + EndX);
+    }
+    else
+    {
+        const int32 SearchRadius = 4;
+        for (int32 x = EndX - SearchRadius; x <= EndX + SearchRadius; ++x)
+        {
+            for (int32 y = EndY - SearchRadius; y <= EndY + SearchRadius; ++y)
+            {
+                if (IsTileWalkable(x, y)) Seeds.Add(y * GridWidthCount + x);
+            }
+        }
+    }
+    if (Seeds.Num() == 0) return;
+
+    // 3. 反向 Dijkstra：Next 指向离终点更近的下一格
+    ++SearchCount;
+
+    const FGridCongestion* Congestion = CongestionLayer.Get();
+    const float CongestionWeight = CVarPathCongestionWeight.GetValueOnGameThread();
+
+    const int32 NumTiles = GridWidthCount * GridHeightCount;
+    TArray<float> Dist;
+    TArray<int32> Next;
+    TArray<bool> Closed;
+    Dist.Init(FLT_MAX, NumTiles);
+    Next.Init(INDEX_NONE, NumTiles);
+    Closed.Init(false, NumTiles);
+
+    typedef TPair<float, int32> FOpenEntry;
+    auto OpenLess = [](const FOpenEntry& A, const FOpenEntry& B) { return A.Key < B.Key; };
+    TArray<FOpenEntry> Open;
+    for (int32 Seed : Seeds)
+    {
+        Dist[Seed] = 0.0f;
+        Open.HeapPush(FOpenEntry(0.0f, Seed), OpenLess);
+    }
+
+    int32 RemainingStarts = PendingByStart.Num();
+    while (Open.Num() > 0 && RemainingStarts > 0)
+    {
+        FOpenEntry Current;
+        Open.HeapPop(Current, OpenLess);
+        const int32 Index = Current.Value;
+        if (Closed[Index]) continue;
+        Closed[Index] = true;
+
+        if (PendingByStart.Contains(Index)) --RemainingStarts;
+
+        const int32 X = Index % GridWidthCount;
+        const int32 Y = Index / GridWidthCount;
+        for (const FIntPoint& NeighborPos : GetNeighborNodes(X, Y))
+        {
+            const int32 NeighborIndex = NeighborPos.Y * GridWidthCount + NeighborPos.X;
+            if (Closed[NeighborIndex]) continue;
+
+            // 正向走的是 邻居 -> 当前格，成本按当前格计算 (与 A* 一致)
+            const float MoveCost = FVector::Dist(GridNodes[NeighborIndex].WorldLocation, GridNodes[Index].WorldLocation) * GetTileCost(Index, Congestion, CongestionWeight);
+            const float NewDist = Dist[Index] + MoveCost;
+            if (NewDist < Dist[NeighborIndex])
+            {
+                Dist[NeighborIndex] = NewDist;
+                Next[NeighborIndex] = Index;
+                Open.HeapPush(FOpenEntry(NewDist, NeighborIndex), OpenLess);
+            }
+        }
+    }
+
+    // 4. 沿 Next 走回终点，生成路径并分发
+    for (const auto& Pair : PendingByStart)
+    {
+        const int32 StartIndex = Pair.Key;
+        if (!Closed[StartIndex]) continue; // 到不了
+
+        TArray<FIntPoint> RawPath;
+        for (int32 Index = StartIndex; Index != INDEX_NONE; Index = Next[Index])
+        {
+            RawPath.Add(FIntPoint(Index % GridWidthCount, Index / GridWidthCount));
+        }
+
+        OptimizePath(RawPath);
+        TArray<FVector> Points;
+        for (const FIntPoint& Point : RawPath)
+        {
+            Points.Add(GridToWorld(Point.X, Point.Y));
+        }
+
+        FGridPathRef Path = AddSharedPath(MakePathKey(RawPath[0].X, RawPath[0].Y, EndX, EndY), MoveTemp(Points));
+        for (int32 RequestIndex : Pair.Value) OutPaths[RequestIndex] = Path;
+    }
+}
+
+uint64 AGridManager::MakePathKey(int32 StartX, int32 StartY, int32 EndX, int32 EndY) const
+{
+    return ((uint64)(uint32)(StartY * GridWidthCount + StartX) << 32) | (uint32)(EndY * GridWidthCount + EndX);
+}
+
+FGridPathRef AGridManager::AddSharedPath(uint64 Key, TArray<FVector>&& Points)
+{
+    // 顺手清理已经没人用的条目
+    if (SharedPaths.Num() > 256)
+    {
+        for (auto It = SharedPaths.CreateIterator(); It; ++It)
+        {
+            if (!It->Value.IsValid()) It.RemoveCurrent();
+        }
+    }
+
+    TSharedRef<FGridPath, ESPMode::ThreadSafe> NewPath = MakeShared<FGridPath, ESPMode::ThreadSafe>();
+    NewPath->Points = MoveTemp(Points);
+    NewPath->SearchTime = GetWorld()->GetTimeSeconds();
+    SharedPaths.Add(Key, NewPath);
+    return NewPath;
+}
+
+FGridPathRef AGridManager::FindCachedPath(uint64 Key) const
+{
+    const TWeakPtr<const FGridPath, ESPMode::ThreadSafe>* Existing = SharedPaths.Find(Key);
+    FGridPathRef Path = Existing ? Existing->Pin() : nullptr;
+    if (!Path.IsValid()) return nullptr;
+
+    // 路径是按搜索时的拥堵算的：拥堵开启时只在一小段时间内复用 (同一波请求仍然共享)，之后重新搜索
+    if (CVarPathCongestionWeight.GetValueOnGameThread() > 0.0f &&
+        GetWorld()->GetTimeSeconds() - Path->SearchTime > CVarPathCacheLifetime.GetValueOnGameThread())
+    {
+        return nullptr;
+    }
+    return Path;
+}
+
 // 设置格子阻挡状态：并触发状态变化通知
 void AGridManager::SetTileBlocked(int32 GridX, int32 GridY, bool bBlocked)
 {
@@ -281,6 +518,7 @@ void AGridManager::SetTileBlocked(int32 GridX, int32 GridY, bool bBlocked)
     if (GridNodes[Index].bIsBlocked != bBlocked)
     {
         GridNodes[Index].bIsBlocked = bBlocked;
+        SharedPaths.Empty();                           // 地形变了，旧路径不再复用（已发出去的照常走完）
         OnTileBlockedChanged.Broadcast(GridX, GridY);  // 通知外部（如单位重新寻路）
     }
 
@@ -300,6 +538,32 @@ void AGridManager::SetTileBlocked(int32 GridX, int32 GridY, bool bBlocked)
     //}
 }
 
+void AGridManager::SetTilesBlocked(const TArray<FIntPoint>& Tiles, bool bBlocked)
+{
+    TArray<FIntPoint> ChangedTiles;
+    for (const FIntPoint& Tile : Tiles)
+    {
+        if (!IsTileValid(Tile.X, Tile.Y))
+            continue;
+
+        const int32 Index = Tile.Y * GridWidthCount + Tile.X;
+        if (GridNodes.IsValidIndex(Index) && GridNodes[Index].bIsBlocked != bBlocked)
+        {
+            GridNodes[Index].bIsBlocked = bBlocked;
+            ChangedTiles.Add(Tile);
+        }
+    }
+
+    if (ChangedTiles.Num() == 0)
+        return;
+
+    SharedPaths.Empty();
+    for (const FIntPoint& Tile : ChangedTiles)
+    {
+        OnTileBlockedChanged.Broadcast(Tile.X, Tile.Y);
+    }
+}
+
 // 网格坐标转世界坐标：获取格子中心点
 FVector AGridManager::GridToWorld(int32 GridX, int32 GridY) const
 {
@@ -335,6 +599,27 @@ bool AGridManager::IsTileWalkable(int32 X, int32 Y)
     return GridNodes.IsValidIndex(Index) && !GridNodes[Index].bIsBlocked;
 }
 
+// 检查格子是否被阻挡（越界的格子不算阻挡）
+bool AGridManager::IsTileBlocked(int32 GridX, int32 GridY) const
+{
+    if (!IsTileValid(GridX, GridY))
+        return false;
+
+    const int32 Index = GridY * GridWidthCount + GridX;
+    return GridNodes.IsValidIndex(Index) && GridNodes[Index].bIsBlocked;
+}
+
+// 格子的通行成本：基础成本按拥堵程度放大
+float AGridManager::GetTileCost(int32 Index, const FGridCongestion* Congestion, float CongestionWeight) const
+{
+    float Cost = GridNodes[Index].Cost;
+    if (Congestion && CongestionWeight > 0.0f && Congestion->Width == GridWidthCount && Congestion->Height == GridHeightCount)
+    {
+        Cost *= 1.0f + CongestionWeight * Congestion->Get(Index);
+    }
+    return Cost;
+}
+
 // 计算启发式成本（曼哈顿距离，适合四方向移动）
 float AGridManager::GetHeuristicCost(int32 X1, int32 Y1, int32 X2, int32 Y2) const
 {
@@ -402,6 +687,15 @@ void AGridManager::LoadLevelFromDataAsset(ULevelDataAsset* LevelData)
     {
         SetTileBlocked(Config.GridX, Config.GridY, Config.bIsBlocked);
 
+        // 墙不生成 Actor，直接记在格子上 (关卡里配的墙类顺便作为墙的原型)
+        const ABaseBuilding* Defaults = Config.BuildingClass ? Config.BuildingClass->GetDefaultObject<ABaseBuilding>() : nullptr;
+        if (Defaults && Defaults->BuildingType == EBuildingType::Wall)
+        {
+            if (!WallClass) WallClass = Config.BuildingClass;
+            AddWall(Config.GridX, Config.GridY, ETeam::Enemy, Config.BuildingLevel);
+            continue;
+        }
+
         // 生成建筑实例（若配置了建筑类）
         if (Config.BuildingClass)
         {
@@ -465,4 +759,196 @@ void AGridManager::LoadLevelFromDataAsset(ULevelDataAsset* LevelData)
             }
         }
     }
-}
\ No newline at end of file
+}
+
+bool AGridManager::EnsureWallArchetype()
+{
+    if (bWallArchetypeReady) return true;
+    if (!WallClass) return false;
+
+    const ABaseBuilding* Defaults = WallClass->GetDefaultObject<ABaseBuilding>();
+    WallMaxHealth = Defaults->MaxHealth;
+    WallMaxLevel = Defaults->MaxLevel;
+
+    // 与原来生成墙 Actor 时一样抬高半个包围盒
+    FVector Origin, BoxExtent;
+    Defaults->GetActorBounds(true, Origin, BoxExtent);
+    WallZOffset = BoxExtent.Z;
+
+    // 网格体、材质、相对变换照搬蓝图里的模型
+    WallHalfExtent = FVector2D(TileSize * 0.5f, TileSize * 0.5f);
+    const UStaticMeshComponent* DefaultMesh = Defaults->MeshComp;
+    if (DefaultMesh && DefaultMesh->GetStaticMesh())
+    {
+        WallInstances->SetStaticMesh(DefaultMesh->GetStaticMesh());
+        for (int32 Index = 0; Index < DefaultMesh->GetNumMaterials(); ++Index)
+        {
+            WallInstances->SetMaterial(Index, DefaultMesh->GetMaterial(Index));
+        }
+        WallMeshTransform = DefaultMesh->GetRelativeTransform();
+        WallHalfExtent = FVector2D(DefaultMesh->GetStaticMesh()->GetBoundingBox().TransformBy(WallMeshTransform).GetExtent());
+    }
+
+    bWallArchetypeReady = true;
+    return true;
+}
+
+FVector AGridManager::GetWallLocation(int32 GridX, int32 GridY) const
+{
+    return GridToWorld(GridX, GridY) + FVector(0.0f, 0.0f, WallZOffset);
+}
+
+int32 AGridManager::AddWall(int32 GridX, int32 GridY, ETeam Team, int32 Level)
+{
+    if (!IsTileValid(GridX, GridY) || GetWallAt(GridX, GridY) != INDEX_NONE) return INDEX_NONE;
+
+    if (!EnsureWallArchetype())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("[Grid] WallClass not set, cannot place wall at (%d, %d)"), GridX, GridY);
+        return INDEX_NONE;
+    }
+
+    FGridWall NewWall;
+    NewWall.Tile = FIntPoint(GridX, GridY);
+    NewWall.Location = GetWallLocation(GridX, GridY);
+    NewWall.Team = Team;
+    NewWall.Level = FMath::Clamp(Level, 1, FMath::Max(1, WallMaxLevel));
+    NewWall.MaxHealth = WallMaxHealth * FMath::Pow(1.2f, NewWall.Level - 1);
+    NewWall.Health = NewWall.MaxHealth;
+
+    const int32 WallIndex = Walls.Add(NewWall);
+    FGridWall& Wall = Walls[WallIndex];
+
+    // 新实例总是加在末尾
+    Wall.InstanceIndex = WallInstances->AddInstanceWorldSpace(WallMeshTransform * FTransform(Wall.Location));
+    WallInstanceOwners.Add(WallIndex);
+
+    WallIndexByTile[GridY * GridWidthCount + GridX] = WallIndex;
+    SetTileBlocked(GridX, GridY, true);
+
+    // 作为可攻击的目标登记到注册表
+    if (ACrowdManager* CrowdManager = ACrowdManager::Get(this))
+    {
+        Wall.Handle = CrowdManager->RegisterWall(this, WallIndex);
+    }
+    return WallIndex;
+}
+
+void AGridManager::RemoveWall(int32 WallIndex, bool bUnblockTile)
+{
+    if (!Walls.IsValidIndex(WallIndex)) return;
+
+    const FGridWall Wall = Walls[WallIndex];
+
+    // 先让句柄失效：锁定它的单位、飞行中的子弹之后都解析不到
+    if (ACrowdManager* CrowdManager = ACrowdManager::Get(this))
+    {
+        CrowdManager->ReleaseHandle(Wall.Handle);
+    }
+
+    // HISM 删除实例时会把最后一个实例挪到被删的位置，记录跟着挪
+    if (Wall.InstanceIndex != INDEX_NONE && WallInstanceOwners.IsValidIndex(Wall.InstanceIndex))
+    {
+        WallInstances->RemoveInstance(Wall.InstanceIndex);
+
+        const int32 LastInstance = WallInstanceOwners.Num() - 1;
+        if (Wall.InstanceIndex != LastInstance)
+        {
+            const int32 MovedWall = WallInstanceOwners[LastInstance];
+            WallInstanceOwners[Wall.InstanceIndex] = MovedWall;
+            Walls[MovedWall].InstanceIndex = Wall.InstanceIndex;
+        }
+        WallInstanceOwners.Pop(false);
+    }
+
+    const int32 TileIndex = Wall.Tile.Y * GridWidthCount + Wall.Tile.X;
+    if (WallIndexByTile.IsValidIndex(TileIndex) && WallIndexByTile[TileIndex] == WallIndex)
+    {
+        WallIndexByTile[TileIndex] = INDEX_NONE;
+    }
+    Walls.RemoveAt(WallIndex);
+
+    if (bUnblockTile) SetTileBlocked(Wall.Tile.X, Wall.Tile.Y, false);
+}
+
+bool AGridManager::DamageWall(int32 WallIndex, float Damage, bool bUnblockTile)
+{
+    FGridWall* Wall = GetWall(WallIndex);
+    if (!Wall || Damage <= 0.0f) return false;
+
+    Wall->Health -= Damage;
+    if (Wall->Health > 0.0f) return false;
+
+    UE_LOG(LogTemp, Log, TEXT("[Grid] Wall at (%d, %d) destroyed"), Wall->Tile.X, Wall->Tile.Y);
+    if (WallDestroyedVFX)
+    {
+        UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), WallDestroyedVFX, Wall->Location);
+    }
+
+    RemoveWall(WallIndex, bUnblockTile);
+    return true;
+}
+
+bool AGridManager::UpgradeWall(int32 WallIndex)
+{
+    FGridWall* Wall = GetWall(WallIndex);
+    if (!Wall || Wall->Level >= WallMaxLevel) return false;
+
+    ++Wall->Level;
+    Wall->MaxHealth *= 1.2f;
+    Wall->Health = Wall->MaxHealth;
+    return true;
+}
+
+bool AGridManager::GetWallUpgradeCost(int32 WallIndex, int32& OutGold, int32& OutElixir) const
+{
+    const FGridWall* Wall = GetWall(WallIndex);
+    if (!Wall || !WallClass || Wall->Level >= WallMaxLevel) return false;
+
+    WallClass->GetDefaultObject<ABaseBuilding>()->GetUpgradeCostForLevel(Wall->Level, OutGold, OutElixir);
+    return true;
+}
+
+int32 AGridManager::GetWallAt(int32 GridX, int32 GridY) const
+{
+    if (!IsTileValid(GridX, GridY)) return INDEX_NONE;
+
+    const int32 TileIndex = GridY * GridWidthCount + GridX;
+    return WallIndexByTile.IsValidIndex(TileIndex) ? WallIndexByTile[TileIndex] : INDEX_NONE;
+}
+
+int32 AGridManager::GetWallFromHit(const FHitResult& Hit) const
+{
+    // 打到实例化网格体时 Item 就是实例下标
+    if (Hit.GetComponent() != WallInstances || !WallInstanceOwners.IsValidIndex(Hit.Item)) return INDEX_NONE;
+    return WallInstanceOwners[Hit.Item];
+}
+
+void AGridManager::RefreshWallsAfterGridChange()
+{
+    WallIndexByTile.Init(INDEX_NONE, GridWidthCount * GridHeightCount);
+
+    TArray<int32> OutOfGrid;
+    for (auto It = Walls.CreateIterator(); It; ++It)
+    {
+        FGridWall& Wall = *It;
+        const int32 TileIndex = Wall.Tile.Y * GridWidthCount + Wall.Tile.X;
+        if (!IsTileValid(Wall.Tile.X, Wall.Tile.Y) || WallIndexByTile[TileIndex] != INDEX_NONE)
+        {
+            OutOfGrid.Add(It.GetIndex());
+            continue;
+        }
+
+        // 网格刚重建，不用走 SetTileBlocked 的通知
+        WallIndexByTile[TileIndex] = It.GetIndex();
+        GridNodes[TileIndex].bIsBlocked = true;
+
+        Wall.Location = GetWallLocation(Wall.Tile.X, Wall.Tile.Y);
+        WallInstances->UpdateInstanceTransform(Wall.InstanceIndex, WallMeshTransform * FTransform(Wall.Location), true, true, true);
+    }
+
+    for (int32 WallIndex : OutOfGrid)
+    {
+        RemoveWall(WallIndex, false);
+    }
+}
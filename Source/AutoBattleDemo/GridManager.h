@@ -2,10 +2,13 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "BaseBuilding.h"
+#include "GridCongestion.h"
+#include "EntityHandle.h"
 #include "GridManager.generated.h"
 // 前向声明
 class ULevelDataAsset;
 class ABaseBuilding;
+class UHierarchicalInstancedStaticMeshComponent;
 
 USTRUCT(BlueprintType)
 struct FGridNode
@@ -24,6 +27,31 @@ struct FGridNode
         float Cost;               // 寻路成本（如地形权重）
 };
 
+// 不可变的共享路径：起终点格子相同的单位共用一份，发给单位只是一次指针拷贝
+struct FGridPath
+{
+    TArray<FVector> Points;   // 格子中心点 (不含抖动，抖动由单位在采样时叠加)
+    float SearchTime = 0.0f;  // 搜出这条路径的时间 (按当时的拥堵算的，过期后不再复用)
+};
+typedef TSharedPtr<const FGridPath, ESPMode::ThreadSafe> FGridPathRef;
+
+// 墙：只是格子上的一条数据，不生成 Actor，所有墙由同一个 HISM 绘制
+// 注册表 (ACrowdManager) 给每段墙发一个句柄，单位按句柄锁定、攻击，和建筑一样走伤害队列
+struct FGridWall
+{
+    FIntPoint Tile = FIntPoint(INDEX_NONE, INDEX_NONE);
+    FVector Location = FVector::ZeroVector;   // 实例的位置 (选目标、瞄准用)
+    ETeam Team = ETeam::Enemy;
+    int32 Level = 1;
+    float Health = 0.0f;
+    float MaxHealth = 0.0f;
+    float PendingDamage = 0.0f;               // 伤害预约 (同 ABaseGameEntity)
+    int32 InstanceIndex = INDEX_NONE;         // 在 HISM 里的实例下标 (删除其他实例时会变)
+    FEntityHandle Handle;
+
+    float GetPredictedHealth() const { return Health - PendingDamage; }
+};
+
 // 格子阻挡状态变化委托（供单位重新寻路）
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnTileBlockedChanged, int32 /*GridX*/, int32 /*GridY*/);
 
@@ -49,14 +77,61 @@ public:
         void GenerateGrid(int32 Width, int32 Height, float CellSize); // 生成网格数据
     UFUNCTION(BlueprintCallable, Category = "Grid")
         TArray<FVector> FindPath(const FVector& StartWorldLoc, const FVector& EndWorldLoc); // 寻路算法
+    // 共享寻路：同一对起终点格子只搜索、只存储一次 (阻挡变化后失效)
+    FGridPathRef FindSharedPath(const FVector& StartWorldLoc, const FVector& EndWorldLoc);
+
+    // 批量寻路：多个起点去同一个终点时，从终点反向搜索一次，结果分给所有起点
+    void FindSharedPathsToGoal(const FVector& EndWorldLoc, const TArray<FVector>& StartWorldLocs, TArray<FGridPathRef>& OutPaths);
+
+    // 累计实际执行的搜索次数 (A* 和反向搜索，命中共享路径不算)
+    int32 GetSearchCount() const { return SearchCount; }
     UFUNCTION(BlueprintCallable, Category = "Grid")
         void SetTileBlocked(int32 GridX, int32 GridY, bool bBlocked); // 设置格子阻挡状态（名称不变）
+
+    // 批量设置阻挡 (比如一次爆炸炸掉好几段墙)：共享路径只清一次，只通知真正变化的格子
+    void SetTilesBlocked(const TArray<FIntPoint>& Tiles, bool bBlocked);
     UFUNCTION(BlueprintCallable, Category = "Grid")
         FVector GridToWorld(int32 GridX, int32 GridY) const;          // 网格坐标转世界坐标
     UFUNCTION(BlueprintCallable, Category = "Grid")
         bool WorldToGrid(const FVector& WorldLoc, int32& OutGridX, int32& OutGridY) const; // 世界坐标转网格坐标
     UFUNCTION(BlueprintCallable, Category = "Grid")
         void DrawGridVisuals(int32 HoverX, int32 HoverY);             // 绘制网格调试 visuals
+
+    // 只读访问（群体管理器每帧拷贝阻挡信息用）
+    int32 GetGridWidth() const { return GridWidthCount; }
+    int32 GetGridHeight() const { return GridHeightCount; }
+    float GetTileSize() const { return TileSize; }
+    bool IsTileBlocked(int32 GridX, int32 GridY) const;             // 越界视为不阻挡
+
+    // 拥堵层 (群体管理器每帧更新)，rts.Path.CongestionWeight > 0 时叠加到寻路成本上
+    FGridCongestionLayer& GetCongestionLayer() { return CongestionLayer; }
+
+    // --- 墙 (格子数据 + 实例化绘制) ---
+    // 在格子上放一段墙并阻挡格子，返回墙的下标 (格子无效/已有墙时返回 INDEX_NONE)
+    int32 AddWall(int32 GridX, int32 GridY, ETeam Team, int32 Level = 1);
+
+    // 移除一段墙；bUnblockTile 为 false 时由调用方批量解除阻挡 (SetTilesBlocked)
+    void RemoveWall(int32 WallIndex, bool bUnblockTile = true);
+
+    // 扣血 (伤害队列结算时调用)，打爆了就移除并返回 true
+    bool DamageWall(int32 WallIndex, float Damage, bool bUnblockTile = true);
+
+    // 升级：和 ABaseBuilding 一样每级血量 x1.2 并回满
+    bool UpgradeWall(int32 WallIndex);
+
+    // 下一级的费用 (按 WallClass 的升级配置)，已满级时返回 false
+    bool GetWallUpgradeCost(int32 WallIndex, int32& OutGold, int32& OutElixir) const;
+
+    // 格子上的墙 / 射线打到的墙 (没有时返回 INDEX_NONE)
+    int32 GetWallAt(int32 GridX, int32 GridY) const;
+    int32 GetWallFromHit(const FHitResult& Hit) const;
+
+    FGridWall* GetWall(int32 WallIndex) { return Walls.IsValidIndex(WallIndex) ? &Walls[WallIndex] : nullptr; }
+    const FGridWall* GetWall(int32 WallIndex) const { return Walls.IsValidIndex(WallIndex) ? &Walls[WallIndex] : nullptr; }
+    const TSparseArray<FGridWall>& GetWalls() const { return Walls; }
+
+    // 墙的水平半尺寸 (快照里的碰撞包围盒)
+    FVector2D GetWallHalfExtent() const { return WallHalfExtent; }
     // 新增：玩家大本营建筑类（在蓝图中指定具体类型）
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Level Setup")
         TSubclassOf<ABaseBuilding> PlayerBaseClass;
@@ -64,6 +139,18 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Level Setup")
         TSubclassOf<ABaseBuilding> EnemyBaseClass;
 
+    // 墙的原型：只读它的网格体、血量和升级配置，不会生成这个类的 Actor
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Level Setup")
+        TSubclassOf<ABaseBuilding> WallClass;
+
+    // 墙被打爆时的特效 (原来由 BP_Wall 的死亡事件播放)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Level Setup")
+        class UParticleSystem* WallDestroyedVFX;
+
+    // 所有墙共用的实例化网格体
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+        UHierarchicalInstancedStaticMeshComponent* WallInstances;
+
         // 阻挡状态变化通知（供外部绑定，如单位重新寻路）
     FOnTileBlockedChanged OnTileBlockedChanged;
 
@@ -88,6 +175,24 @@ private:
     TArray<FIntPoint> GetNeighborNodes(int32 X, int32 Y) const; // 获取邻居节点
     void OptimizePath(TArray<FIntPoint>& RawPath);           // 优化路径点（减少冗余节点）
 
+    // 共享路径表的键：(起点格子, 终点格子)
+    uint64 MakePathKey(int32 StartX, int32 StartY, int32 EndX, int32 EndY) const;
+
+    // 进入格子的成本倍率：地形成本 * (1 + 权重 * 拥堵)
+    float GetTileCost(int32 Index, const FGridCongestion* Congestion, float CongestionWeight) const;
+    FGridPathRef AddSharedPath(uint64 Key, TArray<FVector>&& Points);
+
+    // 查共享路径表：没有、没人在用、或者拥堵开启时超过 rts.Path.CacheLifetime 的返回空
+    FGridPathRef FindCachedPath(uint64 Key) const;
+
+    // 从 WallClass 的默认对象读出网格体、血量、尺寸 (第一次放墙时)
+    bool EnsureWallArchetype();
+
+    // 重新生成网格后：还在网格内的墙重新阻挡、重新摆放，出界的移除
+    void RefreshWallsAfterGridChange();
+
+    FVector GetWallLocation(int32 GridX, int32 GridY) const;
+
     // 网格数据存储
     UPROPERTY()
         TArray<FGridNode> GridNodes;       // 扁平化存储的网格节点数组
@@ -99,4 +204,25 @@ private:
         float TileSize;                    // 单个格子的尺寸（世界单位）
     UPROPERTY(EditAnywhere, Category = "Debug")
         bool bDrawDebug;                   // 是否绘制调试信息
+
+    // 共享路径表：(起点格子, 终点格子) -> 路径，只持有弱引用，没有单位在用时自动释放
+    TMap<uint64, TWeakPtr<const FGridPath, ESPMode::ThreadSafe>> SharedPaths;
+
+    // 动态拥堵 (不影响阻挡；共享路径按 rts.Path.CacheLifetime 过期，让新的拥堵生效)
+    FGridCongestionLayer CongestionLayer;
+
+    int32 SearchCount;
+
+    // --- 墙 ---
+    TSparseArray<FGridWall> Walls;
+    TArray<int32> WallIndexByTile;      // 格子 -> 墙下标
+    TArray<int32> WallInstanceOwners;   // HISM 实例下标 -> 墙下标
+
+    // 墙的原型数据 (EnsureWallArchetype 填写)
+    bool bWallArchetypeReady;
+    float WallMaxHealth;
+    int32 WallMaxLevel;
+    float WallZOffset;
+    FTransform WallMeshTransform;
+    FVector2D WallHalfExtent;
 };
\ No newline at end of file
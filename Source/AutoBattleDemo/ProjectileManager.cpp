@@ -0,0 +1,282 @@
+#include "ProjectileManager.h"
+#include "WorldSingleton.h"
+#include "RTSProjectile.h"
+#include "BaseGameEntity.h"
+#include "CrowdManager.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Update"), STAT_ProjectileUpdate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_Game);
+
+void FProjectileBatch::Add(const FVector& Start, const FVector& AimPoint, float LaunchTime, float ImpactTime)
+{
+    Starts.Add(Start);
+    AimPoints.Add(AimPoint);
+    LaunchTimes.Add(LaunchTime);
+    ImpactTimes.Add(ImpactTime);
+}
+
+void FProjectileBatch::RemoveAtSwap(int32 Index)
+{
+    Starts.RemoveAtSwap(Index, 1, false);
+    AimPoints.RemoveAtSwap(Index, 1, false);
+    LaunchTimes.RemoveAtSwap(Index, 1, false);
+    ImpactTimes.RemoveAtSwap(Index, 1, false);
+}
+
+AProjectileManager::AProjectileManager()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    USceneComponent* SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+    RootComponent = SceneRoot;
+
+    MaxLifeTime = 5.0f;
+    HitRadius = 50.0f;
+    CrowdManagerRef = nullptr;
+    bReducedFidelity = false;
+}
+
+AProjectileManager* AProjectileManager::Get(const UObject* WorldContextObject)
+{
+    return TWorldSingleton<AProjectileManager>::Get(WorldContextObject);
+}
+
+void AProjectileManager::BeginPlay()
+{
+    Super::BeginPlay();
+    ImpactWheel.Start(GetWorld()->GetTimeSeconds());
+
+    // 先于群体管理器 Tick：本帧命中的伤害赶上本帧的伤害结算
+    CrowdManagerRef = ACrowdManager::Get(this);
+    if (CrowdManagerRef) CrowdManagerRef->AddTickPrerequisiteActor(this);
+}
+
+float AProjectileManager::SolveTimeToImpact(const FVector& Start, const FVector& TargetLocation, const FVector& TargetVelocity, float Speed)
+{
+    // |D + V*t| = Speed*t  =>  (V.V - S^2) t^2 + 2 (D.V) t + D.D = 0，取最小的正根
+    const FVector D = TargetLocation - Start;
+    const float A = TargetVelocity.SizeSquared() - Speed * Speed;
+    const float B = 2.0f * FVector::DotProduct(D, TargetVelocity);
+    const float C = D.SizeSquared();
+    const float DirectTime = FMath::Sqrt(C) / Speed;
+
+    if (FMath::IsNearlyZero(A))
+    {
+        // 目标和子弹一样快：只有迎面来时追得上
+        return (B < 0.0f) ? -C / B : DirectTime;
+    }
+
+    const float Discriminant = B * B - 4.0f * A * C;
+    if (Discriminant < 0.0f) return DirectTime;
+
+    const float Root = FMath::Sqrt(Discriminant);
+    const float T1 = (-B - Root) / (2.0f * A);
+    const float T2 = (-B + Root) / (2.0f * A);
+    const float Best = (T1 > 0.0f && T2 > 0.0f) ? FMath::Min(T1, T2) : FMath::Max(T1, T2);
+    return (Best > 0.0f) ? Best : DirectTime;
+}
+
+void AProjectileManager::Launch(TSubclassOf<ARTSProjectile> Type, const FVector& Start, ABaseGameEntity* Target, float Damage, AActor* DamageInstigator)
+{
+    if (Target) Launch(Type, Start, Target->GetEntityHandle(), Damage, DamageInstigator);
+}
+
+void AProjectileManager::Launch(TSubclassOf<ARTSProjectile> Type, const FVector& Start, const FEntityHandle& Target, float Damage, AActor* DamageInstigator)
+{
+    if (!CrowdManagerRef) CrowdManagerRef = ACrowdManager::Get(this);
+
+    FVector TargetLocation;
+    ETeam TargetTeam = ETeam::Enemy;
+    if (!IsValid(CrowdManagerRef) || !CrowdManagerRef->GetTargetLocation(Target, TargetLocation, &TargetTeam)) return;
+
+    FProjectileBatch* Batch = FindOrAddBatch(Type);
+    if (!Batch) return;
+
+    // 预约伤害：别的射手看到它的预测血量 <= 0 就不再往它身上浪费子弹
+    CrowdManagerRef->ReservePendingDamage(Target, Damage);
+
+    // 拦截点按目标现在的速度外推，命中半径内就算打中 (墙不会动)
+    const ABaseGameEntity* TargetEntity = CrowdManagerRef->ResolveHandle(Target);
+    const FVector TargetVelocity = TargetEntity ? TargetEntity->GetVelocity() : FVector::ZeroVector;
+    const float InterceptTime = SolveTimeToImpact(Start, TargetLocation, TargetVelocity, Batch->Speed);
+    const FVector AimPoint = TargetLocation + TargetVelocity * InterceptTime;
+    const float FlightTime = FMath::Clamp(InterceptTime - HitRadius / Batch->Speed, 0.0f, MaxLifeTime);
+
+    const float Now = GetWorld()->GetTimeSeconds();
+    Batch->Add(Start, AimPoint, Now, Now + FlightTime);
+
+    FProjectileImpact Impact;
+    Impact.Target = Target;
+    Impact.Damage = Damage;
+    Impact.Instigator = DamageInstigator;
+    Impact.SplashRadius = Batch->SplashRadius;
+    Impact.SplashFalloff = Batch->SplashFalloff;
+    Impact.AimPoint = AimPoint;
+    if (const ABaseGameEntity* Source = Cast<ABaseGameEntity>(DamageInstigator)) Impact.SourceTeam = Source->TeamID;
+    else Impact.SourceTeam = (TargetTeam == ETeam::Player) ? ETeam::Enemy : ETeam::Player;
+    ImpactWheel.Schedule(Now + FlightTime, Impact);
+
+    CrowdManagerRef->NoteProjectileSpawned();
+}
+
+FProjectileBatch* AProjectileManager::FindOrAddBatch(TSubclassOf<ARTSProjectile> Type)
+{
+    UClass* Class = Type.Get();
+    if (!Class) return nullptr;
+
+    const int32 Existing = BatchTypes.IndexOfByKey(Class);
+    if (Existing != INDEX_NONE) return &Batches[Existing];
+
+    // 第一次发射这种子弹：按类默认对象的网格体和速度建一个实例化网格体
+    const ARTSProjectile* Defaults = Class->GetDefaultObject<ARTSProjectile>();
+    const UStaticMeshComponent* DefaultMesh = Defaults->GetMeshComponent();
+
+    UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(this);
+    Instances->SetupAttachment(RootComponent);
+    Instances->SetMobility(EComponentMobility::Movable);
+    Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Instances->SetCastShadow(!bReducedFidelity);
+    if (DefaultMesh)
+    {
+        Instances->SetStaticMesh(DefaultMesh->GetStaticMesh());
+        for (int32 Index = 0; Index < DefaultMesh->GetNumMaterials(); ++Index)
+        {
+            Instances->SetMaterial(Index, DefaultMesh->GetMaterial(Index));
+        }
+    }
+    Instances->RegisterComponent();
+
+    BatchTypes.Add(Class);
+    BatchComponents.Add(Instances);
+
+    FProjectileBatch& Batch = Batches.AddDefaulted_GetRef();
+    Batch.Instances = Instances;
+    Batch.MeshTransform = DefaultMesh ? DefaultMesh->GetRelativeTransform() : FTransform::Identity;
+    Batch.Speed = Defaults->GetSpeed();
+    Batch.SplashRadius = Defaults->GetSplashRadius();
+    Batch.SplashFalloff = Defaults->GetSplashFalloff();
+    return &Batch;
+}
+
+void AProjectileManager::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    SCOPE_CYCLE_COUNTER(STAT_ProjectileUpdate);
+
+    if (!IsValid(CrowdManagerRef)) CrowdManagerRef = ACrowdManager::Get(this);
+
+    // 降级时关掉子弹阴影 (只在切换时设置)
+    const bool bReduced = CrowdManagerRef && CrowdManagerRef->ShouldReduceProjectileFidelity();
+    if (bReduced != bReducedFidelity)
+    {
+        bReducedFidelity = bReduced;
+        for (UInstancedStaticMeshComponent* Instances : BatchComponents)
+        {
+            if (Instances) Instances->SetCastShadow(!bReducedFidelity);
+        }
+    }
+
+    const float Now = GetWorld()->GetTimeSeconds();
+    ResolveImpacts(Now);
+
+    for (FProjectileBatch& Batch : Batches)
+    {
+        UpdateInstances(Batch, Now);
+    }
+
+    SET_DWORD_STAT(STAT_ProjectilesInFlight, GetNumProjectiles());
+}
+
+void AProjectileManager::ResolveImpacts(float Now)
+{
+    FiredImpacts.Reset();
+    ImpactWheel.Advance(Now, FiredImpacts);
+
+    for (const TTimerWheel<FProjectileImpact>::FEntry& Entry : FiredImpacts)
+    {
+        const FProjectileImpact& Impact = Entry.Payload;
+
+        // 先归还预约 (目标在飞行途中死了的话句柄已经失效，查不到位置)
+        FVector TargetLocation;
+        const bool bTargetAlive = IsValid(CrowdManagerRef) && CrowdManagerRef->GetTargetLocation(Impact.Target, TargetLocation);
+        if (bTargetAlive) CrowdManagerRef->ReleasePendingDamage(Impact.Target, Impact.Damage);
+
+        // 溅射：目标本身也在范围中心，一起交给范围伤害结算 (目标死了照样落在拦截点上炸开)
+        if (Impact.SplashRadius > 0.0f && IsValid(CrowdManagerRef))
+        {
+            FRadialDamageParams Params;
+            Params.Center = bTargetAlive ? TargetLocation : Impact.AimPoint;
+            Params.Radius = Impact.SplashRadius;
+            Params.BaseDamage = Impact.Damage;
+            Params.Falloff = Impact.SplashFalloff;
+            Params.TeamMask = FRadialDamageParams::EnemiesOf(Impact.SourceTeam);
+            CrowdManagerRef->ApplyRadialDamage(Params, Impact.Instigator.Get());
+            continue;
+        }
+
+        // 单体：目标没了这发就作废
+        if (!bTargetAlive)
+        {
+            if (IsValid(CrowdManagerRef)) CrowdManagerRef->NoteProjectileWasted();
+            continue;
+        }
+
+        // 排进伤害队列，和近战伤害一起在群体管理器的帧末结算
+        CrowdManagerRef->QueueDamage(Impact.Target, Impact.Damage, Impact.Instigator.Get());
+    }
+}
+
+void AProjectileManager::UpdateInstances(FProjectileBatch& Batch, float Now)
+{
+    // 到点的子弹删掉 (伤害由时间轮结算，这里只管表现)
+    for (int32 i = Batch.Num() - 1; i >= 0; --i)
+    {
+        if (Now >= Batch.ImpactTimes[i]) Batch.RemoveAtSwap(i);
+    }
+
+    UInstancedStaticMeshComponent* Instances = Batch.Instances;
+    if (!Instances) return;
+
+    // 实例数跟着子弹数走，只在末尾增删
+    const int32 Num = Batch.Num();
+    while (Instances->GetInstanceCount() > Num)
+    {
+        Instances->RemoveInstance(Instances->GetInstanceCount() - 1);
+    }
+    while (Instances->GetInstanceCount() < Num)
+    {
+        Instances->AddInstance(FTransform::Identity);
+    }
+    if (Num == 0) return;
+
+    // 沿发射点到拦截点直线插值，朝向就是飞行方向
+    InstanceTransforms.Reset(Num);
+    for (int32 i = 0; i < Num; ++i)
+    {
+        const float Duration = Batch.ImpactTimes[i] - Batch.LaunchTimes[i];
+        const float Alpha = (Duration > KINDA_SMALL_NUMBER) ? FMath::Clamp((Now - Batch.LaunchTimes[i]) / Duration, 0.0f, 1.0f) : 1.0f;
+        const FVector Direction = Batch.AimPoints[i] - Batch.Starts[i];
+        const FTransform Flight(Direction.Rotation(), FMath::Lerp(Batch.Starts[i], Batch.AimPoints[i], Alpha));
+        InstanceTransforms.Add(Batch.MeshTransform * Flight);
+    }
+    Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, true);
+}
+
+void AProjectileManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 还没结算的命中把预约还回去 (目标可能还活着)
+    TArray<TTimerWheel<FProjectileImpact>::FEntry> Pending;
+    ImpactWheel.Drain(Pending);
+    for (const TTimerWheel<FProjectileImpact>::FEntry& Entry : Pending)
+    {
+        if (IsValid(CrowdManagerRef)) CrowdManagerRef->ReleasePendingDamage(Entry.Payload.Target, Entry.Payload.Damage);
+    }
+    Batches.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
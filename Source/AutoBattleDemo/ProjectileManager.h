@@ -0,0 +1,108 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "EntityHandle.h"
+#include "RTSCoreTypes.h"
+#include "TimerWheel.h"
+#include "ProjectileManager.generated.h"
+
+class ARTSProjectile;
+class ABaseGameEntity;
+class UInstancedStaticMeshComponent;
+
+// 同一类型 (同一个子弹蓝图) 的所有子弹：只剩表现用的数据 (SoA)，下标一一对应
+// 飞行轨迹在发射时就定好了，每帧只是按时间插值出变换
+struct FProjectileBatch
+{
+    UInstancedStaticMeshComponent* Instances = nullptr;   // 由 AProjectileManager::BatchComponents 持有
+    FTransform MeshTransform;                             // 蓝图里网格体的相对变换 (缩放/朝向修正)
+    float Speed = 1000.0f;
+    float SplashRadius = 0.0f;
+    float SplashFalloff = 0.0f;
+
+    TArray<FVector> Starts;
+    TArray<FVector> AimPoints;       // 发射时解出的拦截点
+    TArray<float> LaunchTimes;
+    TArray<float> ImpactTimes;
+
+    int32 Num() const { return Starts.Num(); }
+    void Add(const FVector& Start, const FVector& AimPoint, float LaunchTime, float ImpactTime);
+    void RemoveAtSwap(int32 Index);
+};
+
+// 命中结算：挂在时间轮上，在预测的命中时刻造成伤害
+struct FProjectileImpact
+{
+    FEntityHandle Target;
+    float Damage = 0.0f;                 // 同时也是在目标身上预约的伤害
+    TWeakObjectPtr<AActor> Instigator;
+
+    // 溅射 (SplashRadius > 0)：以命中时目标的位置为中心，伤害 SourceTeam 的敌人
+    float SplashRadius = 0.0f;
+    float SplashFalloff = 0.0f;
+    FVector AimPoint = FVector::ZeroVector;   // 目标先死了就落在拦截点上
+    ETeam SourceTeam = ETeam::Player;
+};
+
+UCLASS()
+class AUTOBATTLEDEMO_API AProjectileManager : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AProjectileManager();
+
+    virtual void BeginPlay() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // 获取当前世界的管理器（没有则自动生成一个，之后按 World 缓存，见 WorldSingleton.h）
+    static AProjectileManager* Get(const UObject* WorldContextObject);
+
+    // 发射一发子弹：在目标身上预约伤害，命中时由 DamageInstigator 造成伤害
+    void Launch(TSubclassOf<ARTSProjectile> Type, const FVector& Start, ABaseGameEntity* Target, float Damage, AActor* DamageInstigator);
+    // 按句柄发射 (墙没有 Actor，位置和阵营从群体管理器查)
+    void Launch(TSubclassOf<ARTSProjectile> Type, const FVector& Start, const FEntityHandle& Target, float Damage, AActor* DamageInstigator);
+
+    int32 GetNumProjectiles() const { return ImpactWheel.Num(); }
+
+    // 拦截解算：速度为 Speed 的子弹从 Start 出发，打到位于 TargetLocation、速度为 TargetVelocity 的目标需要的时间
+    // 追不上时返回按目标当前位置算的直线飞行时间
+    static float SolveTimeToImpact(const FVector& Start, const FVector& TargetLocation, const FVector& TargetVelocity, float Speed);
+
+protected:
+    // 子弹最长飞行时间 (解出来的命中时间不会超过它)
+    UPROPERTY(EditAnywhere, Category = "Projectile")
+        float MaxLifeTime;
+
+    // 命中半径：子弹飞到离目标中心这么近就算命中 (命中时间相应提前)
+    UPROPERTY(EditAnywhere, Category = "Projectile")
+        float HitRadius;
+
+private:
+    FProjectileBatch* FindOrAddBatch(TSubclassOf<ARTSProjectile> Type);
+    void ResolveImpacts(float Now);
+    void UpdateInstances(FProjectileBatch& Batch, float Now);
+
+    UPROPERTY()
+        class ACrowdManager* CrowdManagerRef;
+
+    // 每种子弹一个实例化网格体 (下标与 Batches 对应)
+    UPROPERTY()
+        TArray<UInstancedStaticMeshComponent*> BatchComponents;
+
+    UPROPERTY()
+        TArray<UClass*> BatchTypes;
+
+    TArray<FProjectileBatch> Batches;
+
+    // 所有待结算的命中，按命中时刻排队
+    TTimerWheel<FProjectileImpact> ImpactWheel;
+
+    // 降级时关掉子弹阴影
+    bool bReducedFidelity;
+
+    // 复用的缓冲
+    TArray<FTransform> InstanceTransforms;
+    TArray<TTimerWheel<FProjectileImpact>::FEntry> FiredImpacts;
+};
@@ -15,13 +15,13 @@ public:
 	virtual void NativeConstruct() override;
 
 protected:
-	// --- սֻҪ⼸ؼ ---
+	// --- 战斗界面只需要这几个控件 ---
 
 	UPROPERTY(meta = (BindWidget))
-		UButton* Btn_Retreat; // ˰ť
+		UButton* Btn_Retreat; // 撤退按钮
 
 	//UPROPERTY(meta = (BindWidget))
-	//	UTextBlock* Text_TimeInfo; // (ѡ) ʱ
+	//	UTextBlock* Text_TimeInfo; // (可选) 倒计时
 
 	UFUNCTION()
 		void OnClickRetreat();
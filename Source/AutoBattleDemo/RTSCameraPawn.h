@@ -15,7 +15,7 @@ public:
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
 protected:
-    // ---  ---
+    // --- 组件 ---
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera")
         class USceneComponent* SceneRoot;
 
@@ -25,7 +25,7 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera")
         class UCameraComponent* CameraComp;
 
-    // --- ƶŲ ---
+    // --- 移动与缩放参数 ---
     UPROPERTY(EditAnywhere, Category = "RTS Movement")
         float MoveSpeed;
 
@@ -33,30 +33,30 @@ protected:
         float ZoomSpeed;
 
     UPROPERTY(EditAnywhere, Category = "RTS Movement")
-        float MinZoom; // 
+        float MinZoom; // 最近距离
 
     UPROPERTY(EditAnywhere, Category = "RTS Movement")
-        float MaxZoom; // Զ
+        float MaxZoom; // 最远距离
 
-        // --- ڲ״̬ ---
-    float TargetZoom; // Ŀ۳ƽţ
+        // --- 内部状态 ---
+    float TargetZoom; // 目标臂长（用于平滑缩放）
 
-    // --- 봦 ---
+    // --- 输入处理函数 ---
     void MoveForward(float Value);
     void MoveRight(float Value);
     void ZoomIn();
     void ZoomOut();
 
-    // --- קƶ ---
+    // --- 拖拽移动参数 ---
     UPROPERTY(EditAnywhere, Category = "RTS Movement")
-        float DragSpeed; // ק
+        float DragSpeed; // 拖拽灵敏度
 
-    // ¼ҼǷ
+    // 记录右键是否按下
     bool bIsRMBDown;
 
-    // ---  ---
+    // --- 函数声明 ---
     void OnRightClickDown();
     void OnRightClickUp();
-    void HandleMouseDragX(float Value); // 
-    void HandleMouseDragY(float Value); // 
+    void HandleMouseDragX(float Value); // 处理鼠标左右移
+    void HandleMouseDragY(float Value); // 处理鼠标上下移
 };
\ No newline at end of file
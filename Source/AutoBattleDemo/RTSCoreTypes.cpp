@@ -1,4 +1,4 @@
-// ڸļӦ.hͷļڴŴͨõöٺͽṹ壬ѭãļҪռ
+// 由于该文件对应的.h头文件仅用于存放大家通用的枚举和结构体，避免循环引用，该文件并不需要，留空即可
 
 #include "RTSCoreTypes.h"
 
@@ -3,17 +3,17 @@
 #include "CoreMinimal.h"
 #include "RTSCoreTypes.generated.h"
 
-// Ϸ׶״̬
+// 游戏阶段状态
 UENUM(BlueprintType)
 enum class EGameState : uint8
 {
-    Preparation, // ս׶Σ
-    Battle,      // ս׶ΣԶѰ·
-    Victory,     // 㣺ʤ
-    Defeat       // 㣺ʧ
+    Preparation, // 备战阶段：玩家买兵、摆阵
+    Battle,      // 战斗阶段：自动寻路、攻击
+    Victory,     // 结算：胜利
+    Defeat       // 结算：失败
 };
 
-// Ӫ
+// 队伍阵营
 UENUM(BlueprintType)
 enum class ETeam : uint8
 {
@@ -21,33 +21,33 @@ enum class ETeam : uint8
     Enemy
 };
 
-// ö
+// 兵种类型枚举
 UENUM(BlueprintType)
 enum class EUnitType : uint8
 {
     //Soldier    UMETA(DisplayName = "Soldier"),
-    Barbarian  UMETA(DisplayName = "Barbarian"),  // Ұ
-    Archer     UMETA(DisplayName = "Archer"),     // 
-    Giant      UMETA(DisplayName = "Giant"),      // 
-    Bomber     UMETA(DisplayName = "Bomber")      // ը
+    Barbarian  UMETA(DisplayName = "Barbarian"),  // 野蛮人
+    Archer     UMETA(DisplayName = "Archer"),     // 弓箭手
+    Giant      UMETA(DisplayName = "Giant"),      // 巨人
+    Bomber     UMETA(DisplayName = "Bomber")      // 炸弹人
 };
 
-// ö
+// 建筑类型枚举
 UENUM(BlueprintType)
 enum class EBuildingType : uint8
 {
     None          UMETA(DisplayName = "None"),
-    //Resource      UMETA(DisplayName = "Resource"),      // Դ󳡣
-    GoldMine      UMETA(DisplayName = "Gold Mine"),     // 
-    ElixirPump    UMETA(DisplayName = "Elixir Pump"),   // ʥˮռ
-    Defense       UMETA(DisplayName = "Defense"),       // 
-    Headquarters  UMETA(DisplayName = "Headquarters"),  // Ӫ
-    Wall          UMETA(DisplayName = "Wall"),          // ǽ
-    Barracks      UMETA(DisplayName = "Barracks"),      // Ӫ
-    Other         UMETA(DisplayName = "Other")          // 
+    //Resource      UMETA(DisplayName = "Resource"),      // 资源建筑（矿场）
+    GoldMine      UMETA(DisplayName = "Gold Mine"),     // 金矿
+    ElixirPump    UMETA(DisplayName = "Elixir Pump"),   // 圣水收集器
+    Defense       UMETA(DisplayName = "Defense"),       // 防御建筑（炮塔）
+    Headquarters  UMETA(DisplayName = "Headquarters"),  // 大本营
+    Wall          UMETA(DisplayName = "Wall"),          // 墙
+    Barracks      UMETA(DisplayName = "Barracks"),      // 兵营
+    Other         UMETA(DisplayName = "Other")          // 其他
 };
 
-// ڱʿݵĽṹ
+// 用于保存士兵数据的结构体
 USTRUCT(BlueprintType)
 struct FUnitSaveData
 {
@@ -64,18 +64,18 @@ struct FUnitSaveData
 };
 
 
-// Դ (ͨÿ۷߼)
+// 资源类型 (用于通用扣费逻辑)
 UENUM(BlueprintType)
 enum class EResourceType : uint8
 {
     None,
     Gold,
     Elixir,
-    Gem // Ԥ
+    Gem // 预留
 };
 
-// 浵 ( FUnitSaveData)
-// ڱһصĲ֣¹ؿҲܶ
+// 建筑存档数据 (类似于 FUnitSaveData)
+// 用于保存玩家基地的布局，哪怕关卡重启也能读回来
 USTRUCT(BlueprintType)
 struct FBuildingSaveData
 {
@@ -91,23 +91,30 @@ struct FBuildingSaveData
         int32 GridY;
 
     UPROPERTY(BlueprintReadWrite)
-        int32 Level; // ȼ
+        int32 Level; // 建筑等级
 
-    // ӪĿ
+    // 兵营里的库存
     UPROPERTY(BlueprintReadWrite)
         TArray<EUnitType> StoredUnitTypes;
+
+    // 资源建筑：上次结算时的存量和结算时间 (UTC)，读档时按经过的时间补上离线产量
+    UPROPERTY(BlueprintReadWrite)
+        float StoredResource = 0.0f;
+
+    UPROPERTY(BlueprintReadWrite)
+        FDateTime LastProductionTime;
 };
 
 UENUM(BlueprintType)
 enum class ETutorialStep : uint8
 {
     None,
-    Welcome,          // ӭƶһ¾ͷ
-    BuildGoldMine,    // ã (׬Ǯ)
-    BuildBarracks,    // ƼӪ (˿)
-    UpgradeBarracks,  // ףӪ (ϵͳ)
-    TrainBarbarian,   // Ұ (黨Ǯ)
-    MoveUnit,         // ƶʿ ()
-    ClickStart,       // ս
+    Welcome,          // 欢迎：试着移动一下镜头
+    BuildGoldMine,    // 经济：造金矿 (体验赚钱)
+    BuildBarracks,    // 科技：造兵营 (体验解锁人口)
+    UpgradeBarracks,  // 进阶：升级兵营 (体验升级系统)
+    TrainBarbarian,   // 兵力：造野蛮人 (体验花钱)
+    MoveUnit,         // 操作：移动士兵 (体验操作)
+    ClickStart,       // 战斗：出征
     Completed
 };
\ No newline at end of file
@@ -5,20 +5,20 @@
 
 void URTSGameInstance::StartNewGame()
 {
-    // 1. 
+    // 1. 重置所有数据
     ResetData();
 
-    // 2. ǿý̳״̬
-    bTutorialFinished = false; // û̳
+    // 2. 强制重置教程状态
+    bTutorialFinished = false; // 还没做完教程
 
-    // 3. ʼԴ (һǮ󣬲ˮȰ̳)
+    // 3. 初始资源 (给一点钱造矿，不给水逼迫按教程走)
     PlayerGold = 300;
     PlayerElixir = 0;
 
-    // 4. ɾɴ浵 (ѡ߸)
+    // 4. 删除旧存档 (可选，或者覆盖)
     // UGameplayStatics::DeleteGameInSlot("SaveSlot1", 0); 
 
-    // 5. ʼ״̬
+    // 5. 保存初始状态
     SaveGameToDisk();
 }
 
@@ -34,6 +34,6 @@ bool URTSGameInstance::ContinueGame()
 
 bool URTSGameInstance::HasSaveGame()
 {
-    //  SlotName 㱣ʱõһģһ ("SaveSlot1")
+    // 这里的 SlotName 必须和你保存时用的一模一样 ("SaveSlot1")
     return UGameplayStatics::DoesSaveGameExist(TEXT("SaveSlot1"), 0);
 }
\ No newline at end of file
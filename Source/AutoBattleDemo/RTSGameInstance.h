@@ -12,49 +12,49 @@ class AUTOBATTLEDEMO_API URTSGameInstance : public UGameInstance
     GENERATED_BODY()
 public:
 
-    // ǰؿ (0, 1, 2)
+    // 当前关卡索引 (0, 1, 2)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Data")
         int32 CurrentLevelIndex;
 
-    // ҳеĽ (ؿ) ()
+    // 玩家持有的金币 (跨关卡保存)，金币 (造防御塔)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Data")
         int32 PlayerGold = 5000;
 
-    // ʥˮ ()
+    // 圣水 (造兵)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Data")
         int32 PlayerElixir = 5000;
 
-    // ˿
+    // 人口
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Data")
         int32 CurrentPopulation = 0;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Data")
-        int32 MaxPopulation = 0; // ʼΪ0ȫ HQ  Ӫ ṩ
+        int32 MaxPopulation = 0; // 初始为0，全靠 HQ 和 兵营 提供
 
-    // ҵľ
+    // 玩家的军队阵容
     UPROPERTY(BlueprintReadWrite, Category = "SaveData")
         TArray<FUnitSaveData> PlayerArmy;
 
-    // ؽ
+    // 保存基地建筑布局
     UPROPERTY(BlueprintReadWrite, Category = "SaveData")
         TArray<FBuildingSaveData> SavedBuildings;
 
-    // ǣǷѾʼأ(ֹһаԤɾ)
+    // 标记：是否已经初始化过基地？(防止第一次运行把预设的删了)
     bool bHasSavedBase = false;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SaveData")
         bool bTutorialFinished = false;
 
-    //  (Ϸʱ)
+    // 重置所有玩家数据 (新游戏时调用)
     UFUNCTION(BlueprintCallable)
         void ResetData()
     {
-        PlayerGold = 5000;   // ָʼǮ
+        PlayerGold = 5000;   // 恢复初始钱
         PlayerElixir = 5000;
         CurrentPopulation = 0;
         MaxPopulation = 0;
-        PlayerArmy.Empty();      // ձ
-        SavedBuildings.Empty();  // ս
+        PlayerArmy.Empty();      // 清空兵
+        SavedBuildings.Empty();  // 清空建筑
         bHasSavedBase = false;
         bTutorialFinished = false;
     }
@@ -68,11 +68,11 @@ public:
     UFUNCTION(BlueprintCallable, Category = "SaveSystem")
         void StartNewGame();
 
-    // Ϸ (ȡ浵û浵򷵻 false)
+    // 继续游戏 (读取存档，如果没存档则返回 false)
     UFUNCTION(BlueprintCallable, Category = "SaveSystem")
         bool ContinueGame();
 
-    // Ƿڴ浵
+    // 检查是否存在存档
     UFUNCTION(BlueprintCallable, Category = "SaveSystem")
         bool HasSaveGame();
 };
\ No newline at end of file
@@ -2,11 +2,14 @@
 #include "RTSPlayerController.h"
 #include "GridManager.h"
 #include "BaseUnit.h"
+#include "CrowdManager.h"
+#include "UnitPool.h"
 #include "BaseBuilding.h"
 #include "RTSGameInstance.h"
 #include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
 #include "Building_Barracks.h"
+#include "Building_Resource.h"
 #include "Components/CapsuleComponent.h"
 #include "Building_Barracks.h"
 #include "LevelDataAsset.h" 
@@ -16,21 +19,25 @@ ARTSGameMode::ARTSGameMode()
     PlayerControllerClass = ARTSPlayerController::StaticClass();
     CurrentState = EGameState::Preparation;
     bIsChangingLevel = false;
+    UnitPoolPrewarmCount = 8;
 }
 
 void ARTSGameMode::BeginPlay()
 {
     Super::BeginPlay();
 
-    // 1. ҵ GridManager
+    // 1. 找到 GridManager
     GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
 
-    // 2. ʼ
-    // ȷκμ֮ǰѾ
+    // 2. 在这里初始化网格
+    // 确保在做任何加载之前，网格已经就绪
     if (GridManager)
     {
-        // ջ
+        // 收回网格加载
         GridManager->GenerateGrid(20, 20, 100.0f);
+
+        // 墙由 GridManager 统一绘制，没单独配置的话用这里的墙蓝图做原型
+        if (!GridManager->WallClass) GridManager->WallClass = WallClass;
     }
     else
     {
@@ -38,8 +45,8 @@ void ARTSGameMode::BeginPlay()
         return;
     }
 
-    // עֶõĽ (˵ǽ)
-    // Ϊ GenerateGrid ˣҪóеĽռ
+    // 注册所有手动放置的建筑 (比如敌人的墙)
+    // 因为 GenerateGrid 把网格清空了，我们需要让场景里已有的建筑重新占坑
     TArray<AActor*> ExistingBuildings;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), ExistingBuildings);
 
@@ -48,41 +55,59 @@ void ARTSGameMode::BeginPlay()
         ABaseBuilding* Building = Cast<ABaseBuilding>(Actor);
         if (Building)
         {
-            // û (ֶϽȥͨ -1)
-            // Ϊ˱¼һ
+            // 如果建筑还没计算过网格坐标 (手动拖进去的通常是 -1)
+            // 或者是为了保险起见，重新计算一次
             int32 X, Y;
             if (GridManager->WorldToGrid(Building->GetActorLocation(), X, Y))
             {
+                // 墙换成格子上的数据，手动摆的 Actor 不再需要
+                if (Building->BuildingType == EBuildingType::Wall)
+                {
+                    if (!GridManager->WallClass) GridManager->WallClass = Building->GetClass();
+                    GridManager->AddWall(X, Y, Building->TeamID, Building->BuildingLevel);
+                    Building->Destroy();
+                    continue;
+                }
+
                 Building->GridX = X;
                 Building->GridY = Y;
 
-                // ģӣ
+                // 核心：锁定格子！
                 GridManager->SetTileBlocked(X, Y, true);
             }
         }
     }
 
-    // 3. жϵǰͼ
+    // 3. 判断当前地图
     FString MapName = GetWorld()->GetMapName();
 
-    // --- սؿ ---
+    // --- 战斗关卡 ---
     if (MapName.Contains("BattleField", ESearchCase::IgnoreCase))
     {
         UE_LOG(LogTemp, Warning, TEXT(">>> Detected Battle Map! Spawning Units..."));
 
-        // ֻսؿżعؿ ()
-        // ĻܻᵼĻҲˢ˵
+        // 只有在战斗关卡，才加载关卡数据 (敌人配置)
+        // 如果放在外面的话，可能会导致你的基地里也刷出敌人的塔！
         if (GridManager && CurrentLevelData)
         {
-            // ע⣺ڲܻٴ GenerateGridûϵȫ
+            // 注意：这内部可能会再次 GenerateGrid，但这没关系，反而更安全
             GridManager->LoadLevelFromDataAsset(CurrentLevelData);
         }
 
+        // 预热单位对象池：只有战斗关卡会成批部署、阵亡；基地里买兵、存取兵用到时再按需生成
+        if (AUnitPool* Pool = AUnitPool::Get(this))
+        {
+            for (TSubclassOf<ABaseUnit> UnitClass : { BarbarianClass, ArcherClass, GiantClass, BomberClass })
+            {
+                Pool->Prewarm(UnitClass, UnitPoolPrewarmCount);
+            }
+        }
+
         CurrentState = EGameState::Battle;
-        LoadAndSpawnUnits(); // Ѵıų
-        StartBattlePhase();  //  AI
+        LoadAndSpawnUnits(); // 把带来的兵放出来
+        StartBattlePhase();  // 激活 AI
     }
-    // --- عؿ ---
+    // --- 基地关卡 ---
     else
     {
         UE_LOG(LogTemp, Warning, TEXT(">>> Detected Base Map. Loading Buildings..."));
@@ -92,7 +117,7 @@ void ARTSGameMode::BeginPlay()
         URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
         if (GI)
         {
-            // ؼȫ˿ڣȻý
+            // 关键：先完全重置人口，然后让建筑重新添加
             GI->MaxPopulation = 0;
             GI->CurrentPopulation = GI->PlayerArmy.Num();
 
@@ -100,32 +125,32 @@ void ARTSGameMode::BeginPlay()
                 GI->CurrentPopulation);
         }
 
-        // صأ°ѷӸ
+        // 回到基地，重新把房子盖起来
         LoadAndSpawnBase();
 
-        // صأر
+        // 回到基地，带回兵
         LoadAndSpawnUnits();
     }
 }
 
-// ߼
+// 造兵逻辑
 bool ARTSGameMode::TryBuyUnit(EUnitType Type, int32 Cost, int32 GridX, int32 GridY)
 {
     if (CurrentState != EGameState::Preparation) return false;
 
-    // Ӫȼ
-    // ҪֱӾܾǮ
+    // 兵营等级检查
+    // 如果不满足要求，直接拒绝，不扣钱，不生成
     if (!CheckUnitTechRequirement(Type))
     {
         return false;
     }
 
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
-    if (!GI) return false; // ȫ
+    if (!GI) return false; // 安全检查
 
-    // ---  (⴫͵սڵ) ---
-    // ͼ߶ 20ֻ X < 8  (°)
-    //  BattleField1 ĵ˾ͿԷ X > 10 
+    // --- 区域限制 (避免传送到战场后骑在敌人脸上) ---
+    // 假设地图高度是 20，我们只允许在 X < 8 的区域造兵 (下半区)
+    // 这样 BattleField1 的敌人就可以放在 X > 10 的区域
     int32 MaxPlayerX = 8;
 
     if (GridX >= MaxPlayerX)
@@ -135,22 +160,22 @@ bool ARTSGameMode::TryBuyUnit(EUnitType Type, int32 Cost, int32 GridX, int32 Gri
         return false;
     }
 
-    // ˿
+    // 检查人口
     if (GI->CurrentPopulation + 1 > GI->MaxPopulation)
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Max Population!"));
         return false;
     }
 
-    // ʥˮ
-    // ʹ >= ȷպùǮҲ
+    // 检查圣水
+    // 使用 >= 确保刚好够钱也能买
     if (GI->PlayerElixir < Cost)
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Not Enough Elixir!"));
         return false;
     }
 
-    // ƥͼ
+    // 匹配蓝图
     TSubclassOf<ABaseUnit> SpawnClass = nullptr;
     switch (Type)
     {
@@ -162,14 +187,14 @@ bool ARTSGameMode::TryBuyUnit(EUnitType Type, int32 Cost, int32 GridX, int32 Gri
 
     if (!SpawnClass || !GridManager) return false;
 
-    // ռ
+    // 检查格子占用
     if (!GridManager->IsTileWalkable(GridX, GridY))
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Blocked!"));
         return false;
     }
 
-    // ߶
+    // 计算高度
     float SpawnZOffset = 0.0f;
     ABaseUnit* DefaultUnit = SpawnClass->GetDefaultObject<ABaseUnit>();
     if (DefaultUnit)
@@ -188,24 +213,19 @@ bool ARTSGameMode::TryBuyUnit(EUnitType Type, int32 Cost, int32 GridX, int32 Gri
     FVector SpawnLoc = GridManager->GridToWorld(GridX, GridY);
     SpawnLoc.Z += SpawnZOffset;
 
-    // 
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-    ABaseUnit* NewUnit = GetWorld()->SpawnActor<ABaseUnit>(SpawnClass, SpawnLoc, FRotator::ZeroRotator, SpawnParams);
+    // 生成 (优先从对象池取)
+    ABaseUnit* NewUnit = SpawnPlayerUnit(SpawnClass, SpawnLoc);
     if (NewUnit)
     {        
-        GI->PlayerElixir -= Cost; // ۷
-        GI->CurrentPopulation += 1; // ˿
+        GI->PlayerElixir -= Cost; // 扣费
+        GI->CurrentPopulation += 1; // 人口
 
-        NewUnit->TeamID = ETeam::Player;
         // GridManager->SetTileBlocked(GridX, GridY, true);
-        return true;
     }
-    return false;
+    return NewUnit != nullptr;
 }
 
-// 콨߼
+// 造建筑逻辑
 bool ARTSGameMode::TryBuildBuilding(EBuildingType Type, int32 Cost, int32 GridX, int32 GridY)
 {
     if (CurrentState != EGameState::Preparation) return false;
@@ -213,14 +233,14 @@ bool ARTSGameMode::TryBuildBuilding(EBuildingType Type, int32 Cost, int32 GridX,
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return false;
 
-    // 
+    // 检查金币
     if (GI->PlayerGold < Cost)
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Not Enough Gold!"));
         return false;
     }
 
-    // Է
+    // 建筑可以放在限制区域
     int32 MaxPlayerX = 8;
 
     if (GridX >= MaxPlayerX)
@@ -250,7 +270,16 @@ bool ARTSGameMode::TryBuildBuilding(EBuildingType Type, int32 Cost, int32 GridX,
         return false;
     }
 
-    // ߶ȼ
+    // 墙只是格子上的数据 (GridManager 用一个实例化网格体画所有墙)，不生成 Actor
+    if (Type == EBuildingType::Wall)
+    {
+        if (GridManager->AddWall(GridX, GridY, ETeam::Player) == INDEX_NONE) return false;
+
+        GI->PlayerGold -= Cost;
+        return true;
+    }
+
+    // 高度计算
     float SpawnZOffset = 0.0f;
     ABaseBuilding* DefaultBuilding = SpawnClass->GetDefaultObject<ABaseBuilding>();
     if (DefaultBuilding)
@@ -281,21 +310,21 @@ bool ARTSGameMode::TryBuildBuilding(EBuildingType Type, int32 Cost, int32 GridX,
     return false;
 }
 
-//  (뿪ǰ)
+// 保存基地 (离开基地前调用)
 void ARTSGameMode::SaveBaseLayout()
 {
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return;
 
-    // 1. վɴ浵
+    // 1. 清空旧存档
     GI->SavedBuildings.Empty();
-    GI->bHasSavedBase = true; // Ѿ
+    GI->bHasSavedBase = true; // 标记我们已经存过档了
 
-    // 2. еĽ
+    // 2. 遍历场景里所有的建筑
     for (TActorIterator<ABaseBuilding> It(GetWorld()); It; ++It)
     {
         ABaseBuilding* Building = *It;
-        // ֻҵĽһŵ
+        // 只保存玩家的建筑，且活着的
         if (Building && Building->TeamID == ETeam::Player && Building->CurrentHealth > 0)
         {
             FBuildingSaveData Data;
@@ -304,16 +333,38 @@ void ARTSGameMode::SaveBaseLayout()
             Data.GridY = Building->GridY;
             Data.Level = Building->BuildingLevel;
 
-            // ǱӪı
+            // 如果是兵营，保存里面的兵
             if (Building->BuildingType == EBuildingType::Barracks)
             {
-                // Cast һ²ܵຯ
+                // Cast 一下才能调子类函数
                 if (ABuilding_Barracks* Barracks = Cast<ABuilding_Barracks>(Building))
                 {
                     Data.StoredUnitTypes = Barracks->GetStoredUnitTypes();
                 }
             }
 
+            // 如果是资源建筑，保存存量和结算时间
+            if (ABuilding_Resource* Resource = Cast<ABuilding_Resource>(Building))
+            {
+                Resource->SaveProductionState(Data);
+            }
+
+            GI->SavedBuildings.Add(Data);
+        }
+    }
+
+    // 3. 墙不是 Actor，从 GridManager 里取
+    if (GridManager)
+    {
+        for (const FGridWall& Wall : GridManager->GetWalls())
+        {
+            if (Wall.Team != ETeam::Player) continue;
+
+            FBuildingSaveData Data;
+            Data.BuildingType = EBuildingType::Wall;
+            Data.GridX = Wall.Tile.X;
+            Data.GridY = Wall.Tile.Y;
+            Data.Level = Wall.Level;
             GI->SavedBuildings.Add(Data);
         }
     }
@@ -321,14 +372,14 @@ void ARTSGameMode::SaveBaseLayout()
     UE_LOG(LogTemp, Log, TEXT("Base Saved! Total Buildings: %d"), GI->SavedBuildings.Num());
 }
 
-// ػ (صʱ)
+// 加载基地 (回到基地时调用)
 void ARTSGameMode::LoadAndSpawnBase()
 {
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
-    // ûд(һ)û GridManagerɶҲ
+    // 如果没有存过档(第一次玩)，或者没有 GridManager，就啥也不做
     if (!GI || !GridManager) return;
 
-    // Ƿд浵ûУǳ棬ҲҪ֤ HQ
+    // 检查是否有存档，如果没有，或者是初次游玩，也要保证有 HQ
     bool bHasHQ = false;
 
     if (GI->bHasSavedBase)
@@ -348,10 +399,16 @@ void ARTSGameMode::LoadAndSpawnBase()
                 case EBuildingType::Headquarters: SpawnClass = HQClass;           break;
             }
 
+            // 墙直接放回格子上 (用 GridManager 自己的 WallClass，GameMode 上没配墙蓝图也照样恢复)
+            if (Data.BuildingType == EBuildingType::Wall)
+            {
+                GridManager->AddWall(Data.GridX, Data.GridY, ETeam::Player, Data.Level);
+                continue;
+            }
 
             if (!SpawnClass) continue;
 
-            // 2. ߶ (֮ǰͨ߼)
+            // 2. 算高度 (用之前的通用逻辑)
             float SpawnZOffset = 0.0f;
             ABaseBuilding* DefaultBuilding = SpawnClass->GetDefaultObject<ABaseBuilding>();
             if (DefaultBuilding)
@@ -364,7 +421,7 @@ void ARTSGameMode::LoadAndSpawnBase()
             FVector SpawnLoc = GridManager->GridToWorld(Data.GridX, Data.GridY);
             SpawnLoc.Z += SpawnZOffset;
 
-            // 3. 
+            // 3. 生成
             FActorSpawnParameters Params;
             Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
@@ -374,30 +431,30 @@ void ARTSGameMode::LoadAndSpawnBase()
                 NewBuilding->TeamID = ETeam::Player;
                 NewBuilding->GridX = Data.GridX;
                 NewBuilding->GridY = Data.GridY;
-                NewBuilding->BuildingLevel = Data.Level; // ָȼ
+                NewBuilding->BuildingLevel = Data.Level; // 恢复等级
 
-                // ָ赲
+                // 恢复阻挡
                 GridManager->SetTileBlocked(Data.GridX, Data.GridY, true);
 
-                // ǱӪָ
+                // 如果是兵营，恢复库存
                 if (Data.BuildingType == EBuildingType::Barracks)
                 {
                     if (ABuilding_Barracks* Barracks = Cast<ABuilding_Barracks>(NewBuilding))
                     {
-                        // ¼BeginPlayӵ˿ڣʼ1
+                        // 记录BeginPlay添加的人口（初始化是1级）
                         int32 OldCapacity = Barracks->GetCurrentCapacity(1);
 
-                        // ȷĵȼ
+                        // 设置正确的等级
                         Barracks->BuildingLevel = Data.Level;
 
-                        // ȷ˿
+                        // 计算正确的人口
                         int32 CorrectCapacity = Barracks->GetCurrentCapacity(Data.Level);
 
-                        // ˿ڣȥӵģȷ
+                        // 修正人口：减去错误添加的，加上正确的
                         if (GI)
                         {
-                            GI->MaxPopulation -= OldCapacity;  // ȥ1ӵ
-                            GI->MaxPopulation += CorrectCapacity; // ȷȼ
+                            GI->MaxPopulation -= OldCapacity;  // 减去1级添加的
+                            GI->MaxPopulation += CorrectCapacity; // 加上正确等级的
 
                             UE_LOG(LogTemp, Log, TEXT("[Barracks] Population corrected: -%d (Lv1) +%d (Lv%d) = Net +%d"),
                                 OldCapacity, CorrectCapacity, Data.Level, CorrectCapacity - OldCapacity);
@@ -406,20 +463,26 @@ void ARTSGameMode::LoadAndSpawnBase()
                         Barracks->RestoreStoredUnits(Data.StoredUnitTypes);
                     }
                 }
+
+                // 如果是资源建筑，恢复存量 (离开期间的产量按时间补上)
+                if (ABuilding_Resource* Resource = Cast<ABuilding_Resource>(NewBuilding))
+                {
+                    Resource->RestoreProductionState(Data);
+                }
             }
         }
     }
 
-    // ߼浵û HQ (ߵһ)ǿ (0,0) һ ---
+    // 保底逻辑：如果存档里没 HQ (或者第一次玩)，强制在 (0,0) 生一个 ---
     if (!bHasHQ)
     {
         UE_LOG(LogTemp, Warning, TEXT("No HQ found in save data. Spawning default HQ at (0,0)."));
 
-        // ȷ (0,0) ûռ (Ȼ HQ Ȩ󣬵Ǽһº)
-        // ʵ HQ Ӧɡ
+        // 确保 (0,0) 没被占 (虽然 HQ 权力最大，但还是检查一下好)
+        // 实际上 HQ 应该最先生成。
         if (HQClass)
         {
-            TryBuildBuilding(EBuildingType::Headquarters, 0, 0, 0); // CostΪ0
+            TryBuildBuilding(EBuildingType::Headquarters, 0, 0, 0); // Cost设为0免费造
         }
     }
 
@@ -428,32 +491,32 @@ void ARTSGameMode::LoadAndSpawnBase()
 
 void ARTSGameMode::SaveAndStartBattle(FName LevelName)
 {
-    // ȱؽ
+    // 先保存基地建筑
     SaveBaseLayout();
 
 
-    // 
+    // 保存兵力
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return;
 
-    // վ
+    // 清空旧数据
     GI->PlayerArmy.Empty();
 
-    // еҵλ
+    // 遍历场景里所有的玩家单位
     for (TActorIterator<ABaseUnit> It(GetWorld()); It; ++It)
     {
         ABaseUnit* Unit = *It;
-        // ȷֻҵıһŵ
+        // 确保只保存玩家的兵，且活着的
         if (Unit && Unit->TeamID == ETeam::Player && Unit->CurrentHealth > 0)
         {
             if (GridManager)
             {
                 int32 X, Y;
-                // ʹóԱBдGridManagerWorldToGrid
+                // 使用成员B写在GridManager里的WorldToGrid
                 if (GridManager->WorldToGrid(Unit->GetActorLocation(), X, Y))
                 {
                     FUnitSaveData Data;
-                    Data.UnitType = Unit->UnitType; // ʹ BaseUnit  UnitType 
+                    Data.UnitType = Unit->UnitType; // 使用 BaseUnit 里的 UnitType 变量
                     Data.GridX = X;
                     Data.GridY = Y;
                     GI->PlayerArmy.Add(Data);
@@ -471,11 +534,11 @@ void ARTSGameMode::SaveAndStartBattle(FName LevelName)
             GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("You need an Army to fight! Place some units first."));
         }
 
-        // ֱӷأִлؿ
+        // 直接返回，不执行切换关卡
         return;
     }
 
-    // лؿ
+    // 切换关卡
     UGameplayStatics::OpenLevel(this, LevelName);
 }
 
@@ -489,7 +552,8 @@ void ARTSGameMode::StartBattlePhase()
     for (TActorIterator<ABaseUnit> It(GetWorld()); It; ++It)
     {
         ABaseUnit* Unit = *It;
-        if (Unit)
+        // 对象池里的单位 (已隐藏、已注销) 不参战
+        if (Unit && !Unit->IsDead())
         {
             Unit->SetUnitActive(true);
 
@@ -509,17 +573,17 @@ void ARTSGameMode::RestartLevel()
     UGameplayStatics::OpenLevel(this, FName(*GetWorld()->GetName()), false);
 }
 
-// ߼ѻŵıȻس
+// 结算逻辑：把活着的兵存下来，然后回城
 void ARTSGameMode::ReturnToBase()
 {
-    // Ѿйؿˣֱӷأֹ
+    // 如果已经在切关卡了，直接返回，防止崩溃
     if (bIsChangingLevel) return;
 
-    // ס
+    // 锁住
     bIsChangingLevel = true;
 
-    // ֻҪˣ˭õģȰѶʱϣ
-    // ֶģǸ3뵹ʱͻᱻȡٴڶ
+    // 只要进来了，不管是谁调用的，先把定时器掐断！
+    // 这样如果是手动点的，那个3秒倒计时就会被取消，不会再触发第二次
     GetWorld()->GetTimerManager().ClearTimer(ReturnTimerHandle);
 
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
@@ -527,7 +591,7 @@ void ARTSGameMode::ReturnToBase()
 
     UE_LOG(LogTemp, Warning, TEXT("Returning to Base..."));
 
-    // ߼
+    // 保存逻辑
     GI->PlayerArmy.Empty();
     for (TActorIterator<ABaseUnit> It(GetWorld()); It; ++It)
     {
@@ -543,16 +607,16 @@ void ARTSGameMode::ReturnToBase()
 
     UE_LOG(LogTemp, Warning, TEXT("Survivors saved: %d"), GI->PlayerArmy.Num());
 
-    // лؿǰµ״̬дӲ
+    // 在切换关卡前，把最新的状态写入硬盘
     GI->SaveGameToDisk();
 
-    // лؿ
-    // ΢ӳһУ Log һĻᣬҲֹջͻ
-    // ȷ bIsChangingLevel Ѿ true
+    // 切换关卡
+    // 稍微延迟一点点切，给 Log 一个输出的机会，也防止调用栈冲突
+    // 但必须确保 bIsChangingLevel 已经是 true
     UGameplayStatics::OpenLevel(this, FName("PlayerBase"));
 }
 
-// ߼صܵ
+// 加载逻辑：带防重叠功能的生成
 void ARTSGameMode::LoadAndSpawnUnits()
 {
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
@@ -561,12 +625,15 @@ void ARTSGameMode::LoadAndSpawnUnits()
     FString MapName = GetWorld()->GetMapName();
     bool bIsHomeBase = !MapName.Contains("BattleField", ESearchCase::IgnoreCase);
 
-    // ʱ¼ɵıռõĸ (ֹԼ˲Լ)
+    // 临时记录本轮生成的兵占用的格子 (防止自己人踩自己人)
     TSet<FIntPoint> OccupiedByUnits;
 
+    // 本轮生成的兵 (最后统一编队)
+    TArray<ABaseUnit*> SpawnedUnits;
+
     for (const FUnitSaveData& Data : GI->PlayerArmy)
     {
-        // 1. ƥͼ
+        // 1. 匹配蓝图
         TSubclassOf<ABaseUnit> SpawnClass = nullptr;
         switch (Data.UnitType)
         {
@@ -578,37 +645,37 @@ void ARTSGameMode::LoadAndSpawnUnits()
 
         if (!SpawnClass) continue;
 
-        // ȷĵ
+        // 确定中心点
         int32 CenterX, CenterY;
         if (bIsHomeBase)
         {
-            CenterX = 0; CenterY = 0; // أΧ HQ(0,0)
+            CenterX = 0; CenterY = 0; // 基地：围绕 HQ(0,0)
         }
         else
         {
-            CenterX = Data.GridX; CenterY = Data.GridY; // սԭλ
+            CenterX = Data.GridX; CenterY = Data.GridY; // 战场：原位
         }
 
-        // --- λ ---
+        // --- 螺旋搜索空位 ---
         bool bFoundSpot = false;
         int32 FinalX = CenterX;
         int32 FinalY = CenterY;
 
-        // 뾶
-        for (int32 Radius = 0; Radius <= 15; ++Radius) //  0 ʼȲ
+        // 搜索半径
+        for (int32 Radius = 0; Radius <= 15; ++Radius) // 从 0 开始，先查中心
         {
-            // 򵥵ľα㷨
+            // 简单的矩形遍历算法
             for (int32 x = CenterX - Radius; x <= CenterX + Radius; ++x)
             {
                 for (int32 y = CenterY - Radius; y <= CenterY + Radius; ++y)
                 {
-                    // 1. 赲 (/ǽ)
+                    // 1. 检查物理阻挡 (建筑/墙)
                     if (!GridManager->IsTileWalkable(x, y)) continue;
 
-                    // 2. 鱾ɵıǷռ
+                    // 2. 检查本轮生成的兵是否占了这个坑
                     if (OccupiedByUnits.Contains(FIntPoint(x, y))) continue;
 
-                    // ҵλˣ
+                    // 找到空位了！
                     FinalX = x;
                     FinalY = y;
                     bFoundSpot = true;
@@ -618,20 +685,20 @@ void ARTSGameMode::LoadAndSpawnUnits()
         }
         SpotFound:;
 
-        // ʵûطˣҲֻص(߲)ѡԷ
+        // 如果实在没地方了，也只能重叠了(或者不生成)，这里选择跳过不生成以防卡死
         if (!bFoundSpot)
         {
             UE_LOG(LogTemp, Error, TEXT("No space to spawn unit!"));
             continue;
         }
 
-        // ¼ռ
+        // 记录占用
         OccupiedByUnits.Add(FIntPoint(FinalX, FinalY));
 
-        // 3. 
+        // 3. 计算世界坐标
         FVector SpawnLoc = GridManager->GridToWorld(FinalX, FinalY);
 
-        // 4. ߶ (֮ǰ߼)
+        // 4. 计算高度 (保持之前的完美贴地逻辑)
         float SpawnZOffset = 0.0f;
         ABaseUnit* DefaultUnit = SpawnClass->GetDefaultObject<ABaseUnit>();
         if (DefaultUnit)
@@ -648,19 +715,22 @@ void ARTSGameMode::LoadAndSpawnUnits()
         }
         SpawnLoc.Z += SpawnZOffset;
 
-        // 5. 
-        FActorSpawnParameters Params;
-        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-
-        ABaseUnit* NewUnit = GetWorld()->SpawnActor<ABaseUnit>(SpawnClass, SpawnLoc, FRotator::ZeroRotator, Params);
+        // 5. 生成 (优先从对象池取)
+        ABaseUnit* NewUnit = SpawnPlayerUnit(SpawnClass, SpawnLoc);
         if (NewUnit)
         {
-            NewUnit->TeamID = ETeam::Player;
+            SpawnedUnits.Add(NewUnit);
            
-            // µĸ
+            // 锁定新的格子
             // GridManager->SetTileBlocked(FinalX, FinalY, true);
         }
     }
+
+    // 一起部署的兵编成小队 (队长寻路，队员跟随)
+    if (ACrowdManager* CrowdManager = ACrowdManager::Get(this))
+    {
+        CrowdManager->CreateSquads(SpawnedUnits);
+    }
 }
 
 void ARTSGameMode::OnActorKilled(AActor* Victim, AActor* Killer)
@@ -668,17 +738,17 @@ void ARTSGameMode::OnActorKilled(AActor* Victim, AActor* Killer)
     if (!Victim) return;
     UE_LOG(LogTemp, Log, TEXT("Actor Killed: %s"), *Victim->GetName());
 
-    // ʿ˿
-    // 1. ԰ܺתʿ
+    // 士兵死亡返还人口
+    // 1. 尝试把受害者转成士兵
     ABaseUnit* DeadUnit = Cast<ABaseUnit>(Victim);
 
-    // 2. ֻеʿӪʱŷ
+    // 2. 只有当它是士兵，且属于玩家阵营时，才返还
     if (DeadUnit && DeadUnit->TeamID == ETeam::Player)
     {
         URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
         if (GI)
         {
-            // ˿ -1СС 0
+            // 人口 -1，但最小不能小于 0
             GI->CurrentPopulation = FMath::Max(0, GI->CurrentPopulation - 1);
 
             UE_LOG(LogTemp, Warning, TEXT("Unit Died! Population returned. Current: %d/%d"),
@@ -686,14 +756,36 @@ void ARTSGameMode::OnActorKilled(AActor* Victim, AActor* Killer)
         }
     }
 
+    // 批量结算中：等整批死亡处理完再判一次
+    if (KillBatchDepth > 0)
+    {
+        bWinCheckPending = true;
+        return;
+    }
+
     CheckWinCondition();
 }
 
-bool ARTSGameMode::SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY)
+void ARTSGameMode::BeginKillBatch()
 {
-    if (!GridManager) return false;
+    ++KillBatchDepth;
+}
+
+void ARTSGameMode::EndKillBatch()
+{
+    KillBatchDepth = FMath::Max(0, KillBatchDepth - 1);
+    if (KillBatchDepth == 0 && bWinCheckPending)
+    {
+        bWinCheckPending = false;
+        CheckWinCondition();
+    }
+}
+
+ABaseUnit* ARTSGameMode::SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY)
+{
+    if (!GridManager) return nullptr;
 
-    // 1. ƥͼ
+    // 1. 匹配蓝图
     TSubclassOf<ABaseUnit> SpawnClass = nullptr;
     switch (Type)
     {
@@ -702,9 +794,9 @@ bool ARTSGameMode::SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY)
         case EUnitType::Giant:      SpawnClass = GiantClass;     break;
         case EUnitType::Bomber:     SpawnClass = BomberClass;    break;
     }
-    if (!SpawnClass) return false;
+    if (!SpawnClass) return nullptr;
 
-    // 2. ߶ȼ (֮ǰ߼)
+    // 2. 高度计算 (复制之前的逻辑)
     FVector SpawnLoc = GridManager->GridToWorld(GridX, GridY);
     float SpawnZOffset = 0.0f;
     ABaseUnit* DefaultUnit = SpawnClass->GetDefaultObject<ABaseUnit>();
@@ -721,7 +813,24 @@ bool ARTSGameMode::SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY)
     }
     SpawnLoc.Z += SpawnZOffset;
 
-    // 3. 
+    // 3. 生成 (优先从对象池取)
+    ABaseUnit* NewUnit = SpawnPlayerUnit(SpawnClass, SpawnLoc);
+    if (NewUnit)
+    {
+        // GridManager->SetTileBlocked(GridX, GridY, true);
+        return NewUnit;
+    }
+    return nullptr;
+}
+
+ABaseUnit* ARTSGameMode::SpawnPlayerUnit(TSubclassOf<ABaseUnit> SpawnClass, const FVector& SpawnLoc)
+{
+    if (AUnitPool* Pool = AUnitPool::Get(this))
+    {
+        return Pool->Acquire(SpawnClass, SpawnLoc, FRotator::ZeroRotator, ETeam::Player);
+    }
+
+    // 没有对象池 (比如生成失败)：走原来的 SpawnActor
     FActorSpawnParameters SpawnParams;
     SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
@@ -729,21 +838,19 @@ bool ARTSGameMode::SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY)
     if (NewUnit)
     {
         NewUnit->TeamID = ETeam::Player;
-        // GridManager->SetTileBlocked(GridX, GridY, true);
-        return true;
     }
-    return false;
+    return NewUnit;
 }
 
 void ARTSGameMode::CheckWinCondition()
 {
-    // Ѿˣͼٲ
+    // 如果已经结算了，或者正在切图，别再查了
     if (CurrentState == EGameState::Victory || CurrentState == EGameState::Defeat || bIsChangingLevel)
     {
         return;
     }
 
-    // ͳƳϵ˵ĴӪ
+    // 统计场上敌人的大本营
     TArray<AActor*> EnemyHQs;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), EnemyHQs);
 
@@ -751,7 +858,7 @@ void ARTSGameMode::CheckWinCondition()
     for (AActor* Actor : EnemyHQs)
     {
         ABaseBuilding* Building = Cast<ABaseBuilding>(Actor);
-        // ǿЧԼ
+        // 增强有效性检查
         if (!IsValid(Building) || Building->IsPendingKill()) continue;
 
         if (Building && Building->TeamID == ETeam::Enemy &&
@@ -762,7 +869,7 @@ void ARTSGameMode::CheckWinCondition()
         }
     }
     
-    // ͳƳϻʣ١ҵı
+    // 统计场上还剩多少【玩家的兵】
     TArray<AActor*> PlayerUnits;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseUnit::StaticClass(), PlayerUnits);
 
@@ -778,28 +885,28 @@ void ARTSGameMode::CheckWinCondition()
         }
     }
 
-    // --- ʤ ---
+    // --- 胜利条件 ---
     if (EnemyHQCount == 0)
     {
         CurrentState = EGameState::Victory;
 
-        // 
+        // 奖励
         URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
         if (GI) { GI->PlayerGold += 1000; GI->PlayerElixir += 1000; }
 
         UE_LOG(LogTemp, Warning, TEXT("VICTORY!"));
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green, TEXT("VICTORY!"));
 
-        // [޸] ʹóԱ TimerHandle
+        // [修改] 使用成员变量 TimerHandle
         GetWorld()->GetTimerManager().SetTimer(ReturnTimerHandle, [this]()
             {
-                ReturnToBase(); // ʱس
+                ReturnToBase(); // 定时器触发回城
             }, 3.0f, false);
 
         return;
     }
 
-    // --- ʧ ---
+    // --- 失败条件 ---
     if (PlayerUnitCount == 0)
     {
         CurrentState = EGameState::Defeat;
@@ -807,10 +914,10 @@ void ARTSGameMode::CheckWinCondition()
         UE_LOG(LogTemp, Warning, TEXT("DEFEAT!"));
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("DEFEAT!"));
 
-        // [޸] ʹóԱ TimerHandle
+        // [修改] 使用成员变量 TimerHandle
         GetWorld()->GetTimerManager().SetTimer(ReturnTimerHandle, [this]()
             {
-                ReturnToBase(); // ʱس
+                ReturnToBase(); // 定时器触发回城
             }, 3.0f, false);
     }
 }
@@ -818,16 +925,16 @@ void ARTSGameMode::CheckWinCondition()
 bool ARTSGameMode::TryUpgradeBuilding(ABaseBuilding* BuildingToUpgrade)
 {
     if (!BuildingToUpgrade) return false;
-    if (CurrentState != EGameState::Preparation) return false; // ֻбս
+    if (CurrentState != EGameState::Preparation) return false; // 只有备战期能升级
 
-    // 1. Ƿ
+    // 1. 检查是否满级
     if (!BuildingToUpgrade->CanUpgrade())
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Max Level Reached!"));
         return false;
     }
 
-    // 2. ȡ
+    // 2. 获取费用
     int32 GoldCost = 0;
     int32 ElixirCost = 0;
     BuildingToUpgrade->GetUpgradeCost(GoldCost, ElixirCost);
@@ -835,17 +942,52 @@ bool ARTSGameMode::TryUpgradeBuilding(ABaseBuilding* BuildingToUpgrade)
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return false;
 
-    // 3. Դ
+    // 3. 检查资源
     if (GI->PlayerGold < GoldCost)
     {
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Not Enough Gold to Upgrade!"));
         return false;
     }
 
-    // 4. ִ
+    // 4. 执行升级
     GI->PlayerGold -= GoldCost;
 
-    BuildingToUpgrade->LevelUp(); // ýԼ߼(Ѫ/)
+    BuildingToUpgrade->LevelUp(); // 调用建筑自己的升级逻辑(加血/变大)
+
+    if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, TEXT("Upgrade Successful!"));
+    return true;
+}
+
+bool ARTSGameMode::TryUpgradeWall(int32 WallIndex)
+{
+    if (!GridManager) return false;
+    if (CurrentState != EGameState::Preparation) return false; // 只有备战期能升级
+
+    const FGridWall* Wall = GridManager->GetWall(WallIndex);
+    if (!Wall || Wall->Team != ETeam::Player) return false;
+
+    // 1. 获取费用 (满级时拿不到)
+    int32 GoldCost = 0;
+    int32 ElixirCost = 0;
+    if (!GridManager->GetWallUpgradeCost(WallIndex, GoldCost, ElixirCost))
+    {
+        if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Max Level Reached!"));
+        return false;
+    }
+
+    URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
+    if (!GI) return false;
+
+    // 2. 检查资源
+    if (GI->PlayerGold < GoldCost)
+    {
+        if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Not Enough Gold to Upgrade!"));
+        return false;
+    }
+
+    // 3. 执行升级
+    GI->PlayerGold -= GoldCost;
+    GridManager->UpgradeWall(WallIndex);
 
     if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, TEXT("Upgrade Successful!"));
     return true;
@@ -855,14 +997,14 @@ int32 ARTSGameMode::GetCurrentTechLevel()
 {
     int32 MaxLevel = 0;
 
-    // бӪ
+    // 遍历所有兵营
     for (TActorIterator<ABuilding_Barracks> It(GetWorld()); It; ++It)
     {
         ABuilding_Barracks* Barracks = *It;
-        // ҵģһŵ
+        // 必须是玩家的，且活着的
         if (Barracks && Barracks->TeamID == ETeam::Player && Barracks->CurrentHealth > 0)
         {
-            // ҵȼߵǸ
+            // 找到等级最高的那个
             if (Barracks->BuildingLevel > MaxLevel)
             {
                 MaxLevel = Barracks->BuildingLevel;
@@ -875,15 +1017,15 @@ int32 ARTSGameMode::GetCurrentTechLevel()
 bool ARTSGameMode::CheckUnitTechRequirement(EUnitType Type)
 {
     int32 CurrentLevel = GetCurrentTechLevel();
-    int32 RequiredLevel = 99; // ĬϺܸߣֹ©
+    int32 RequiredLevel = 99; // 默认很高，防止漏洞
 
     switch (Type)
     {
-    case EUnitType::Barbarian:  RequiredLevel = 1; break; // ֻҪбӪ(Lv1)
+    case EUnitType::Barbarian:  RequiredLevel = 1; break; // 只要有兵营(Lv1)就能造
     case EUnitType::Archer:     RequiredLevel = 2; break;
     case EUnitType::Giant:      RequiredLevel = 3; break;
     case EUnitType::Bomber:     RequiredLevel = 4; break;
-        // ֣ case
+        // 如果有其他兵种，继续加 case
     }
 
     if (CurrentLevel >= RequiredLevel)
@@ -892,7 +1034,7 @@ bool ARTSGameMode::CheckUnitTechRequirement(EUnitType Type)
     }
     else
     {
-        // ӡʾ
+        // 打印提示
         FString UnitName = "";
         const UEnum* EnumPtr = FindObject<UEnum>(ANY_PACKAGE, TEXT("EUnitType"), true);
         if (EnumPtr) UnitName = EnumPtr->GetNameStringByValue((int64)Type);
@@ -914,20 +1056,20 @@ bool ARTSGameMode::CheckUnitTechRequirement(EUnitType Type)
 
 void URTSGameInstance::SaveGameToDisk()
 {
-    // 1. 浵
+    // 1. 创建存档对象
     URTSSaveGame* SaveGameInstance = Cast<URTSSaveGame>(UGameplayStatics::CreateSaveGameObject(URTSSaveGame::StaticClass()));
 
     if (SaveGameInstance)
     {
-        // 2. ڴ д 浵
+        // 2. 把内存数据 写入 存档对象
         SaveGameInstance->PlayerGold = this->PlayerGold;
         SaveGameInstance->PlayerElixir = this->PlayerElixir;
         SaveGameInstance->PlayerArmy = this->PlayerArmy;
         SaveGameInstance->SavedBuildings = this->SavedBuildings;
         SaveGameInstance->bTutorialFinished = this->bTutorialFinished;
-        // ҪĲ裬Ҫ Controller Ѳͬ GIʱֻ finished ״̬
+        // 如果你需要存具体的步骤，需要在 Controller 里把步骤同步给 GI，或者这里暂时只存 finished 状态
 
-        // 3. 浽Ӳ
+        // 3. 保存到硬盘
         UGameplayStatics::SaveGameToSlot(SaveGameInstance, SaveGameInstance->SaveSlotName, SaveGameInstance->UserIndex);
 
         UE_LOG(LogTemp, Warning, TEXT("Game Saved to Disk!"));
@@ -936,35 +1078,35 @@ void URTSGameInstance::SaveGameToDisk()
 
 void URTSGameInstance::LoadGameFromDisk()
 {
-    // 1. 浵Ƿ
+    // 1. 检查存档是否存在
     FString SlotName = TEXT("SaveSlot1");
     if (UGameplayStatics::DoesSaveGameExist(SlotName, 0))
     {
-        // 2. ȡ
+        // 2. 读取
         URTSSaveGame* LoadedGame = Cast<URTSSaveGame>(UGameplayStatics::LoadGameFromSlot(SlotName, 0));
 
         if (LoadedGame)
         {
-            // 3. Ѵ浵 ԭ ڴ
+            // 3. 把存档数据 还原到 内存
             this->PlayerGold = LoadedGame->PlayerGold;
             this->PlayerElixir = LoadedGame->PlayerElixir;
             this->PlayerArmy = LoadedGame->PlayerArmy;
             this->SavedBuildings = LoadedGame->SavedBuildings;
             this->bTutorialFinished = LoadedGame->bTutorialFinished;
 
-            // лأֹ GameMode ɳʼ HQ
+            // 标记已有基地，防止 GameMode 重新生成初始 HQ
             this->bHasSavedBase = (this->SavedBuildings.Num() > 0);
 
-            // У׼˿
+            // 校准人口
             this->CurrentPopulation = this->PlayerArmy.Num();
-            // MaxPopulation  GameMode ؽʱԶ㣬ﲻù
+            // MaxPopulation 会在 GameMode 加载建筑时自动计算，这里不用管
 
             UE_LOG(LogTemp, Warning, TEXT("Game Loaded from Disk!"));
         }
     }
     else
     {
-        // ûд浵ʼϷ
+        // 没有存档，初始化新游戏数据
         ResetData();
     }
 }
@@ -974,14 +1116,14 @@ void ARTSGameMode::SavePlayerUnits()
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return;
 
-    // 1. վ
+    // 1. 清空旧数据
     GI->PlayerArmy.Empty();
 
-    // 2. ı
+    // 2. 遍历场景里的兵
     for (TActorIterator<ABaseUnit> It(GetWorld()); It; ++It)
     {
         ABaseUnit* Unit = *It;
-        // ɸѡҵġŵġûٵ
+        // 筛选：玩家的、活着的、没被销毁的
         if (Unit &&
             Unit->TeamID == ETeam::Player &&
             Unit->CurrentHealth > 0 &&
@@ -990,7 +1132,7 @@ void ARTSGameMode::SavePlayerUnits()
             FUnitSaveData Data;
             Data.UnitType = Unit->UnitType;
 
-            // ȡλ
+            // 获取网格位置
             if (GridManager)
             {
                 GridManager->WorldToGrid(Unit->GetActorLocation(), Data.GridX, Data.GridY);
@@ -5,7 +5,7 @@
 #include "RTSCoreTypes.h"
 #include "RTSGameMode.generated.h"
 
-// ǰ
+// 前置声明
 class ABaseUnit;
 class ABaseBuilding;
 class ULevelDataAsset;
@@ -20,55 +20,62 @@ public:
     ARTSGameMode();
     virtual void BeginPlay() override;
 
-    // --- 1. ߼ ---
+    // --- 1. 造兵逻辑 ---
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         bool TryBuyUnit(EUnitType Type, int32 Cost, int32 GridX, int32 GridY);
 
-    // --- 2. 콨߼ () ---
+    // --- 2. 造建筑逻辑 (新增) ---
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         bool TryBuildBuilding(EBuildingType Type, int32 Cost, int32 GridX, int32 GridY);
 
-    // --- 3. ս ---
+    // --- 3. 战斗流程 ---
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         void StartBattlePhase();
 
-    // 浱ǰǰսؿ
+    // 保存当前布阵并前往战斗关卡
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         void SaveAndStartBattle(FName LevelName);
 
-    // սؿʼʱãɴı
+    // 在战斗关卡开始时调用：生成带来的兵
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         void LoadAndSpawnUnits();
 
-    // ¿ʼ
+    // 重新开始本关
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         void RestartLevel();
 
-    // --- ߼ ---
+    // --- 裁判逻辑 ---
     void OnActorKilled(AActor* Victim, AActor* Killer);
     void CheckWinCondition();
 
-    // ؽ
+    // 批量结算伤害期间的死亡只记一笔，结束时统一判一次胜负 (可嵌套)
+    void BeginKillBatch();
+    void EndKillBatch();
+
+    // 保存基地建筑数据
     void SaveBaseLayout();
 
-    // زɻؽ
+    // 加载并生成基地建筑
     void LoadAndSpawnBase();
 
-    // ָ
+    // 尝试升级指定建筑
     bool TryUpgradeBuilding(class ABaseBuilding* BuildingToUpgrade);
 
-    // 㲢س (ֻŵıлͼ)
+    // 尝试升级墙 (墙在 GridManager 里，按下标)
+    bool TryUpgradeWall(int32 WallIndex);
+
+    // 结算并回城 (只保存活着的兵，并切换地图)
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         void ReturnToBase();
 
-    // ָλǿɵλ (ԴӪͷʹ)
-    bool SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY);
+    // 在指定位置强制生成单位 (不扣资源，供兵营释放使用)，失败返回空
+    class ABaseUnit* SpawnUnitAt(EUnitType Type, int32 GridX, int32 GridY);
 
-    // ȡǰӵе߱Ӫȼ (ûбӪ 0)
+    // 获取当前玩家拥有的最高兵营等级 (如果没有兵营返回 0)
     UFUNCTION(BlueprintCallable, Category = "GameFlow")
         int32 GetCurrentTechLevel();
 
-    // ǷĿƼҪ
+    // 检查是否满足造兵的科技要求
     bool CheckUnitTechRequirement(EUnitType Type);
 
     UFUNCTION(BlueprintPure)
@@ -83,7 +90,7 @@ protected:
     UPROPERTY()
         class AGridManager* GridManager;
 
-    // --- ͼ (Classes|Units) ---
+    // --- 兵种蓝图配置 (Classes|Units) ---
     UPROPERTY(EditDefaultsOnly, Category = "Classes|Units")
         TSubclassOf<class ABaseUnit> BarbarianClass;
 
@@ -96,7 +103,7 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "Classes|Units")
         TSubclassOf<class ABaseUnit> BomberClass;
 
-        // --- ͼ (Classes|Buildings) ---
+        // --- 建筑蓝图配置 (Classes|Buildings) ---
     UPROPERTY(EditDefaultsOnly, Category = "Classes|Buildings")
         TSubclassOf<class ABaseBuilding> DefenseTowerClass;
 
@@ -112,17 +119,28 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "Classes|Buildings")
         TSubclassOf<class ABaseBuilding> HQClass;
 
-    // --- ؿ (ѡڼص) ---
+    // 战斗关卡开始时每个兵种预先放进对象池的单位数
+    UPROPERTY(EditDefaultsOnly, Category = "Classes|Units")
+        int32 UnitPoolPrewarmCount;
+
+    // --- 关卡数据 (可选，用于加载敌人配置) ---
     UPROPERTY(EditDefaultsOnly, Category = "Level Setup")
         ULevelDataAsset* CurrentLevelData;
 
-    // Ӫͼ
+    // 兵营蓝图
     UPROPERTY(EditDefaultsOnly, Category = "Classes|Buildings")
         TSubclassOf<class ABaseBuilding> BarracksClass;
 
-    // ڷֹظлؿ
+    // 用于防止重复切换关卡的锁
     bool bIsChangingLevel = false;
 
-    // ԶسǵĶʱֶȡ
+    // 批量结算的嵌套层数 / 期间是否有实体死亡 (需要判胜负)
+    int32 KillBatchDepth = 0;
+    bool bWinCheckPending = false;
+
+    // 保存自动回城的定时器句柄，方便手动取消
     FTimerHandle ReturnTimerHandle;
+
+    // 生成一个玩家单位：优先从对象池取，取不到对象池时照旧 SpawnActor
+    class ABaseUnit* SpawnPlayerUnit(TSubclassOf<class ABaseUnit> SpawnClass, const FVector& SpawnLoc);
 };
\ No newline at end of file
@@ -11,28 +11,28 @@ void URTSMainHUD::NativeConstruct()
 {
 	Super::NativeConstruct();
 
-	// 󶨵λť
+	// 绑定单位按钮
 	if (Btn_BuyBarbarian)  Btn_BuyBarbarian->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuyBarbarian);
 	if (Btn_BuyArcher)  Btn_BuyArcher->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuyArcher);
 	if (Btn_BuyGiant)   Btn_BuyGiant->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuyGiant);
 	if (Btn_BuyBomber)  Btn_BuyBomber->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuyBomber);
 
-	// 󶨽ť
+	// 绑定建筑按钮
 	if (Btn_BuildTower) Btn_BuildTower->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuildTower);
 	if (Btn_BuildMine)  Btn_BuildMine->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuildMine);
 	if (Btn_BuildElixir) Btn_BuildElixir->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuildElixir);
 	if (Btn_BuildWall)	Btn_BuildWall->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuildWall);
 	if (Btn_BuildBarracks)	Btn_BuildBarracks->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickBuildBarracks);
 
-	// ̰ť
+	// 绑定流程按钮
 	if (Btn_StartBattle) Btn_StartBattle->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickStartBattle);
 	
-	// Ƴť
+	// 绑定移除按钮
 	if (Btn_Remove) Btn_Remove->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickRemove);
 
-	// ť
+	// 建筑升级按钮
 	if (Btn_Upgrade) Btn_Upgrade->OnClicked.AddDynamic(this, &URTSMainHUD::OnClickUpgrade);
-	// Ĭ
+	// 默认隐藏
 	if (Btn_Upgrade) Btn_Upgrade->SetVisibility(ESlateVisibility::Hidden);
 }
 
@@ -46,10 +46,10 @@ void URTSMainHUD::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 		if (Text_GoldInfo)   Text_GoldInfo->SetText(FText::FromString(FString::Printf(TEXT("Gold: %d"), GI->PlayerGold)));
 		if (Text_ElixirInfo) Text_ElixirInfo->SetText(FText::FromString(FString::Printf(TEXT("Elixir: %d"), GI->PlayerElixir)));
 		
-		// ˿
+		// 更新人口
 		if (Text_PopulationInfo)
 		{
-			// ʽʾ Pop: 5 / 20
+			// 格式示例： Pop: 5 / 20
 			FString PopStr = FString::Printf(TEXT("Pop: %d / %d"),
 				GI->CurrentPopulation,
 				GI->MaxPopulation);
@@ -58,21 +58,24 @@ void URTSMainHUD::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 		}
 	}
 
-	// ̬ť
+	// 动态更新升级按钮
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC && Btn_Upgrade && Text_UpgradeCost)
 	{
-		// ѡеĽҸý
+		// 如果有选中的建筑，且该建筑属于玩家
+		int32 WallGoldCost = 0;
+		bool bWallCanUpgrade = false;
+
 		if (PC->SelectedBuilding && PC->SelectedBuilding->TeamID == ETeam::Player)
 		{
-			// ʾť
+			// 显示按钮
 			Btn_Upgrade->SetVisibility(ESlateVisibility::Visible);
 
-			// ȡ۸
+			// 获取升级价格
 			int32 GoldCost, ElixirCost;
 			PC->SelectedBuilding->GetUpgradeCost(GoldCost, ElixirCost);
 
-			// Ƿ
+			// 检查是否满级
 			if (PC->SelectedBuilding->CanUpgrade())
 			{
 				Text_UpgradeCost->SetText(FText::FromString(FString::Printf(TEXT("Upgrade (%d G)"), GoldCost)));
@@ -84,22 +87,31 @@ void URTSMainHUD::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 				Btn_Upgrade->SetIsEnabled(false);
 			}
 		}
+		// 选中的是墙 (墙没有 Actor，费用从 GridManager 查)
+		else if (PC->GetSelectedWallUpgradeCost(WallGoldCost, bWallCanUpgrade))
+		{
+			Btn_Upgrade->SetVisibility(ESlateVisibility::Visible);
+			Btn_Upgrade->SetIsEnabled(bWallCanUpgrade);
+			Text_UpgradeCost->SetText(bWallCanUpgrade
+				? FText::FromString(FString::Printf(TEXT("Upgrade (%d G)"), WallGoldCost))
+				: FText::FromString(TEXT("MAX LEVEL")));
+		}
 		else
 		{
-			// ûѡжذť
+			// 没选中东西，隐藏按钮
 			Btn_Upgrade->SetVisibility(ESlateVisibility::Hidden);
 		}
 	}
 
 	if (PC)
 	{
-		// ½̳
+		// 更新教程文字
 		if (Text_Tutorial)
 		{
-			//  Controller ĺȡǰӦʾ
+			// 调用 Controller 里的函数获取当前应该显示的文字
 			Text_Tutorial->SetText(PC->GetTutorialText());
 
-			// Ż̳ˣı			
+			// 优化：如果教程完成了，隐藏这个文本框			
 			if (PC->GetTutorialStep() == ETutorialStep::Completed)
 				Text_Tutorial->SetVisibility(ESlateVisibility::Hidden);
 			else
@@ -108,15 +120,15 @@ void URTSMainHUD::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 	}
 }
 
-// 黹
+// 辅助函数：处理点击并归还焦点
 void URTSMainHUD::OnClickBuyBarbarian()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
-		// ؼ
+		// 拦截检查
 		if (!PC->IsActionAllowed("BuyBarbarian"))
 		{
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
@@ -134,10 +146,10 @@ void URTSMainHUD::OnClickBuyArcher()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
-		// ؼ
+		// 拦截检查
 		if (!PC->IsActionAllowed("BuyArcher"))
 		{
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
@@ -155,10 +167,10 @@ void URTSMainHUD::OnClickBuyGiant()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
-		// ؼ
+		// 拦截检查
 		if (!PC->IsActionAllowed("BuyGiant"))
 		{
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
@@ -176,10 +188,10 @@ void URTSMainHUD::OnClickBuyBomber()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
-		// ؼ
+		// 拦截检查
 		if (!PC->IsActionAllowed("BuyBomber"))
 		{
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
@@ -198,15 +210,15 @@ void URTSMainHUD::OnClickBuildTower()
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
 		if (!PC->IsActionAllowed("BuildTower")) {
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // <--- 
+			return; // <--- 拦截
 		}
-		PC->OnSelectBuildingToPlace(EBuildingType::Defense); // ע⣺Ӧ GameMode switch 
+		PC->OnSelectBuildingToPlace(EBuildingType::Defense); // 注意：对应 GameMode switch 里的类型
 		PC->SetInputMode(FInputModeGameAndUI().SetHideCursorDuringCapture(false).SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock));
 	}
 }
@@ -216,13 +228,13 @@ void URTSMainHUD::OnClickBuildMine()
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
 		if (!PC->IsActionAllowed("BuildGoldMine")) {
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // <--- 
+			return; // <--- 拦截
 		}
 
 		PC->OnSelectBuildingToPlace(EBuildingType::GoldMine);
@@ -235,19 +247,19 @@ void URTSMainHUD::OnClickBuildElixir()
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC) {
 		if (!PC->IsActionAllowed("BuildElixir")) {
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // <--- 
+			return; // <--- 拦截
 		}
 
-		//  Controller Ҫʥˮռ
+		// 告诉 Controller 我要造圣水收集器
 		PC->OnSelectBuildingToPlace(EBuildingType::ElixirPump);
 
-		// 黹꽹
+		// 归还鼠标焦点
 		FInputModeGameAndUI InputMode;
 		InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
 		InputMode.SetHideCursorDuringCapture(false);
@@ -255,26 +267,26 @@ void URTSMainHUD::OnClickBuildElixir()
 	}
 }
 
-// ʵǽ߼
+// 实现造墙逻辑
 void URTSMainHUD::OnClickBuildWall()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC)
 	{
 		if (!PC->IsActionAllowed("BuildWall")) {
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // <--- 
+			return; // <--- 拦截
 		}
 
-		//  ControllerҪǽ
+		// 告诉 Controller：我要造墙
 		PC->OnSelectBuildingToPlace(EBuildingType::Wall);
 
-		// 黹꽹 (Ϲأֹ갴ťûذ)
+		// 归还鼠标焦点 (老规矩，防止点完按钮后没法点地板)
 		FInputModeGameAndUI InputMode;
 		InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
 		InputMode.SetHideCursorDuringCapture(false);
@@ -282,25 +294,25 @@ void URTSMainHUD::OnClickBuildWall()
 	}
 }
 
-// ʵӪ߼
+// 实现造兵营逻辑
 void URTSMainHUD::OnClickBuildBarracks()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 	if (PC)
 	{
 		if (!PC->IsActionAllowed("BuildBarracks")) {
-			// Ļʾ
+			// 屏幕红字提示
 			if (GEngine)
 			{
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // <--- 
+			return; // <--- 拦截
 		}
 
 		PC->OnSelectBuildingToPlace(EBuildingType::Barracks);
 
-		// 黹꽹
+		// 归还鼠标焦点
 		FInputModeGameAndUI InputMode;
 		InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
 		InputMode.SetHideCursorDuringCapture(false);
@@ -312,25 +324,25 @@ void URTSMainHUD::OnClickStartBattle()
 {
 	ARTSPlayerController* PC = Cast<ARTSPlayerController>(GetOwningPlayer());
 
-	//  Controller Ƿ
+	// 检查 Controller 是否允许
 	if (PC && !PC->IsActionAllowed("StartBattle")) {
-		// Ļʾ
+		// 屏幕红字提示
 		if (GEngine)
 		{
 			FString Tip = PC->GetTutorialText().ToString();
 			GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 		}
-		return; // <--- 
+		return; // <--- 拦截
 	}
 
 	ARTSGameMode* GM = Cast<ARTSGameMode>(UGameplayStatics::GetGameMode(this));
 	if (GM)
 	{
 
-		// ǽ̳һᴥ
+		// 如果是教程最后一步，这里会触发完成
 		if (PC) PC->AdvanceTutorial();
 
-		// սͼ "BattleField1"
+		// 假设战斗地图叫 "BattleField1"
 		GM->SaveAndStartBattle(FName("BattleField1"));
 	}
 }
@@ -347,11 +359,11 @@ void URTSMainHUD::OnClickRemove()
 				FString Tip = PC->GetTutorialText().ToString();
 				GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Tutorial: ") + Tip);
 			}
-			return; // أƳģʽ
+			return; // 被拦截，不进入移除模式
 		}
 
 		PC->OnSelectRemoveMode();
-		// 黹
+		// 归还焦点
 		FInputModeGameAndUI InputMode;
 		InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
 		InputMode.SetHideCursorDuringCapture(false);
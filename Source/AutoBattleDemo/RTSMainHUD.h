@@ -16,76 +16,76 @@ public:
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
 protected:
-	// --- Դʾ ---
+	// --- 资源显示 ---
 	UPROPERTY(meta = (BindWidget))
 		UTextBlock* Text_GoldInfo;
 
 	UPROPERTY(meta = (BindWidget))
 		UTextBlock* Text_ElixirInfo;
 
-	// --- ˿ʾ ---
+	// --- 人口显示 ---
 	UPROPERTY(meta = (BindWidget))
 		UTextBlock* Text_PopulationInfo;
 
-	// --- ťλ (ʥˮ) ---
+	// --- 按钮：单位 (消耗圣水) ---
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuyBarbarian;
 
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuyArcher;
 
-	//  & ը
+	// 巨人 & 炸弹人
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuyGiant;
 
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuyBomber;
 
-	//  (Ľ) ---
-	//  & 
+	// 建筑 (消耗金币) ---
+	// 塔 & 矿
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuildTower;
 
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuildMine;
 
-	// ʥˮռ
+	// 圣水收集器
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuildElixir;
 
-	// ǽť
+	// 造墙按钮
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuildWall;
 
-	// Ӫť
+	// 造兵营按钮
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_BuildBarracks;
 
 
 
-	// --- ť ---
+	// --- 按钮：流程 ---
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_StartBattle;
 
-	// --- ťƳ ---
+	// --- 按钮：移除 ---
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_Remove;
 
-	// ť
+	// 升级按钮
 	UPROPERTY(meta = (BindWidget))
 		UButton* Btn_Upgrade;
 
 	UPROPERTY(meta = (BindWidget))
-		UTextBlock* Text_UpgradeCost; // ʾ "Upgrade (500 G)"
+		UTextBlock* Text_UpgradeCost; // 显示 "Upgrade (500 G)"
 
-	 // ̳ʾı
+	 // 教程提示文本
 	UPROPERTY(meta = (BindWidget))
 		UTextBlock* Text_Tutorial;
 
 	
 
 
-	// --- ¼ ---
+	// --- 点击事件处理 ---
 	UFUNCTION() void OnClickBuyBarbarian();
 	UFUNCTION() void OnClickBuyArcher();
 	UFUNCTION() void OnClickBuyGiant();
@@ -8,9 +8,10 @@
 #include "RTSGameInstance.h"
 #include "RTSCoreTypes.h"
 #include "BaseUnit.h"
+#include "UnitPool.h"
 #include "BaseBuilding.h"
-#include "Building_Resource.h" // ڵռԴ
-#include "Building_Barracks.h" // ñӪ
+#include "Building_Resource.h" // 用于点击收集资源
+#include "Building_Barracks.h" // 引用兵营
 #include "Components/StaticMeshComponent.h"
 
 ARTSPlayerController::ARTSPlayerController()
@@ -26,8 +27,10 @@ ARTSPlayerController::ARTSPlayerController()
     PendingUnitType = EUnitType::Barbarian;
     PendingBuildingType = EBuildingType::None;
 
-    SelectedBuilding = nullptr; // ʼ
-    SelectedUnit = nullptr;     // ʼ
+    SelectedBuilding = nullptr; // 初始化
+    SelectedWallTile = FIntPoint(INDEX_NONE, INDEX_NONE);
+    SelectedUnit = nullptr;     // 初始化
+    GridManagerRef = nullptr;
 }
 
 void ARTSPlayerController::BeginPlay()
@@ -36,36 +39,36 @@ void ARTSPlayerController::BeginPlay()
 
     if (IsLocalPlayerController())
     {
-        // ȡǰͼ
+        // 获取当前地图名字
         FString MapName = GetWorld()->GetMapName();
-        // ȥǰ׺ (UE4 Mapͨ UEDPIE_0_ ǰ׺)
+        // 去掉前缀 (UE4 Map名通常带 UEDPIE_0_ 前缀)
         MapName.RemoveFromStart(GetWorld()->StreamingLevelsPrefix);
 
         UUserWidget* HUDToCreate = nullptr;
 
-        // --- ߼жϣͼ ---
-        if (MapName.Contains("BattleField")) // սͼ
+        // --- 逻辑判断：在哪张图？ ---
+        if (MapName.Contains("BattleField")) // 如果是战斗地图
         {
             if (BattleHUDClass)
             {
                 HUDToCreate = CreateWidget<UUserWidget>(this, BattleHUDClass);
             }
-            bShowMouseCursor = true; // ǿʾ
+            bShowMouseCursor = true; // 强制显示
             FInputModeGameAndUI InputMode;
             InputMode.SetLockMouseToViewportBehavior(EMouseLockMode::DoNotLock);
             SetInputMode(InputMode);
         }
-        else // Ĭǻصͼ (PlayerBase)
+        else // 默认是基地地图 (PlayerBase)
         {
             if (MainHUDClass)
             {
                 HUDToCreate = CreateWidget<UUserWidget>(this, MainHUDClass);
-                // 浽 MainHUDInstance ԺãҪ
+                // 保存到 MainHUDInstance 方便以后调用（如果有需要）
                 MainHUDInstance = Cast<URTSMainHUD>(HUDToCreate);
             }
         }
 
-        // --- ͳһʾ ---
+        // --- 统一显示 ---
         if (HUDToCreate)
         {
             HUDToCreate->AddToViewport();
@@ -77,7 +80,7 @@ void ARTSPlayerController::BeginPlay()
         }
     }
 
-    // ʼ̳
+    // 初始化教程
     InitTutorial();
 }
 
@@ -86,7 +89,7 @@ void ARTSPlayerController::InitTutorial()
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (!GI) return;
 
-    // 1. ̳ɣսͼֱӽ
+    // 1. 如果教程已完成，或者是在战斗地图，直接结束
     FString MapName = GetWorld()->GetMapName();
     if (GI->bTutorialFinished || MapName.Contains("BattleField"))
     {
@@ -94,76 +97,76 @@ void ARTSPlayerController::InitTutorial()
         return;
     }
 
-    // 2. ûɣݵǰж (ֹ¿)
-    // 磺Ȼû̳̽ȣѾ˱Ӫͱ
+    // 2. 如果没完成，根据当前情况智能判断 (防止坏档导致卡死)
+    // 比如：如果玩家虽然没存教程进度，但他已经造了兵营，就别让他重造了
 
-    // ǻǴ Welcome ʼҪԴ
+    // 简单起见，我们还是从 Welcome 开始，但要给足资源
     CurrentTutorialStep = ETutorialStep::Welcome;
 
-    // ȷǮһ
-    // ֻеǮ(150)ʱŲͱֹˢǮ
+    // 确保有钱造第一个金矿！
+    // 只有当钱不够造金矿(150)时，才补发低保，防止无限刷钱
     if (GI->PlayerGold < 200)
     {
         GI->PlayerGold = 200;
     }
 
-    // ֻеˮ(50)ʱŲ
-    // ( BuildGoldMine ׶ϣˮȲˮȵ׶ٷ)
+    // 只有当水不够造兵(50)时，才补发
+    // (但在 BuildGoldMine 阶段我们希望限制水，这里可以先不发水，等到了造兵阶段再发)
     if (CurrentTutorialStep == ETutorialStep::Welcome)
     {
-        // ֵʥˮ (ѡ)
+        // 保持低圣水，引导玩家造矿 (可选)
     }
 
     UE_LOG(LogTemp, Warning, TEXT("Tutorial Started at Step: Welcome"));
 }
 
-// 2. ģǷ ()
+// 2. 核心：检查操作是否允许 (白名单机制)
 bool ARTSPlayerController::IsActionAllowed(FString ActionName)
 {
-    // ̳ɣߴ浵Ϊɣв
+    // 如果教程已完成，或者存档里标记为完成，则允许所有操作
     URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
     if (CurrentTutorialStep == ETutorialStep::Completed || (GI && GI->bTutorialFinished))
     {
         return true;
     }
 
-    // ӭ׶Σֹκΰť
+    // 欢迎阶段：禁止点击任何按钮
     if (CurrentTutorialStep == ETutorialStep::Welcome) return false;
 
-    //  1: 
+    // 步骤 1: 造金矿
     if (CurrentTutorialStep == ETutorialStep::BuildGoldMine)
         return ActionName == "BuildGoldMine";
 
-    //  2: Ӫ
+    // 步骤 2: 造兵营
     if (CurrentTutorialStep == ETutorialStep::BuildBarracks)
         return ActionName == "BuildBarracks";
 
-    //  3: Ӫ (ѡУ)
+    // 步骤 3: 升级兵营 (允许选中，允许点击升级)
     if (CurrentTutorialStep == ETutorialStep::UpgradeBarracks)
         return ActionName == "Upgrade" || ActionName == "SelectBuilding";
 
-    //  4: 
+    // 步骤 4: 造兵
     if (CurrentTutorialStep == ETutorialStep::TrainBarbarian)
         return ActionName == "BuyBarbarian";
 
-    //  5: ƶ (ѡбƶ)
+    // 步骤 5: 移动兵 (允许选中兵，允许移动)
     if (CurrentTutorialStep == ETutorialStep::MoveUnit)
         return ActionName == "MoveUnit" || ActionName == "SelectUnit";
 
-    //  6: ʼս
+    // 步骤 6: 开始战斗
     if (CurrentTutorialStep == ETutorialStep::ClickStart)
         return ActionName == "StartBattle";
 
-    // ʽֹ Remove (ʵ߼ѾĬϽֹˣд)
+    // 显式禁止 Remove (其实下面的逻辑已经默认禁止了，但写出来更清晰)
     if (ActionName == "Remove") return false;
 
-    return false; // ȫֹ
+    return false; // 其他情况全部禁止
 }
 
-// 3. ģƽ̳״̬
+// 3. 核心：推进教程状态
 void ARTSPlayerController::AdvanceTutorial()
 {
-    // ״̬ת
+    // 状态流转
     switch (CurrentTutorialStep)
     {
     case ETutorialStep::Welcome:
@@ -173,7 +176,7 @@ void ARTSPlayerController::AdvanceTutorial()
 
     case ETutorialStep::BuildGoldMine:
         CurrentTutorialStep = ETutorialStep::BuildBarracks;
-        // Ӫ
+        // 奖励金币造兵营
         if (URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance())) GI->PlayerGold += 400;
         break;
 
@@ -183,7 +186,7 @@ void ARTSPlayerController::AdvanceTutorial()
 
     case ETutorialStep::UpgradeBarracks:
         CurrentTutorialStep = ETutorialStep::TrainBarbarian;
-        // ʥˮ
+        // 奖励圣水造兵
         if (URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance())) GI->PlayerElixir += 100;
         break;
 
@@ -197,7 +200,7 @@ void ARTSPlayerController::AdvanceTutorial()
 
     case ETutorialStep::ClickStart:
         CurrentTutorialStep = ETutorialStep::Completed;
-        // ɲ浵
+        // 标记完成并存档
         if (URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance()))
         {
             GI->bTutorialFinished = true;
@@ -222,16 +225,28 @@ FText ARTSPlayerController::GetTutorialText() const
     }
 }
 
+AGridManager* ARTSPlayerController::GetGridManager()
+{
+    if (!IsValid(GridManagerRef))
+    {
+        GridManagerRef = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+    }
+    return GridManagerRef;
+}
+
 void ARTSPlayerController::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
-    // 콨
+    // 提前拿好网格管理器，HUD 的 const 查询直接读缓存
+    GetGridManager();
+
+    // 无论是造兵还是造建筑，都更新幽灵和网格
     if (bIsPlacingUnit || bIsPlacingBuilding)
     {
         UpdatePlacementGhost();
 
-        AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+        AGridManager* GridManager = GetGridManager();
         if (GridManager)
         {
             int32 HoverX = -1;
@@ -247,11 +262,11 @@ void ARTSPlayerController::Tick(float DeltaTime)
         }
     }
 
-    // ̳̣ӭ׶μʱ
+    // 教程：欢迎阶段计时检查
     if (CurrentTutorialStep == ETutorialStep::Welcome)
     {
         static float WelcomeTimer = 0.0f;
-        // Ƿ (򵥴3ѧƶͷ)
+        // 检测是否有输入 (简单处理：过了3秒就算学会移动镜头了)
         WelcomeTimer += DeltaTime;
         if (WelcomeTimer > 5.0f)
         {
@@ -263,14 +278,14 @@ void ARTSPlayerController::Tick(float DeltaTime)
 
 void ARTSPlayerController::OnSelectUnitToPlace(EUnitType UnitType)
 {
-    // ʲУʸ
+    // 先问问裁判，我有资格造这个兵吗？
     ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
     if (GM)
     {
         if (!GM->CheckUnitTechRequirement(UnitType))
         {
-            // Ҫֱ˳ģʽ
-            // CheckUnitTechRequirement ڲѾӡ˺ʾ
+            // 如果不满足要求，直接退出，不进入放置模式
+            // CheckUnitTechRequirement 内部已经打印了红字提示
             return;
         }
     }
@@ -279,16 +294,16 @@ void ARTSPlayerController::OnSelectUnitToPlace(EUnitType UnitType)
     bIsPlacingUnit = true;
     bIsPlacingBuilding = false;
 
-    // --- 鵱ǰǷƥ ---
+    // --- 检查当前幽灵是否匹配 ---
 
-    // ǰ飬ǡ顱 (֮ǰǽ)
+    // 如果当前有幽灵，但它不是“兵种幽灵”的类型 (比如之前是建筑幽灵)
     if (PreviewGhostActor && PreviewGhostActor->GetClass() != PlacementPreviewClass)
     {
-        PreviewGhostActor->Destroy(); // پɵ
+        PreviewGhostActor->Destroy(); // 销毁旧的
         PreviewGhostActor = nullptr;
     }
 
-    // û飬һµ (ְ)
+    // 如果没有幽灵，生成一个新的 (兵种版)
     if (!PreviewGhostActor && PlacementPreviewClass)
     {
         PreviewGhostActor = GetWorld()->SpawnActor<AActor>(PlacementPreviewClass, FVector::ZeroVector, FRotator::ZeroRotator);
@@ -297,7 +312,7 @@ void ARTSPlayerController::OnSelectUnitToPlace(EUnitType UnitType)
     if (PreviewGhostActor)
     {
         PreviewGhostActor->SetActorHiddenInGame(false);
-        // һ²ʣֹɫ
+        // 在这里重置一下材质，防止残留红色
         UStaticMeshComponent* Mesh = PreviewGhostActor->FindComponentByClass<UStaticMeshComponent>();
         if(Mesh && ValidPlacementMaterial) Mesh->SetMaterial(0, ValidPlacementMaterial);
     }
@@ -309,16 +324,16 @@ void ARTSPlayerController::OnSelectBuildingToPlace(EBuildingType BuildingType)
     bIsPlacingBuilding = true;
     bIsPlacingUnit = false;
 
-    // --- [߼] 鵱ǰǷƥ ---
+    // --- [核心逻辑] 检查当前幽灵是否匹配 ---
 
-    // ǰ飬ǡ顱
+    // 如果当前有幽灵，但它不是“建筑幽灵”的类型
     if (PreviewGhostActor && PreviewGhostActor->GetClass() != PlacementPreviewBuildingClass)
     {
-        PreviewGhostActor->Destroy(); // پɵ
+        PreviewGhostActor->Destroy(); // 销毁旧的
         PreviewGhostActor = nullptr;
     }
 
-    // û飬һµ ()
+    // 如果没有幽灵，生成一个新的 (建筑版)
     if (!PreviewGhostActor && PlacementPreviewBuildingClass)
     {
         PreviewGhostActor = GetWorld()->SpawnActor<AActor>(PlacementPreviewBuildingClass, FVector::ZeroVector, FRotator::ZeroRotator);
@@ -343,29 +358,29 @@ void ARTSPlayerController::OnSelectRemoveMode()
 
 bool ARTSPlayerController::CancelCurrentAction()
 {
-    // Ƿڽе״̬
+    // 检查是否有正在进行的状态
     if (bIsPlacingUnit || bIsPlacingBuilding || bIsRemoving)
     {
-        // ״̬־
+        // 重置所有状态标志
         bIsPlacingUnit = false;
         bIsPlacingBuilding = false;
         bIsRemoving = false;
 
-        // 
+        // 隐藏幽灵
         if (PreviewGhostActor)
         {
             PreviewGhostActor->SetActorHiddenInGame(true);
         }
 
-        // ƶλȡʱҪԭ
+        // 如果是在移动单位，取消时要还原
         if (UnitBeingMoved)
         {
-            // 1. ʾ
+            // 1. 重新显示
             UnitBeingMoved->SetActorHiddenInGame(false);
             UnitBeingMoved->SetActorEnableCollision(true);
 
-            // 2. 
-            AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+            // 2. 重新锁定格子
+            AGridManager* GridManager = GetGridManager();
             if (GridManager)
             {
                 int32 X, Y;
@@ -375,35 +390,35 @@ bool ARTSPlayerController::CancelCurrentAction()
                 }
             }
 
-            // 3. 
+            // 3. 清空引用
             UnitBeingMoved = nullptr;
             if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Orange, TEXT("Move Cancelled - Unit Restored"));
         }
 
-        // ӡʾ
+        // 打印提示
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Orange, TEXT("Action Cancelled"));
 
-        return true; // ߵߣҸɻ
+        return true; // 告诉调用者：我干活了
     }
 
-    return false; // ߵߣû¸
+    return false; // 告诉调用者：我没事干
 }
 
 void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManager* GridManager)
 {
-    // 飺ڷģʽ£㵽˱Ӫƶ
+    // 特殊检查：在放置模式下，如果点到了兵营，且正在移动兵
     AActor* HitActor = Hit.GetActor();
     if (UnitBeingMoved && bIsPlacingUnit)
     {
         ABuilding_Barracks* Barracks = Cast<ABuilding_Barracks>(HitActor);
         if (Barracks && Barracks->TeamID == ETeam::Player)
         {
-            // ԴӪ
+            // 尝试存入兵营
             bool bStored = Barracks->StoreUnit(UnitBeingMoved);
 
             if (bStored)
             {
-                // --- ɹ״̬ ---
+                // --- 成功：清理状态 ---
                 UnitBeingMoved = nullptr;
                 bIsPlacingUnit = false;
                 if (PreviewGhostActor) PreviewGhostActor->SetActorHiddenInGame(true);
@@ -412,18 +427,18 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
             }
             else
             {
-                // --- ʧ ()ԭʿ ---
-                // ֱӵȡ߼ѱŻԭλ
+                // --- 失败 (满了)：还原士兵 ---
+                // 直接调用取消逻辑，把兵放回原位
                 CancelCurrentAction();
 
                 if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Failed to store! Unit restored."));
             }
-            return; // ߼
+            return; // 结束逻辑
         }
     }
 
     int32 X, Y;
-    // ǷЧ
+    // 检查是否点在有效网格内
     if (!GridManager->WorldToGrid(Hit.Location, X, Y)) return;
 
     ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
@@ -431,67 +446,68 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
 
     bool bSuccess = false;
 
-    //  vs 콨
+    // 分流：造兵 vs 造建筑
     if (bIsPlacingUnit)
     {
-        // 1.  (ƶȥ)
+        // 1. 区域限制 (无论是买还是移动，都不能去敌区)
         if (X >= 8)
         {
             if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Must place in Deployment Zone (X < 8)!"));
             return;
         }
 
-        // 2. жǡƶɱǡ±
+        // 2. 判断是【移动旧兵】还是【购买新兵】
         if (UnitBeingMoved)
         {
-            // ƶģʽ (Move)
-            // Ƿ
+            // 移动模式 (Move)
+            // 检查格子是否可走
             if (GridManager->IsTileWalkable(X, Y))
             {
-                // ʹ SpawnUnitAt (ֻɣǮڲԶ +1 ˿)
-                bSuccess = GM->SpawnUnitAt(PendingUnitType, X, Y);
+                // 使用 SpawnUnitAt (只生成，不扣钱，但内部会自动 +1 人口)
+                bSuccess = (GM->SpawnUnitAt(PendingUnitType, X, Y) != nullptr);
 
                 if (bSuccess)
                 {
-                    // ƶӦ˿
-                    // SpawnUnitAt  1Ҫֶ 1
+                    // 移动不应该增加总人口
+                    // SpawnUnitAt 加了 1，所以我们要手动减 1，保持总量不变
                     /*URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
                     if (GI)
                     {
                         GI->CurrentPopulation = FMath::Max(0, GI->CurrentPopulation - 1);
                     }*/
 
-                    // پɵı
-                    UnitBeingMoved->Destroy();
-                    UnitBeingMoved = nullptr; // ָÿ
+                    // 旧的兵放回对象池
+                    if (AUnitPool* Pool = AUnitPool::Get(this)) Pool->Release(UnitBeingMoved);
+                    else UnitBeingMoved->Destroy();
+                    UnitBeingMoved = nullptr; // 指针置空
                 }
             }
         }
         else
         {
-            // ģʽ (Buy)
+            // 购买模式 (Buy)
             int32 Cost = 50;
             if (PendingUnitType == EUnitType::Archer) Cost = 100;
             else if (PendingUnitType == EUnitType::Giant) Cost = 300;
             else if (PendingUnitType == EUnitType::Bomber) Cost = 150;
 
-            // ʹ TryBuyUnit (Ǯ˿)
+            // 使用 TryBuyUnit (扣钱，加人口)
             bSuccess = GM->TryBuyUnit(PendingUnitType, Cost, X, Y);
         }
 
-        // ɹ˳ģʽ
+        // 无论哪种情况，成功后退出放置模式
         if (bSuccess) bIsPlacingUnit = false;
 
                 
-        // ǰǡҰˡ
+        // 如果当前是【造野蛮人】步骤
         if (CurrentTutorialStep == ETutorialStep::TrainBarbarian && PendingUnitType == EUnitType::Barbarian)
         {
             AdvanceTutorial();
         }
 
-        // 4. ǰǡƶ (Ҵƶģʽ)
-        // UnitBeingMoved ʱѾÿˣǿԼжϣ
-        // ֻҪ MoveUnit 跢һγɹ Unit ã
+        // 4. 如果当前是【移动】步骤 (且处于移动模式)
+        // UnitBeingMoved 此时可能已经被置空了，所以我们可以简单判断：
+        // 只要是在 MoveUnit 步骤发生了一次成功的 Unit 放置，就算过关
         if (CurrentTutorialStep == ETutorialStep::MoveUnit)
         {
             AdvanceTutorial();
@@ -499,11 +515,11 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
     }
     else if (bIsPlacingBuilding)
     {
-        // ֻڰ (X < 8) 
+        // 玩家只能在半区 (X < 8) 放
         if (X >= 8)
         {
             if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Must place in Deployment Zone (X < 8)!"));
-            return; // ֱӷأִй
+            return; // 直接返回，不执行购买
         }
 
         int32 Cost = 200;
@@ -516,7 +532,7 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
 
         if (bSuccess) bIsPlacingBuilding = false;
 
-        //// ̳ж
+        //// 教程判定
         //if (bSuccess)
         //{
         //    if (CurrentTutorialStep == ETutorialStep::BuildGoldMine && PendingBuildingType == EBuildingType::GoldMine)
@@ -530,18 +546,18 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
         //}
     }
 
-    // ͳһ
+    // 统一处理反馈
     if (bSuccess)
     {
         if (PreviewGhostActor) PreviewGhostActor->SetActorHiddenInGame(true);
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Yellow, TEXT("Placed Successfully!"));
 
-        // ǰǡ󡿲裬ȷʵ˽ -> һ
+        // 如果当前是【造金矿】步骤，且确实造了金矿 -> 下一步
         if (CurrentTutorialStep == ETutorialStep::BuildGoldMine && PendingBuildingType == EBuildingType::GoldMine)
         {
             AdvanceTutorial();
         }
-        // ǰǡӪ裬ȷʵ˱Ӫ -> һ
+        // 如果当前是【造兵营】步骤，且确实造了兵营 -> 下一步
         else if (CurrentTutorialStep == ETutorialStep::BuildBarracks && PendingBuildingType == EBuildingType::Barracks)
         {
             AdvanceTutorial();
@@ -555,26 +571,26 @@ void ARTSPlayerController::HandlePlacementMode(const FHitResult& Hit, AGridManag
 
 void ARTSPlayerController::HandleRemoveMode(AActor* HitActor, AGridManager* GridManager)
 {
-    // תΪϷʵ
+    // 尝试转换为游戏实体
     ABaseGameEntity* Entity = Cast<ABaseGameEntity>(HitActor);
 
-    // ֻɾԼĶ
+    // 只能删玩家自己的东西
     if (Entity && Entity->TeamID == ETeam::Player)
     {
-        // [] ӪƳƼ
+        // [新增] 兵营移除限制检查
         ABuilding_Barracks* Barracks = Cast<ABuilding_Barracks>(HitActor);
         if (Barracks)
         {
             URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
             if (GI)
             {
-                // 1. ȡӪṩ˿
+                // 1. 获取这个兵营提供的人口
                 int32 PopBonus = Barracks->GetCurrentCapacity(Barracks->BuildingLevel);
 
-                // 2. Ƴ˿
+                // 2. 计算移除后的人口上限
                 int32 FutureMaxPop = GI->MaxPopulation - PopBonus;
 
-                // 3. Ƴ < ǰ˿ڣֹƳ
+                // 3. 如果移除后，上限 < 当前人口，禁止移除！
                 if (FutureMaxPop < GI->CurrentPopulation)
                 {
                     UE_LOG(LogTemp, Warning, TEXT("Cannot remove Barracks! Population would overflow (%d > %d)"),
@@ -582,44 +598,44 @@ void ARTSPlayerController::HandleRemoveMode(AActor* HitActor, AGridManager* Grid
 
                     if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Cannot Remove! Population limit too low!"));
 
-                    return; // ֱӷأִк߼
+                    return; // 直接返回，不执行后面的销毁逻辑
                 }
             }
         }
 
-        // Ƿ HQ
+        // 检查是否是 HQ
         ABaseBuilding* Building = Cast<ABaseBuilding>(HitActor);
         if (Building)
         {
             if (Building->BuildingType == EBuildingType::Headquarters)
             {
                 if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Cannot Remove HQ!"));
-                return; // ֱӷأִ
+                return; // 直接返回，不执行销毁
             }
         }
 
-        // 񣺽
+        // 解锁网格：建筑
         if (Building && GridManager)
         {
             GridManager->SetTileBlocked(Building->GridX, Building->GridY, false);
         }
 
-        // ʿ
+        // 士兵
         ABaseUnit* Unit = Cast<ABaseUnit>(HitActor);
         if (Unit && GridManager)
         {
-            // ʿ
+            // 解锁网格：士兵
             /*int32 UX, UY;
             if (GridManager->WorldToGrid(Unit->GetActorLocation(), UX, UY))
             {
                 GridManager->SetTileBlocked(UX, UY, false);
             }*/
 
-            // ˿ (̶ -1)
+            // 返还人口 (固定 -1)
             URTSGameInstance* GI = Cast<URTSGameInstance>(GetGameInstance());
             if (GI)
             {
-                // ֻҪɾһ˿ھͼ 1С 0
+                // 只要删了一个兵，人口就减 1，最小减到 0
                 GI->CurrentPopulation = FMath::Max(0, GI->CurrentPopulation - 1);
 
                 UE_LOG(LogTemp, Log, TEXT("Unit Removed. Population -1. Current: %d/%d"),
@@ -627,10 +643,12 @@ void ARTSPlayerController::HandleRemoveMode(AActor* HitActor, AGridManager* Grid
             }
         }
 
-        // 
-        Entity->Destroy();
+        // 销毁 (士兵放回对象池)
+        AUnitPool* Pool = Unit ? AUnitPool::Get(this) : nullptr;
+        if (Pool) Pool->Release(Unit);
+        else Entity->Destroy();
 
-        // ˳Ƴģʽ
+        // 退出移除模式
         bIsRemoving = false;
 
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Entity Removed"));
@@ -642,14 +660,14 @@ void ARTSPlayerController::StartRepositioningSelectedUnit()
     if (!SelectedUnit) return;
     if (SelectedUnit->IsPendingKill()) return;
 
-    // 1. ¼ƶı
+    // 1. 记录正在移动的兵
     UnitBeingMoved = SelectedUnit;
 
-    // 2.  (װ)
+    // 2. 隐藏它 (假装拿起来了)
     UnitBeingMoved->SetActorHiddenInGame(true);
-    UnitBeingMoved->SetActorEnableCollision(false); // رײֹߴԼ
+    UnitBeingMoved->SetActorEnableCollision(false); // 关闭碰撞，防止射线打到它自己
 
-    // 3. ԭĸ
+    // 3. 解锁它原来的格子
     /*AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
     if (GridManager)
     {
@@ -660,11 +678,11 @@ void ARTSPlayerController::StartRepositioningSelectedUnit()
         }
     }*/
 
-    // 4. ģʽ (߼)
-    // ע⣺ﲻÿǮΪֻƶ
+    // 4. 进入放置模式 (复用造兵逻辑)
+    // 注意：这里不用扣钱，因为我们只是移动
     OnSelectUnitToPlace(UnitBeingMoved->UnitType);
 
-    // ѡ״̬
+    // 清空选中状态
     SelectedUnit = nullptr;
 
     if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Yellow, TEXT("Repositioning Unit..."));
@@ -672,7 +690,7 @@ void ARTSPlayerController::StartRepositioningSelectedUnit()
 
 void ARTSPlayerController::HandleNormalMode(AActor* HitActor)
 {
-    // 1. ԵԴ (ռԴ) - ԭ
+    // 1. 尝试点击资源建筑 (收集资源) - 保持原样
     ABuilding_Resource* ResBuilding = Cast<ABuilding_Resource>(HitActor);
     if (ResBuilding)
     {
@@ -685,51 +703,51 @@ void ARTSPlayerController::HandleNormalMode(AActor* HitActor)
                 if (ResBuilding->bProducesGold) GI->PlayerGold += Amount;
                 else GI->PlayerElixir += Amount;
             }
-            // return; // ռԴͲѡв(ѡ)
+            // return; // 如果收集了资源，就不算选中操作了(可选)
         }
     }
 
-    // 2. ѡ߼
-    // һ ()
+    // 2. 选中逻辑
+    // 如果点击的是一个建筑 (且属于玩家)
     ABaseBuilding* ClickedBuilding = Cast<ABaseBuilding>(HitActor);
     if (ClickedBuilding && ClickedBuilding->TeamID == ETeam::Player)
     {
         SelectedBuilding = ClickedBuilding;
 
-        // ӡ־
+        // 打印日志
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Cyan,
             FString::Printf(TEXT("Selected: %s (Lv.%d)"), *ClickedBuilding->GetName(), ClickedBuilding->BuildingLevel));
     }
     else
     {
-        // ˵ذ -> ȡѡ
+        // 点击了地板或敌人 -> 取消选中
         SelectedBuilding = nullptr;
     }
 
-    // ԵӪ
+    // 尝试点击兵营
     ABuilding_Barracks* Barracks = Cast<ABuilding_Barracks>(HitActor);
     if (Barracks && Barracks->TeamID == ETeam::Player)
     {
-        //  Aѡ˸ -> ȥ
+        // 场景 A：手里选了个兵 -> 存进去
         if (SelectedUnit)
         {
-            // ȷû
+            // 确保兵活着且没死
             if (SelectedUnit->IsValidLowLevel() && !SelectedUnit->IsPendingKill())
             {                
-                // 鷵ֵ
+                // 检查返回值
                 if (Barracks->StoreUnit(SelectedUnit))
                 {
-                    SelectedUnit = nullptr; // ˣѡ
+                    SelectedUnit = nullptr; // 存完了，清空选中
                     if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Green, TEXT("Unit Stored!"));
                 }
                 else
                 {
-                    // ˣѡУ֪ûȥ
+                    // 满了，不清除选中，让玩家知道没存进去
                 }
                 return;
             }
         }
-        //  Bû -> ѱӪıų
+        // 场景 B：手里没兵 -> 把兵营里的兵放出来
         else
         {
             Barracks->ReleaseAllUnits();
@@ -738,39 +756,39 @@ void ARTSPlayerController::HandleNormalMode(AActor* HitActor)
         }
     }
 
-    // Եʿ (ѡ)
+    // 尝试点击士兵 (选中)
     ABaseUnit* ClickedUnit = Cast<ABaseUnit>(HitActor);
     if (ClickedUnit && ClickedUnit->TeamID == ETeam::Player)
     {
-        // 1. ѡ (κʱ򶼿ѡв鿴)
+        // 1. 选中它 (任何时候都可以选中查看属性)
         SelectedUnit = ClickedUnit;
 
-        // 2. ȡ GameMode ״̬
+        // 2. 获取 GameMode 检查状态
         ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
 
         if (GM && GM->GetCurrentState() == EGameState::Preparation)
         {
-            // ֻڡս׶Ρ()ƶ
+            // 只有在【备战阶段】(基地)，才能拿起并移动
             StartRepositioningSelectedUnit();
             if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Cyan, TEXT("Unit Picked Up!"));
         }
         else
         {
-            // ڡս׶Ρƶֻܿ
+            // 在【战斗阶段】，不能移动，只能看着
             if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Red, TEXT("Cannot move units during battle!"));
         }
 
         return;
     }
 
-    // 3. յ -> ȡѡ
+    // 3. 点击空地 -> 取消选中
     SelectedUnit = nullptr;
 }
 
-// 
+// 请求升级
 void ARTSPlayerController::RequestUpgradeSelectedBuilding()
 {
-    // Ȩ޼
+    // 权限检查
     if (!IsActionAllowed("Upgrade")) return;
 
     if (SelectedBuilding)
@@ -778,29 +796,55 @@ void ARTSPlayerController::RequestUpgradeSelectedBuilding()
         ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
         if (GM && GM->TryUpgradeBuilding(SelectedBuilding))
         {
-            // ̳ж
+            // 教程判定
             if (CurrentTutorialStep == ETutorialStep::UpgradeBarracks && SelectedBuilding->BuildingType == EBuildingType::Barracks)
             {
                 AdvanceTutorial();
             }
         }
     }
+    else if (SelectedWallTile.X != INDEX_NONE)
+    {
+        ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
+        AGridManager* GridManager = GetGridManager();
+        if (GM && GridManager)
+        {
+            GM->TryUpgradeWall(GridManager->GetWallAt(SelectedWallTile.X, SelectedWallTile.Y));
+        }
+    }
+}
+
+bool ARTSPlayerController::GetSelectedWallUpgradeCost(int32& OutGold, bool& bOutCanUpgrade) const
+{
+    if (SelectedWallTile.X == INDEX_NONE) return false;
+
+    const int32 WallIndex = IsValid(GridManagerRef) ? GridManagerRef->GetWallAt(SelectedWallTile.X, SelectedWallTile.Y) : INDEX_NONE;
+    if (WallIndex == INDEX_NONE) return false;
+
+    int32 ElixirCost = 0;
+    OutGold = 0;
+    bOutCanUpgrade = GridManagerRef->GetWallUpgradeCost(WallIndex, OutGold, ElixirCost);
+    return true;
 }
 
 void ARTSPlayerController::HandleLeftClick()
 {
-    // 1. ȡ߼
+    // 1. 获取射线检测结果
     FHitResult Hit;
     GetHitResultUnderCursor(ECC_Visibility, false, Hit);
 
-    // 2. ȡ
-    AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+    // 2. 获取常用引用
+    AGridManager* GridManager = GetGridManager();
     AActor* HitActor = Hit.GetActor();
 
-    // 3. ģʽַ
+    // 墙都画在 GridManager 的实例化网格体上，点中的是哪一段按实例下标查
+    const int32 HitWall = GridManager ? GridManager->GetWallFromHit(Hit) : INDEX_NONE;
+    const FGridWall* Wall = (HitWall != INDEX_NONE) ? GridManager->GetWall(HitWall) : nullptr;
+
+    // 3. 模式分发
     if (bIsPlacingUnit || bIsPlacingBuilding)
     {
-        // ģʽ㵽ϲŴ
+        // 放置模式：必须点到网格上才处理
         if (Hit.bBlockingHit && GridManager)
         {
             HandlePlacementMode(Hit, GridManager);
@@ -808,16 +852,38 @@ void ARTSPlayerController::HandleLeftClick()
     }
     else if (bIsRemoving)
     {
-        // Ƴģʽ㵽Ŵ
-        if (HitActor)
+        // 移除模式：必须点到物体才处理 (墙只能删自己的)
+        if (Wall)
+        {
+            if (Wall->Team == ETeam::Player)
+            {
+                GridManager->RemoveWall(HitWall);
+                bIsRemoving = false;
+                if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red, TEXT("Entity Removed"));
+            }
+        }
+        else if (HitActor)
         {
             HandleRemoveMode(HitActor, GridManager);
         }
     }
     else
     {
-        // ͨģʽռԴѡ
-        if (HitActor)
+        SelectedWallTile = FIntPoint(INDEX_NONE, INDEX_NONE);
+
+        // 普通模式：选中墙 (只能选自己的)，或者收集资源/选中建筑和单位
+        if (Wall)
+        {
+            SelectedBuilding = nullptr;
+            SelectedUnit = nullptr;
+            if (Wall->Team == ETeam::Player)
+            {
+                SelectedWallTile = Wall->Tile;
+                if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Cyan,
+                    FString::Printf(TEXT("Selected: Wall (Lv.%d)"), Wall->Level));
+            }
+        }
+        else if (HitActor)
         {
             HandleNormalMode(HitActor);
         }
@@ -839,7 +905,7 @@ void ARTSPlayerController::UpdatePlacementGhost()
 
     if (Hit.bBlockingHit)
     {
-        AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
+        AGridManager* GridManager = GetGridManager();
         if (GridManager)
         {
             int32 X, Y;
@@ -847,7 +913,7 @@ void ARTSPlayerController::UpdatePlacementGhost()
             {
                 FVector SnapPos = GridManager->GridToWorld(X, Y);
 
-                // ܼ Z ߶
+                // 智能计算 Z 轴高度
                 FVector Origin, BoxExtent;
                 PreviewGhostActor->GetActorBounds(false, Origin, BoxExtent);
                 float HoverHeight = BoxExtent.Z + 2.0f;
@@ -856,12 +922,12 @@ void ARTSPlayerController::UpdatePlacementGhost()
                 PreviewGhostActor->SetActorLocation(SnapPos);
 
 
-                // л߼
+                // 材质切换逻辑
 
-                // 1. 飺Ƿ赲
+                // 1. 基础检查：格子是否被阻挡
                 bool bTileWalkable = GridManager->IsTileWalkable(X, Y);
 
-                // 2. 飺Ƿ X < 8 
+                // 2. 区域检查：是否在 X < 8 区域
                 bool bInValidZone = true;
                 if (bIsPlacingUnit || bIsPlacingBuilding)
                 {
@@ -871,16 +937,16 @@ void ARTSPlayerController::UpdatePlacementGhost()
                     }
                 }
 
-                // 3. ۺжϣȿߣЧڣǡɫ
+                // 3. 综合判断：必须既可走，又在有效区域内，才是“绿色”
                 bool bCanPlace = bTileWalkable && bInValidZone;
 
-                // 4. Ӧò
+                // 4. 应用材质
                 UStaticMeshComponent* MeshComp = PreviewGhostActor->FindComponentByClass<UStaticMeshComponent>();
                 if (MeshComp)
                 {
                     if (bCanPlace)
                     {
-                        // ɫ
+                        // 绿色材质
                         if (ValidPlacementMaterial)
                         {
                             MeshComp->SetMaterial(0, ValidPlacementMaterial);
@@ -888,7 +954,7 @@ void ARTSPlayerController::UpdatePlacementGhost()
                     }
                     else
                     {
-                        // ɫ
+                        // 红色材质
                         if (InvalidPlacementMaterial)
                         {
                             MeshComp->SetMaterial(0, InvalidPlacementMaterial);
@@ -905,39 +971,40 @@ void ARTSPlayerController::SetupInputComponent()
     Super::SetupInputComponent();
     InputComponent->BindAction("LeftClick", IE_Pressed, this, &ARTSPlayerController::HandleLeftClick);
 
-    //  Esc
+    // 绑定 Esc
     InputComponent->BindAction("PauseMenu", IE_Pressed, this, &ARTSPlayerController::OnPressEsc);
 }
 
 void ARTSPlayerController::OnPressEsc()
 {
-    // 1. ȳȡǰ (/Ƴ/ѡ)
-    //  CancelCurrentAction  true˵ղŴڷģʽȡˣ߼
+    // 1. 优先尝试取消当前操作 (造兵/移除/选中)
+    // 如果 CancelCurrentAction 返回 true，说明刚才处于放置模式，现在取消了，逻辑结束
     if (CancelCurrentAction())
     {
         return;
     }
 
-    // 2. ѡеλУȡѡ
-    if (SelectedUnit || SelectedBuilding)
+    // 2. 还有选中单位吗？如果有，取消选中
+    if (SelectedUnit || SelectedBuilding || SelectedWallTile.X != INDEX_NONE)
     {
         SelectedUnit = nullptr;
         SelectedBuilding = nullptr;
-        // ˳֪ͨ UI ť (Tick Զ﷢㲥)
+        SelectedWallTile = FIntPoint(INDEX_NONE, INDEX_NONE);
+        // 顺便通知 UI 隐藏升级按钮 (Tick 里会自动处理，或者你可以在这里发广播)
         if (GEngine) GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Cyan, TEXT("Selection Cleared"));
         return;
     }
 
-    // 3. ݵͼȥ
+    // 3. 根据地图决定去向
     FString MapName = GetWorld()->GetMapName();
     ARTSGameMode* GM = Cast<ARTSGameMode>(GetWorld()->GetAuthGameMode());
 
-    // ս -> ִг (ᱣҴߣȻػ)
+    // 如果在战场 -> 执行撤退 (这会保存幸存者，然后回基地)
     if (MapName.Contains("BattleField") && GM)
     {
         GM->ReturnToBase();
     }
-    // ڻ -> ˵ (ǵñز)
+    // 如果在基地 -> 回主菜单 (记得保存基地布局)
     else
     {    
         if (GM)
@@ -947,9 +1014,9 @@ void ARTSPlayerController::OnPressEsc()
 
             if (GI && GI->bTutorialFinished)
             {
-                GM->SaveBaseLayout(); // Ȱѽ GI
-                GM->SavePlayerUnits(); // 
-                GI->SaveGameToDisk(); // дӲ
+                GM->SaveBaseLayout(); // 先把建筑存进 GI
+                GM->SavePlayerUnits(); // 存兵
+                GI->SaveGameToDisk(); // 写入硬盘
                 UE_LOG(LogTemp, Warning, TEXT("Game Saved (Tutorial Complete). Returning to Menu."));
             }
             else
@@ -17,59 +17,66 @@ public:
     virtual void SetupInputComponent() override;
     virtual void BeginPlay() override;
 
-    // --- ߼ ---
+    // --- 交互逻辑 ---
 
-    // ҵUIϵġλ
+    // 玩家点击了UI上的“购买单位”
     UFUNCTION(BlueprintCallable)
         void OnSelectUnitToPlace(EUnitType UnitType);
 
-    // ҵUIϵġ콨
+    // 玩家点击了UI上的“建造建筑”
     UFUNCTION(BlueprintCallable)
         void OnSelectBuildingToPlace(EBuildingType BuildingType);
 
-    // 
+    // 鼠标点击左键
     UFUNCTION(BlueprintCallable)
         void HandleLeftClick();
 
-    //  HUD ãִ
+    // 供 HUD 调用：执行升级
     UFUNCTION(BlueprintCallable)
         void RequestUpgradeSelectedBuilding();
 
-    //  HUD ȡǰѡеĽ (ʾϢ)
+    // 供 HUD 获取：当前选中的建筑 (用于显示信息)
     UPROPERTY(BlueprintReadOnly, Category = "Selection")
         class ABaseBuilding* SelectedBuilding;
 
-    // ѡƳģʽ
+    // 当前选中的墙所在的格子 (墙没有 Actor；没选中时为 -1)
+    UPROPERTY(BlueprintReadOnly, Category = "Selection")
+        FIntPoint SelectedWallTile;
+
+    // 供 HUD 获取：选中的墙的升级费用，没选中墙时返回 false
+    bool GetSelectedWallUpgradeCost(int32& OutGold, bool& bOutCanUpgrade) const;
+
+    // 选择移除模式
     UFUNCTION(BlueprintCallable)
         void OnSelectRemoveMode();
 
-    // ǰѡеҷλ
+    // 当前选中的我方单位
     UPROPERTY(BlueprintReadOnly, Category = "Selection")
         class ABaseUnit* SelectedUnit;
 
-    //  Esc 
+    // 处理 Esc 按键
     void OnPressEsc();
 
-    // ʼƶѡеĵλ
+    // 开始移动选中的单位
     UFUNCTION(BlueprintCallable)
         void StartRepositioningSelectedUnit();
 
-    // ȡǰ
-    //  true ʾɹȡĳ
-    //  false ʾǰû¿
+    // 尝试取消当前操作
+    // 返回 true 表示成功取消了某个操作
+    // 返回 false 表示当前没事可做
     bool CancelCurrentAction();
 
-    // ǰ̳̲
+    // 当前教程步骤
     UPROPERTY(BlueprintReadOnly, Category = "Tutorial")
         ETutorialStep CurrentTutorialStep;
 
-    // ƽ̵̳һ
+    // 推进教程到下一步
     void AdvanceTutorial();
 
-    // ĳǷ񱻽̳
+    // 检查某个操作是否被教程允许
     bool IsActionAllowed(FString ActionName);
 
-    //  HUD ãʾǰ̳ʾ (󶨸 UI Text)
+    // 供 HUD 调用：显示当前教程提示 (绑定给 UI Text)
     UFUNCTION(BlueprintCallable, Category = "Tutorial")
         FText GetTutorialText() const;
 
@@ -77,61 +84,67 @@ public:
         ETutorialStep GetTutorialStep() const { return CurrentTutorialStep; }
 
 protected:
-    // UI 
+    // UI 配置
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI")
         TSubclassOf<URTSMainHUD> MainHUDClass;
 
-    // ս UI 
+    // 战斗 UI 配置
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI")
-        TSubclassOf<UUserWidget> BattleHUDClass; // սõ UI ģ
+        TSubclassOf<UUserWidget> BattleHUDClass; // 战斗用的 UI 模板
 
     UPROPERTY()
         URTSMainHUD* MainHUDInstance;
 
-    //  Actor
+    // 幽灵 Actor
     UPROPERTY()
         AActor* PreviewGhostActor;
 
 
-    // ֵ
+    // 兵种的幽灵
     UPROPERTY(EditDefaultsOnly, Category = "UI")
         TSubclassOf<AActor> PlacementPreviewClass;
 
-    // 
+    // 建筑的幽灵
     UPROPERTY(EditDefaultsOnly, Category = "UI")
         TSubclassOf<AActor> PlacementPreviewBuildingClass;
 
-    // λ
+    // 辅助函数：更新幽灵位置
     void UpdatePlacementGhost();
 
-    // л
+    // 用于幽灵材质切换
     UPROPERTY(EditDefaultsOnly, Category = "UI|Placement")
-        class UMaterialInterface* ValidPlacementMaterial; // ϷʱĲ
+        class UMaterialInterface* ValidPlacementMaterial; // 合法放置时的材质
 
     UPROPERTY(EditDefaultsOnly, Category = "UI|Placement")
-        UMaterialInterface* InvalidPlacementMaterial; // ǷʱĲ
+        UMaterialInterface* InvalidPlacementMaterial; // 非法放置时的材质
 
-    // ڱƶĵλ
+    // 正在被移动的单位
     UPROPERTY()
         class ABaseUnit* UnitBeingMoved;
 
     
-    // ʼ̳
+    // 初始化教程
     void InitTutorial();
 
 
 private:
-    // ǰ״̬
+    // 当前状态数据
     EUnitType PendingUnitType;
     EBuildingType PendingBuildingType;
 
     bool bIsPlacingUnit;
     bool bIsPlacingBuilding;
 
-    // ǷƳģʽ
+    // 是否处于移除模式
     bool bIsRemoving;
 
-    // ߼
+    // 网格管理器：第一次用到时查找并缓存 (HUD 每帧读墙的升级费用，不能每次都遍历 Actor)
+    UPROPERTY()
+        AGridManager* GridManagerRef;
+
+    AGridManager* GetGridManager();
+
+    // 逻辑拆分
     void HandlePlacementMode(const FHitResult& Hit, AGridManager* GridManager);
     void HandleRemoveMode(AActor* HitActor, AGridManager* GridManager);
     void HandleNormalMode(AActor* HitActor);
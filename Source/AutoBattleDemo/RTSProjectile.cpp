@@ -1,63 +1,26 @@
 #include "RTSProjectile.h"
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "BaseGameEntity.h"
 
 ARTSProjectile::ARTSProjectile()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bCanEverTick = false;
 
     MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
     RootComponent = MeshComp;
-    MeshComp->SetCollisionProfileName(TEXT("NoCollision")); // ӵײ߼ж
+    MeshComp->SetCollisionProfileName(TEXT("NoCollision")); // 子弹本身不负责碰撞，靠逻辑判断
 
     MovementComp = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("MovementComp"));
     MovementComp->InitialSpeed = 1000.0f;
     MovementComp->MaxSpeed = 1000.0f;
     MovementComp->bRotationFollowsVelocity = true;
-    MovementComp->bIsHomingProjectile = true; // ؼ׷ٵ
-    MovementComp->HomingAccelerationMagnitude = 5000.0f; // ׷
-}
-
-void ARTSProjectile::Initialize(AActor* NewTarget, float NewDamage, AActor* NewInstigator)
-{
-    TargetActor = NewTarget;
-    Damage = NewDamage;
-    DamageInstigator = NewInstigator;
-
-    // ׷Ŀ
-    if (TargetActor && MovementComp)
-    {
-        MovementComp->HomingTargetComponent = TargetActor->GetRootComponent();
-    }
+    MovementComp->bAutoActivate = false;
 
-    // 5Ի٣ֹĿʧӵɵĺǣ
-    SetLifeSpan(5.0f);
+    SplashRadius = 0.0f;
+    SplashFalloff = 0.5f;
 }
 
-void ARTSProjectile::Tick(float DeltaTime)
+float ARTSProjectile::GetSpeed() const
 {
-    Super::Tick(DeltaTime);
-
-    if (TargetActor)
-    {
-        // 򵥵ľ⣺ɵùˣ˺
-        float Distance = FVector::Dist(GetActorLocation(), TargetActor->GetActorLocation());
-        if (Distance < 50.0f) // ֵ
-        {
-            // ˺
-            UGameplayStatics::ApplyDamage(TargetActor, Damage, GetInstigatorController(), DamageInstigator, UDamageType::StaticClass());
-
-            // ɱըЧ (SpawnEmitterAtLocation)
-
-            // ӵ
-            Destroy();
-        }
-    }
-    else
-    {
-        // Ŀ궼ûˣҲû
-        Destroy();
-    }
-}
\ No newline at end of file
+    return MovementComp ? FMath::Max(MovementComp->InitialSpeed, 1.0f) : 1000.0f;
+}
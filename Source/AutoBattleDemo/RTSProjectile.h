@@ -3,6 +3,11 @@
 #include "GameFramework/Actor.h"
 #include "RTSProjectile.generated.h"
 
+/**
+ * 子弹类型定义 (BP_Arrow 等蓝图的父类)
+ * 子弹不再生成 Actor：AProjectileManager 只读取类默认对象上的网格体和速度，
+ * 发射时解出命中时间，同一类型的所有子弹用一个实例化网格体渲染
+ */
 UCLASS()
 class AUTOBATTLEDEMO_API ARTSProjectile : public AActor
 {
@@ -10,22 +15,26 @@ class AUTOBATTLEDEMO_API ARTSProjectile : public AActor
 
 public:
     ARTSProjectile();
-    virtual void Tick(float DeltaTime) override;
 
-    // ʼӵ˭ģ˭˺
-    void Initialize(AActor* NewTarget, float NewDamage, AActor* NewInstigator);
+    // --- 供 AProjectileManager 读取 (类默认对象) ---
+    const class UStaticMeshComponent* GetMeshComponent() const { return MeshComp; }
+    float GetSpeed() const;
+    float GetSplashRadius() const { return SplashRadius; }
+    float GetSplashFalloff() const { return SplashFalloff; }
 
 protected:
     UPROPERTY(VisibleAnywhere, Category = "Components")
         class UStaticMeshComponent* MeshComp;
 
+    // 只用来在蓝图里配置速度 (InitialSpeed)
     UPROPERTY(VisibleAnywhere, Category = "Components")
         class UProjectileMovementComponent* MovementComp;
 
-    // Ŀ
-    UPROPERTY()
-        AActor* TargetActor;
+    // 溅射半径 (BP_CannonBall 等)：大于 0 时命中点周围的敌人都会受到伤害，0 = 只打目标
+    UPROPERTY(EditDefaultsOnly, Category = "Splash")
+        float SplashRadius;
 
-    float Damage;
-    AActor* DamageInstigator; // ˭ģ˭
-};
\ No newline at end of file
+    // 溅射边缘损失的伤害比例 (0 = 不衰减，1 = 边缘为 0)
+    UPROPERTY(EditDefaultsOnly, Category = "Splash", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+        float SplashFalloff;
+};
@@ -22,15 +22,15 @@ public:
     UPROPERTY(VisibleAnywhere, Category = "SaveData")
         TArray<FBuildingSaveData> SavedBuildings;
 
-    // ̳̽ҲҪ棬ֹ´νϷִͷһ
+    // 教程进度也要存，防止下次进游戏又从头教一遍
     UPROPERTY(VisibleAnywhere, Category = "SaveData")
         bool bTutorialFinished;
 
-    // ̳̾嵽һ
+    // 如果你想存教程具体到了哪一步
     UPROPERTY(VisibleAnywhere, Category = "SaveData")
         ETutorialStep CurrentTutorialStep;
 
-    // 浵 (Ĭ "Slot1")
+    // 存档槽名 (默认 "Slot1")
     UPROPERTY(VisibleAnywhere, Category = "Basic")
         FString SaveSlotName;
 
@@ -1,102 +1,69 @@
 #include "Soldier_Archer.h"
 #include "RTSProjectile.h" 
+#include "ProjectileManager.h"
 #include "BaseBuilding.h"
-#include "Components/StaticMeshComponent.h" // 
+#include "CrowdManager.h"
+#include "Components/StaticMeshComponent.h" // 必须引用
 
 ASoldier_Archer::ASoldier_Archer()
 {
-    // ñ
+    // 设置兵种类型
     UnitType = EUnitType::Archer;
 
-    // 
+    // 弓箭手属性
     MaxHealth = 80.0f;
     AttackRange = 500.0f;
     Damage = 12.0f;
     MoveSpeed = 200.0f;
     AttackInterval = 1.2f;
+    AttackLeash = 50.0f;
+    bUseAttackSlot = false; // 远程，在射程边上就停下
+    ProjectileManagerRef = nullptr;
 }
 
 void ASoldier_Archer::BeginPlay()
 {
     Super::BeginPlay();
 
+    if (ProjectileClass) ProjectileManagerRef = AProjectileManager::Get(this);
+
     UE_LOG(LogTemp, Warning, TEXT("[Archer] %s spawned | HP: %f | Range: %f"),
         *GetName(), MaxHealth, AttackRange);
 }
 
 void ASoldier_Archer::PerformAttack()
 {
-    if (!CurrentTarget)
-    {
-        CurrentState = EUnitState::Idle;
-        return;
-    }
+    // 距离和冷却已在决策阶段判定过，这里只负责开火
+    // 目标可能是墙 (只有句柄)
+    const FEntityHandle Target = GetCurrentTargetHandle();
+    if (!IsTargetAlive(Target)) return;
 
-    ABaseGameEntity* TargetEntity = Cast<ABaseGameEntity>(CurrentTarget);
-    if (!TargetEntity || TargetEntity->CurrentHealth <= 0)
+    // 本帧前面的射手已经把它打成必死了：这一箭省下来，下次决策换目标
+    if (ProjectileClass && CrowdManagerRef->IsTargetDoomed(Target))
     {
-        CurrentTarget = nullptr;
-        CurrentState = EUnitState::Idle;
+        CrowdManagerRef->NoteDoomedTargetSkipped();
         return;
     }
 
-    // ʹñж (Surface Distance)
-    float DistToSurface = FLT_MAX;
-
-    // 1. Ŀ
-    UPrimitiveComponent* TargetPrim = Cast<UPrimitiveComponent>(CurrentTarget->GetRootComponent());
-    if (!TargetPrim) TargetPrim = CurrentTarget->FindComponentByClass<UStaticMeshComponent>();
+    LastAttackTime = GetWorld()->GetTimeSeconds();
 
-    if (TargetPrim)
+    // 生成投射物
+    if (ProjectileClass)
     {
-        FVector ClosestPt;
-        // ȡ
-        TargetPrim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-        ClosestPt.Z = GetActorLocation().Z; // Ĩƽ߶
-        DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-    }
-    else
-    {
-        // ףľ
-        DistToSurface = FVector::Dist(GetActorLocation(), CurrentTarget->GetActorLocation());
-    }
+        FVector SpawnLoc = GetActorLocation() + FVector(0, 0, 100); // 从头顶发射
 
-    // 룺 ( + )׷
-    if (DistToSurface > (AttackRange + 50.0f))
-    {
-        RequestPathToTarget();
-        if (PathPoints.Num() > 0)
+        // 子弹只是管理器里的一条记录，不再生成 Actor
+        if (!IsValid(ProjectileManagerRef)) ProjectileManagerRef = AProjectileManager::Get(this);
+        if (ProjectileManagerRef)
         {
-            CurrentState = EUnitState::Moving;
+            ProjectileManagerRef->Launch(ProjectileClass, SpawnLoc, Target, Damage, this);
         }
-        return;
     }
-
-    // ִй
-    float CurrentTime = GetWorld()->GetTimeSeconds();
-    if (CurrentTime - LastAttackTime >= AttackInterval)
+    else
     {
-        LastAttackTime = CurrentTime;
-
-        // Ͷ
-        if (ProjectileClass)
-        {
-            FVector SpawnLoc = GetActorLocation() + FVector(0, 0, 100); // ͷ
-            FRotator SpawnRot = (CurrentTarget->GetActorLocation() - SpawnLoc).Rotation();
-
-            ARTSProjectile* Arrow = GetWorld()->SpawnActor<ARTSProjectile>(ProjectileClass, SpawnLoc, SpawnRot);
-            if (Arrow)
-            {
-                Arrow->Initialize(CurrentTarget, Damage, this);
-            }
-        }
-        else
-        {
-            // ֱ˺
-            FDamageEvent DamageEvent;
-            CurrentTarget->TakeDamage(Damage, DamageEvent, nullptr, this);
-        }
-
-        UE_LOG(LogTemp, Log, TEXT("Archer Fired Arrow!"));
+        // 保底直接伤害
+        DealDamage(Target, Damage);
     }
+
+    UE_LOG(LogTemp, Log, TEXT("Archer Fired Arrow!"));
 }
\ No newline at end of file
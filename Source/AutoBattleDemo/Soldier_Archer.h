@@ -4,8 +4,8 @@
 #include "Soldier_Archer.generated.h"
 
 /**
- *  - Զ̵λ
- * ص㣺Զ̹ҪߵĿ
+ * 弓箭手 - 远程单位
+ * 特点：远程攻击，不需要走到目标脸上
  */
 UCLASS()
 class AUTOBATTLEDEMO_API ASoldier_Archer : public ABaseUnit
@@ -18,6 +18,10 @@ public:
     virtual void BeginPlay() override;
 
 protected:
-    // д߼Զ̹Ҫƶս
+    // 重写攻击逻辑：远程攻击不需要移动到近战距离
     virtual void PerformAttack() override;
+
+    // 子弹管理器 (BeginPlay 时取一次，开火时不再查找)
+    UPROPERTY()
+        class AProjectileManager* ProjectileManagerRef;
 };
\ No newline at end of file
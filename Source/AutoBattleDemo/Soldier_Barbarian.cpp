@@ -2,10 +2,10 @@
 
 ASoldier_Barbarian::ASoldier_Barbarian()
 {
-    // ñ
+    // 设置兵种类型
     UnitType = EUnitType::Barbarian;
 
-    // Ұ
+    // 野蛮人属性
     MaxHealth = 150.0f;
     AttackRange = 150.0f;
 
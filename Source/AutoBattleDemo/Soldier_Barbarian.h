@@ -7,8 +7,8 @@
 #include "Soldier_Barbarian.generated.h"
 
 /**
- * Ұ - ĬϽսλ
- * ص㣺ѪսĽ
+ * 野蛮人 - 默认近战单位
+ * 特点：高血量，近战攻击，找最近的建筑打
  */
 UCLASS()
 class AUTOBATTLEDEMO_API ASoldier_Barbarian : public ABaseUnit
@@ -1,6 +1,6 @@
 #include "Soldier_Bomber.h"
 #include "BaseBuilding.h"
-#include "GridManager.h"
+#include "CrowdManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
 #include "Components/StaticMeshComponent.h"
@@ -10,10 +10,11 @@ ASoldier_Bomber::ASoldier_Bomber()
 {
     UnitType = EUnitType::Bomber;
     MaxHealth = 50.0f;
-    AttackRange = 100.0f; // ըֶ̣Ҫ
+    AttackRange = 100.0f; // 炸弹人手短，要贴近
     Damage = 0.0f;
     MoveSpeed = 350.0f;
     AttackInterval = 0.0f;
+    AttackLeash = 20.0f;
 
     ExplosionRadius = 300.0f;
     ExplosionDamage = 200.0f;
@@ -24,112 +25,13 @@ void ASoldier_Bomber::BeginPlay()
     Super::BeginPlay();
 }
 
-// дѰǽʹá롿
-AActor* ASoldier_Bomber::FindClosestTarget()
-{
-    TArray<AActor*> AllBuildings;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), AllBuildings);
-
-    AActor* ClosestWall = nullptr;
-    float ClosestWallDist = FLT_MAX;
-
-    AActor* ClosestOther = nullptr;
-    float ClosestOtherDist = FLT_MAX;
-
-    for (AActor* Actor : AllBuildings)
-    {
-        ABaseBuilding* Building = Cast<ABaseBuilding>(Actor);
-
-        if (Building && Building->TeamID != this->TeamID && Building->CurrentHealth > 0 && Building->bIsTargetable)
-        {
-            // 
-            float DistToSurface = FLT_MAX;
-            UPrimitiveComponent* Prim = Cast<UPrimitiveComponent>(Building->GetRootComponent());
-            if (!Prim) Prim = Building->FindComponentByClass<UStaticMeshComponent>();
-
-            if (Prim)
-            {
-                FVector ClosestPt;
-                Prim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-                ClosestPt.Z = GetActorLocation().Z;
-                DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-            }
-            else
-            {
-                DistToSurface = FVector::Dist(GetActorLocation(), Building->GetActorLocation());
-            }
-            
-            // ǽ
-            if (Building->BuildingType == EBuildingType::Wall)
-            {
-                if (DistToSurface <= AttackRange) return Building; // ǽֱը
-
-                if (DistToSurface < ClosestWallDist)
-                {
-                    ClosestWallDist = DistToSurface;
-                    ClosestWall = Building;
-                }
-            }
-            else
-            {
-                if (DistToSurface < ClosestOtherDist)
-                {
-                    ClosestOtherDist = DistToSurface;
-                    ClosestOther = Building;
-                }
-            }
-        }
-    }
-
-    if (ClosestWall) return ClosestWall;
-    return ClosestOther;
-}
-
-// ִԱǰж
+// 距离已在决策阶段判定过 (射程 + 20 的缓冲)，走到这里直接引爆
 void ASoldier_Bomber::PerformAttack()
 {
-    if (!CurrentTarget)
-    {
-        CurrentState = EUnitState::Idle;
-        return;
-    }
-
-    ABaseGameEntity* TargetEntity = Cast<ABaseGameEntity>(CurrentTarget);
-    if (!TargetEntity || TargetEntity->CurrentHealth <= 0)
-    {
-        CurrentTarget = nullptr;
-        CurrentState = EUnitState::Idle;
-        return;
-    }
-
-    // ٴμ (ֹûߵը)
-    float DistToSurface = FLT_MAX;
-    UPrimitiveComponent* Prim = Cast<UPrimitiveComponent>(CurrentTarget->GetRootComponent());
-    if (!Prim) Prim = CurrentTarget->FindComponentByClass<UStaticMeshComponent>();
-
-    if (Prim)
-    {
-        FVector ClosestPt;
-        Prim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-        ClosestPt.Z = GetActorLocation().Z;
-        DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-    }
-    else
-    {
-        DistToSurface = FVector::Dist(GetActorLocation(), CurrentTarget->GetActorLocation());
-    }
-    
-    // 뻹 (һ㻺)
-    if (DistToSurface > (AttackRange + 20.0f))
-    {
-        RequestPathToTarget();
-        if (PathPoints.Num() > 0) CurrentState = EUnitState::Moving;
-        return;
-    }
-
-    // 빻ˣBOOM
-    UE_LOG(LogTemp, Warning, TEXT("[Bomber] %s Reached target %s (Dist: %f), EXPLODING!"),
-        *GetName(), *CurrentTarget->GetName(), DistToSurface);
+    // 距离够了，BOOM！
+    const ABaseGameEntity* Target = GetCurrentTarget();
+    UE_LOG(LogTemp, Warning, TEXT("[Bomber] %s Reached target %s, EXPLODING!"),
+        *GetName(), Target ? *Target->GetName() : TEXT("wall"));
 
     SuicideAttack();
 }
@@ -138,62 +40,32 @@ void ASoldier_Bomber::SuicideAttack()
 {
     FVector ExplosionCenter = GetActorLocation();
 
-    // 1. Ч
+    // 1. 特效
     if (ExplosionVFX)
     {
         UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionVFX, ExplosionCenter, FRotator::ZeroRotator, FVector(3.0f));
     }
 
-    // 2. Χ˺
-    TArray<AActor*> AllBuildings;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), AllBuildings);
-
-    int32 HitCount = 0;
-    TArray<ABaseBuilding*> DestroyedWalls;
-
-    for (AActor* Actor : AllBuildings)
-    {
-        ABaseBuilding* Building = Cast<ABaseBuilding>(Actor);
-        // ըǵ
-        if (Building && Building->TeamID != this->TeamID && Building->CurrentHealth > 0)
-        {
-            float Distance = FVector::Dist(ExplosionCenter, Building->GetActorLocation());
-
-            // ֻҪڱը뾶 (ע⣺ľжըΧǺģΪըε)
-            if (Distance <= ExplosionRadius)
-            {
-                float HealthBefore = Building->CurrentHealth;
-
-                FDamageEvent DamageEvent;
-                // ǽ 5  ˺ (ը)
-                float FinalDamage = ExplosionDamage;
-                if (Building->BuildingType == EBuildingType::Wall) FinalDamage *= 5.0f;
-
-                Building->TakeDamage(FinalDamage, DamageEvent, nullptr, this);
-                HitCount++;
-
-                // ¼ըٵǽ
-                if (Building->BuildingType == EBuildingType::Wall &&
-                    HealthBefore > 0 && Building->CurrentHealth <= 0)
-                {
-                    DestroyedWalls.Add(Building);
-                }
-            }
-        }
-    }
-
-    // 3. ֪ͨ GridManager 
-    if (DestroyedWalls.Num() > 0 && GridManagerRef)
+    // 2. 范围伤害：只炸敌方建筑，对墙造成 5 倍伤害 (炸弹人特性)
+    // 爆炸是球形的，用中心距离判定；伤害在帧末结算，炸毁的墙由群体管理器统一通知 GridManager 解锁格子
+    if (IsValid(CrowdManagerRef))
     {
-        for (ABaseBuilding* Wall : DestroyedWalls)
-        {
-            if (Wall->GridX >= 0 && Wall->GridY >= 0)
-            {
-                GridManagerRef->SetTileBlocked(Wall->GridX, Wall->GridY, false);
-            }
-        }
+        FRadialDamageParams Params;
+        Params.Center = ExplosionCenter;
+        Params.Radius = ExplosionRadius;
+        Params.BaseDamage = ExplosionDamage;
+        Params.TeamMask = FRadialDamageParams::EnemiesOf(TeamID);
+        Params.SetMultiplier(ERadialDamageCategory::Unit, 0.0f);
+        Params.SetMultiplier(ERadialDamageCategory::Wall, 5.0f);
+
+        FRadialDamageResult Result;
+        CrowdManagerRef->ApplyRadialDamage(Params, this, &Result);
+
+        UE_LOG(LogTemp, Log, TEXT("[Bomber] %s hit %d buildings for %.0f damage"),
+            *GetName(), Result.NumHits, Result.TotalDamage);
     }
 
-    // 4. Լ
-    Destroy();
+    // 3. 自爆等于阵亡：走统一的死亡流程 (句柄失效、通知攻击者和 GameMode)，帧末由群体管理器放回对象池
+    CurrentHealth = 0.0f;
+    Die();
 }
\ No newline at end of file
@@ -4,8 +4,8 @@
 #include "Soldier_Bomber.generated.h"
 
 /**
- * ը - Աλ
- * ص㣺ǽߵԱԱɸ߶Χ˺
+ * 炸弹人 - 自爆单位
+ * 特点：优先找墙，走到旁边自爆，造成高额范围伤害
  */
 UCLASS()
 class AUTOBATTLEDEMO_API ASoldier_Bomber : public ABaseUnit
@@ -17,7 +17,7 @@ public:
 
     virtual void BeginPlay() override;
 
-    // ԱΧ˺
+    // 自爆范围伤害
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomb")
         float ExplosionRadius;
 
@@ -25,21 +25,18 @@ public:
         float ExplosionDamage;
 
 protected:
-    // дĿѰңǽ
-    virtual AActor* FindClosestTarget() override;
-
-    // дԱ߼
+    // 重写攻击：自爆逻辑
     virtual void PerformAttack() override;
 
-    // ըʱЧ (ϵͳ)
+    // 爆炸时的特效 (粒子系统)
     UPROPERTY(EditDefaultsOnly, Category = "Visuals")
         class UParticleSystem* ExplosionVFX;
 
-    // [] ըЧ (ѡ)
+    // [新增] 爆炸音效 (可选)
     /*UPROPERTY(EditDefaultsOnly, Category = "Visuals")
         class USoundBase* ExplosionSound;*/
 
 private:
-    // ִԱ
+    // 执行自爆
     void SuicideAttack();
 };
\ No newline at end of file
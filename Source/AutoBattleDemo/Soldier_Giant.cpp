@@ -1,8 +1,4 @@
 #include "Soldier_Giant.h"
-#include "Building_Defense.h"
-#include "BaseBuilding.h"
-#include "Kismet/GameplayStatics.h"
-#include "Components/StaticMeshComponent.h" // 
 
 ASoldier_Giant::ASoldier_Giant()
 {
@@ -18,75 +14,3 @@ void ASoldier_Giant::BeginPlay()
 {
     Super::BeginPlay();
 }
-
-// дѰҷʹá롿
-AActor* ASoldier_Giant::FindClosestTarget()
-{
-    // ȡн (ͨ)
-    TArray<AActor*> AllBuildings;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABaseBuilding::StaticClass(), AllBuildings);
-
-    AActor* ClosestDefense = nullptr;
-    float ClosestDefenseDist = FLT_MAX;
-
-    AActor* ClosestBuilding = nullptr;
-    float ClosestBuildingDist = FLT_MAX;
-
-    for (AActor* Actor : AllBuildings)
-    {
-        ABaseBuilding* Building = Cast<ABaseBuilding>(Actor);
-
-        // ˣǵˣһţҿɱ
-        if (Building && Building->TeamID != this->TeamID && Building->CurrentHealth > 0 && Building->bIsTargetable)
-        {
-            //  (Surface Distance)
-            float DistToSurface = FLT_MAX;
-            UPrimitiveComponent* Prim = Cast<UPrimitiveComponent>(Building->GetRootComponent());
-            if (!Prim) Prim = Building->FindComponentByClass<UStaticMeshComponent>();
-
-            if (Prim)
-            {
-                FVector ClosestPt;
-                Prim->GetClosestPointOnCollision(GetActorLocation(), ClosestPt);
-                ClosestPt.Z = GetActorLocation().Z;
-                DistToSurface = FVector::Dist(GetActorLocation(), ClosestPt);
-            }
-            else
-            {
-                DistToSurface = FVector::Dist(GetActorLocation(), Building->GetActorLocation());
-            }
-            
-            // ж
-            if (Building->IsA(ABuilding_Defense::StaticClass()))
-            {
-                // Ƿ
-                if (DistToSurface <= AttackRange) return Building; // ֱӴ
-
-                if (DistToSurface < ClosestDefenseDist)
-                {
-                    ClosestDefenseDist = DistToSurface;
-                    ClosestDefense = Building;
-                }
-            }
-            else
-            {
-                // ͨ
-                if (DistToSurface < ClosestBuildingDist)
-                {
-                    ClosestBuildingDist = DistToSurface;
-                    ClosestBuilding = Building;
-                }
-            }
-        }
-    }
-
-    // ȼû
-    if (ClosestDefense)
-    {
-        // UE_LOG(LogTemp, Log, TEXT("[Giant] Targeting Defense: %s"), *ClosestDefense->GetName());
-        return ClosestDefense;
-    }
-
-    // UE_LOG(LogTemp, Log, TEXT("[Giant] Targeting Building: %s"), *ClosestBuilding->GetName());
-    return ClosestBuilding;
-}
\ No newline at end of file
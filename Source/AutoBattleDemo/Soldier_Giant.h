@@ -4,8 +4,8 @@
 #include "Soldier_Giant.generated.h"
 
 /**
- *  - ȹ
- * ص㣺ѪѰҲ
+ * 巨人 - 优先攻击防御塔
+ * 特点：超高血量，优先寻找并攻击防御建筑
  */
 UCLASS()
 class AUTOBATTLEDEMO_API ASoldier_Giant : public ABaseUnit
@@ -16,8 +16,4 @@ public:
     ASoldier_Giant();
 
     virtual void BeginPlay() override;
-
-protected:
-    // дĿѰңȹ
-    virtual AActor* FindClosestTarget() override;
 };
\ No newline at end of file
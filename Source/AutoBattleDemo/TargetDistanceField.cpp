@@ -0,0 +1,270 @@
+#include "TargetDistanceField.h"
+
+namespace
+{
+    // 四方向，与 GridManager 的 A* 一致
+    const int32 FieldDirections[4][2] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
+
+    // 开放列表：(距离, 格子下标)，距离相同时按下标，保证结果确定
+    typedef TPair<int32, int32> FFieldOpenEntry;
+
+    struct FFieldOpenLess
+    {
+        bool operator()(const FFieldOpenEntry& A, const FFieldOpenEntry& B) const
+        {
+            return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+        }
+    };
+}
+
+void FTargetDistanceField::Update(int32 InWidth, int32 InHeight, const TArray<bool>& InBlocked, const TArray<FTargetFieldSource>& InSources)
+{
+    LastUpdatedTiles = 0;
+
+    const int32 NumTiles = InWidth * InHeight;
+    if (NumTiles <= 0 || InBlocked.Num() != NumTiles)
+    {
+        Reset();
+        return;
+    }
+
+    // 网格尺寸变了 (重新加载关卡)：重建
+    if (InWidth != Width || InHeight != Height)
+    {
+        Width = InWidth;
+        Height = InHeight;
+        Blocked = InBlocked;
+        Rebuild(InSources);
+        return;
+    }
+
+    // 1. 阻挡变化：新增阻挡可能切断已有的最短路，直接重建；解除阻挡的格子 (墙被拆) 记下来增量扩散
+    TArray<int32> DirtyTiles;
+    for (int32 Index = 0; Index < NumTiles; ++Index)
+    {
+        if (InBlocked[Index] == Blocked[Index]) continue;
+
+        if (InBlocked[Index])
+        {
+            Blocked = InBlocked;
+            Rebuild(InSources);
+            return;
+        }
+        DirtyTiles.Add(Index);
+    }
+    for (int32 Index : DirtyTiles)
+    {
+        Blocked[Index] = false;
+    }
+
+    // 2. 目标变化：对比上次的目标列表，新出现的追加槽位，消失的置空
+    const int32 NumOldSources = Sources.Num();
+    TArray<bool> KeepSource;
+    KeepSource.Init(false, NumOldSources);
+
+    bool bHasNewSources = false;
+    for (const FTargetFieldSource& Source : InSources)
+    {
+        const int32* Existing = SourceIndexMap.Find(Source.Target);
+        if (Existing && *Existing < NumOldSources && Sources[*Existing].TileX == Source.TileX && Sources[*Existing].TileY == Source.TileY)
+        {
+            KeepSource[*Existing] = true;
+            continue;
+        }
+
+        SourceIndexMap.Add(Source.Target, Sources.Add(Source));
+        bHasNewSources = true;
+    }
+
+    TArray<bool> RemovedSource;
+    RemovedSource.Init(false, Sources.Num());
+    bool bHasRemovedSources = false;
+    for (int32 SourceIndex = 0; SourceIndex < NumOldSources; ++SourceIndex)
+    {
+        FTargetFieldSource& Source = Sources[SourceIndex];
+        if (KeepSource[SourceIndex] || !Source.Target.IsSet()) continue;
+
+        const int32* Existing = SourceIndexMap.Find(Source.Target);
+        if (Existing && *Existing == SourceIndex) SourceIndexMap.Remove(Source.Target);
+
+        Source.Target.Reset();
+        RemovedSource[SourceIndex] = true;
+        bHasRemovedSources = true;
+        ++NumRemovedSources;
+    }
+
+    // 空槽位太多时重建一次，顺便压缩
+    if (NumRemovedSources > 64 && NumRemovedSources * 2 > Sources.Num())
+    {
+        Rebuild(InSources);
+        return;
+    }
+
+    // 3. 最近目标已经消失的格子全部失效 (它们的最短路只经过同一目标的格子)
+    if (bHasRemovedSources)
+    {
+        for (int32 Index = 0; Index < NumTiles; ++Index)
+        {
+            if (Owner[Index] != INDEX_NONE && RemovedSource[Owner[Index]])
+            {
+                Distance[Index] = MAX_int32;
+                Owner[Index] = INDEX_NONE;
+                DirtyTiles.Add(Index);
+            }
+        }
+    }
+
+    if (DirtyTiles.Num() == 0 && !bHasNewSources) return;
+
+    // 4. 从失效区域的边界重新扩散；所有目标重新播种 (墙被拆后外围可能多出可站的格子)
+    TArray<FFieldOpenEntry> Open;
+    for (int32 Index : DirtyTiles)
+    {
+        const int32 X = Index % Width;
+        const int32 Y = Index / Width;
+        for (const auto& Dir : FieldDirections)
+        {
+            const int32 NX = X + Dir[0];
+            const int32 NY = Y + Dir[1];
+            if (!IsWalkable(NX, NY)) continue;
+
+            const int32 NeighborIndex = NY * Width + NX;
+            if (Distance[NeighborIndex] != MAX_int32)
+            {
+                Open.HeapPush(FFieldOpenEntry(Distance[NeighborIndex], NeighborIndex), FFieldOpenLess());
+            }
+        }
+    }
+
+    for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); ++SourceIndex)
+    {
+        if (Sources[SourceIndex].Target.IsSet()) SeedSource(SourceIndex, Open);
+    }
+
+    Propagate(Open);
+}
+
+void FTargetDistanceField::Reset()
+{
+    Width = 0;
+    Height = 0;
+    Blocked.Reset();
+    Distance.Reset();
+    Owner.Reset();
+    Sources.Reset();
+    SourceIndexMap.Reset();
+    NumRemovedSources = 0;
+}
+
+FEntityHandle FTargetDistanceField::GetTarget(int32 X, int32 Y) const
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height) return FEntityHandle();
+
+    const int32 SourceIndex = Owner[Y * Width + X];
+    return (SourceIndex != INDEX_NONE) ? Sources[SourceIndex].Target : FEntityHandle();
+}
+
+int32 FTargetDistanceField::GetDistance(int32 X, int32 Y) const
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height) return MAX_int32;
+    return Distance[Y * Width + X];
+}
+
+bool FTargetDistanceField::GetNextStep(int32 X, int32 Y, FIntPoint& OutNext) const
+{
+    if (X < 0 || X >= Width || Y < 0 || Y >= Height) return false;
+
+    const int32 Index = Y * Width + X;
+    const int32 Current = Distance[Index];
+    if (Current == MAX_int32 || Current == 0) return false;
+
+    // 最短路树上的上一格：距离少 1 且属于同一个目标
+    for (const auto& Dir : FieldDirections)
+    {
+        const int32 NX = X + Dir[0];
+        const int32 NY = Y + Dir[1];
+        if (!IsWalkable(NX, NY)) continue;
+
+        const int32 NeighborIndex = NY * Width + NX;
+        if (Distance[NeighborIndex] == Current - 1 && Owner[NeighborIndex] == Owner[Index])
+        {
+            OutNext = FIntPoint(NX, NY);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FTargetDistanceField::Rebuild(const TArray<FTargetFieldSource>& InSources)
+{
+    const int32 NumTiles = Width * Height;
+    Distance.Init(MAX_int32, NumTiles);
+    Owner.Init(INDEX_NONE, NumTiles);
+    Sources.Reset();
+    SourceIndexMap.Reset();
+    NumRemovedSources = 0;
+
+    TArray<FFieldOpenEntry> Open;
+    for (const FTargetFieldSource& Source : InSources)
+    {
+        const int32 SourceIndex = Sources.Add(Source);
+        SourceIndexMap.Add(Source.Target, SourceIndex);
+        SeedSource(SourceIndex, Open);
+    }
+
+    Propagate(Open);
+}
+
+void FTargetDistanceField::SeedSource(int32 SourceIndex, TArray<TPair<int32, int32>>& Open)
+{
+    const FTargetFieldSource& Source = Sources[SourceIndex];
+    for (int32 DY = -1; DY <= 1; ++DY)
+    {
+        for (int32 DX = -1; DX <= 1; ++DX)
+        {
+            const int32 X = Source.TileX + DX;
+            const int32 Y = Source.TileY + DY;
+            if ((DX == 0 && DY == 0) || !IsWalkable(X, Y)) continue;
+
+            // 已经是别的目标的外围就保持原样 (先到先得)
+            const int32 Index = Y * Width + X;
+            if (Distance[Index] > 0)
+            {
+                Distance[Index] = 0;
+                Owner[Index] = SourceIndex;
+                Open.HeapPush(FFieldOpenEntry(0, Index), FFieldOpenLess());
+            }
+        }
+    }
+}
+
+void FTargetDistanceField::Propagate(TArray<TPair<int32, int32>>& Open)
+{
+    while (Open.Num() > 0)
+    {
+        FFieldOpenEntry Current;
+        Open.HeapPop(Current, FFieldOpenLess());
+
+        const int32 Index = Current.Value;
+        if (Current.Key > Distance[Index]) continue; // 过期条目
+        ++LastUpdatedTiles;
+
+        const int32 X = Index % Width;
+        const int32 Y = Index / Width;
+        const int32 NewDistance = Current.Key + 1;
+        for (const auto& Dir : FieldDirections)
+        {
+            const int32 NX = X + Dir[0];
+            const int32 NY = Y + Dir[1];
+            if (!IsWalkable(NX, NY)) continue;
+
+            const int32 NeighborIndex = NY * Width + NX;
+            if (NewDistance < Distance[NeighborIndex])
+            {
+                Distance[NeighborIndex] = NewDistance;
+                Owner[NeighborIndex] = Owner[Index];
+                Open.HeapPush(FFieldOpenEntry(NewDistance, NeighborIndex), FFieldOpenLess());
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "EntityHandle.h"
+
+// 距离场按目标类别分开维护 (巨人优先打塔、炸弹人优先炸墙)
+enum class ETargetFieldType : uint8
+{
+    AnyBuilding,
+    Defense,
+    Wall,
+    MAX
+};
+
+// 距离场的源：一个目标建筑和它所在的格子
+struct FTargetFieldSource
+{
+    FEntityHandle Target;
+    int32 TileX = INDEX_NONE;
+    int32 TileY = INDEX_NONE;
+};
+
+/**
+ * 多源距离场
+ * 从所有目标建筑的外围格子同时做 Dijkstra，得到每个可走格子到最近目标的真实路径距离 (格子数) 和是哪个目标
+ * 选目标、找下一步都只是查表；目标消失、墙被拆时只重算受影响的格子，新增阻挡时整体重建
+ * 纯计算，不访问 UObject，更新之后决策阶段的工作线程可以并发读取
+ */
+class FTargetDistanceField
+{
+public:
+    // 用本帧的阻挡信息和目标列表更新 (目标按注册顺序给出，距离相同时先到先得)
+    void Update(int32 InWidth, int32 InHeight, const TArray<bool>& InBlocked, const TArray<FTargetFieldSource>& InSources);
+
+    void Reset();
+
+    // 格子上最近的目标，走不到任何目标时返回空句柄
+    FEntityHandle GetTarget(int32 X, int32 Y) const;
+
+    // 到最近目标外围的路径距离 (格子数)，走不到时返回 MAX_int32
+    int32 GetDistance(int32 X, int32 Y) const;
+
+    // 沿距离场下降一步 (四方向，与 A* 一致)，已经在目标外围时返回 false
+    bool GetNextStep(int32 X, int32 Y, FIntPoint& OutNext) const;
+
+    // 上次更新重算的格子数 (统计用)
+    int32 GetLastUpdatedTiles() const { return LastUpdatedTiles; }
+
+private:
+    void Rebuild(const TArray<FTargetFieldSource>& InSources);
+
+    // 目标外围 (周围 8 格中可走的) 作为距离 0 的起点
+    void SeedSource(int32 SourceIndex, TArray<TPair<int32, int32>>& Open);
+
+    // Dijkstra 扩散，只会让距离变小
+    void Propagate(TArray<TPair<int32, int32>>& Open);
+
+    bool IsWalkable(int32 X, int32 Y) const
+    {
+        return X >= 0 && X < Width && Y >= 0 && Y < Height && !Blocked[Y * Width + X];
+    }
+
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<bool> Blocked;
+
+    TArray<int32> Distance;   // 每个格子到最近目标的距离
+    TArray<int32> Owner;      // 每个格子最近的目标 (Sources 下标)
+
+    // 目标槽位在两次重建之间保持不变，目标消失后 Target 置空
+    TArray<FTargetFieldSource> Sources;
+    TMap<FEntityHandle, int32> SourceIndexMap;
+    int32 NumRemovedSources = 0;
+
+    int32 LastUpdatedTiles = 0;
+};
@@ -0,0 +1,192 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "CrowdManager.h"
+#include "Async/ParallelFor.h"
+
+// 选目标的过滤掩码
+enum ETargetFilter : uint8
+{
+    TF_Units = 1 << 0,       // 敌方单位 (会走动，不进距离场，按同样的格子口径比较)
+    TF_Buildings = 1 << 1,   // 敌方建筑 (按档位查距离场)
+    TF_All = TF_Units | TF_Buildings
+};
+
+/**
+ * 选目标策略：在编译期描述一个兵种怎么选目标
+ * InFilter: 能打哪些东西 (ETargetFilter)
+ * bInRangeShortCircuit: 退回逐个扫描时，第一档里有目标在射程内就直接选它
+ * InTiers: 建筑的优先级分档，前一档里走得到的目标总是比后一档优先
+ *
+ * 新兵种只需要声明一个策略，再在 ACrowdManager::TargetingPhase 里把兵种对应上
+ */
+template <uint8 InFilter, bool bInRangeShortCircuit, ETargetFieldType... InTiers>
+struct TTargetingPolicy
+{
+    static_assert(sizeof...(InTiers) > 0, "Targeting policy needs at least one building tier");
+
+    static const uint8 Filter = InFilter;
+    static const bool bRangeShortCircuit = bInRangeShortCircuit;
+};
+
+// 最近的任何东西 (野蛮人、弓箭手)
+typedef TTargetingPolicy<TF_All, false, ETargetFieldType::AnyBuilding> FNearestTargeting;
+
+// 防御塔优先，没有再打最近的建筑 (巨人)
+typedef TTargetingPolicy<TF_Buildings, true, ETargetFieldType::Defense, ETargetFieldType::AnyBuilding> FDefenseFirstTargeting;
+
+// 墙优先，没有再炸最近的建筑 (炸弹人)
+typedef TTargetingPolicy<TF_Buildings, true, ETargetFieldType::Wall, ETargetFieldType::AnyBuilding> FWallFirstTargeting;
+
+// 参与批量选目标的单位
+struct FTargetingAgent
+{
+    int32 EntityIndex = INDEX_NONE;   // 在快照 Entities 中的下标
+    float AttackRange = 0.0f;
+};
+
+// 建筑是否属于某一档 (退回扫描时用)
+FORCEINLINE bool MatchesTargetTier(const FCrowdEntityState& State, ETargetFieldType Tier)
+{
+    switch (Tier)
+    {
+    case ETargetFieldType::Defense: return State.bIsDefense;
+    case ETargetFieldType::Wall:    return State.BuildingType == EBuildingType::Wall;
+    default:                        return true;
+    }
+}
+
+/**
+ * 按距离场的口径量距离 (世界单位)：四方向走到目标所在格子周围 8 格要几步 × 格子大小
+ * 距离场查出的建筑距离是路径格数，兵只有直线表面距离，两者要换成同一把尺子才能比较
+ * 没有绕开阻挡，是真实路径的下界；不在网格上时退回表面距离
+ */
+FORCEINLINE float GetFieldStepDistance(const FCrowdFrame& Frame, const FVector& From, const FCrowdEntityState& Target)
+{
+    int32 FromX, FromY, ToX = Target.GridTile.X, ToY = Target.GridTile.Y;
+    if (!Frame.WorldToTile(From, FromX, FromY)) return Target.GetSurfaceDistance(From);
+    if (ToX == INDEX_NONE && !Frame.WorldToTile(Target.Location, ToX, ToY)) return Target.GetSurfaceDistance(From);
+
+    const int32 Steps = FMath::Max(FMath::Abs(ToX - FromX) - 1, 0) + FMath::Max(FMath::Abs(ToY - FromY) - 1, 0);
+    return Steps * Frame.TileSize;
+}
+
+/**
+ * 批量选目标：同一兵种、同一阵营的单位一起处理
+ * 候选目标只过滤一次，组内共用；建筑优先查距离场 (O(1))，不在场上的单位才退回逐个扫描
+ * 只读快照，结果写到 OutTargets[单位的快照下标]，可以并行
+ */
+template <typename PolicyType>
+struct TTargetingPass;
+
+template <uint8 Filter, bool bRangeShortCircuit, ETargetFieldType... Tiers>
+struct TTargetingPass<TTargetingPolicy<Filter, bRangeShortCircuit, Tiers...>>
+{
+    static void Run(const FCrowdFrame& Frame, ETeam Team, const TArray<FTargetingAgent>& Agents, TArray<int32>& OutTargets, bool bForceSingleThread)
+    {
+        static const ETargetFieldType TierList[] = { Tiers... };
+        static const int32 NumTiers = sizeof...(Tiers);
+
+        // 1. 候选目标 (整组共用)
+        TArray<int32> UnitCandidates;
+        TArray<int32> BuildingCandidates[NumTiers];
+        for (int32 Index = 0; Index < Frame.Entities.Num(); ++Index)
+        {
+            const FCrowdEntityState& State = Frame.Entities[Index];
+            // 飞行中的子弹已经够打死的目标不再选
+            if (State.TeamID == Team || !State.IsAlive() || State.IsDoomed() || !State.bIsTargetable) continue;
+
+            if (State.bIsUnit)
+            {
+                if (Filter & TF_Units) UnitCandidates.Add(Index);
+            }
+            else if (Filter & TF_Buildings)
+            {
+                for (int32 Tier = 0; Tier < NumTiers; ++Tier)
+                {
+                    if (MatchesTargetTier(State, TierList[Tier])) BuildingCandidates[Tier].Add(Index);
+                }
+            }
+        }
+
+        // 2. 逐个单位选目标
+        ParallelFor(Agents.Num(), [&](int32 i)
+        {
+            const FTargetingAgent& Agent = Agents[i];
+            const FVector Location = Frame.Entities[Agent.EntityIndex].Location;
+
+            int32 Best = INDEX_NONE;
+            float BestDistance = FLT_MAX;
+
+            // 站在距离场上时所有距离都按格子口径 (世界单位) 比较，否则都按表面距离
+            const bool bUseFields = (Filter & TF_Buildings) && Frame.CanUseTargetFields(Team, Location);
+
+            if (Filter & TF_Buildings)
+            {
+                if (bUseFields)
+                {
+                    // 距离场：按档位查表，第一个走得到的就是答案
+                    for (int32 Tier = 0; Tier < NumTiers && Best == INDEX_NONE; ++Tier)
+                    {
+                        float PathDistance = FLT_MAX;
+                        const FCrowdEntityState* Target = Frame.FindFieldTarget(Team, TierList[Tier], Location, &PathDistance);
+                        if (!Target) continue;
+
+                        if (!Target->IsDoomed())
+                        {
+                            Best = Target - Frame.Entities.GetData();
+                            BestDistance = PathDistance;
+                            continue;
+                        }
+
+                        // 场里最近的目标已经注定要死 (子弹在路上)：这一档退回逐个扫描，候选里没有注定要死的
+                        for (int32 Candidate : BuildingCandidates[Tier])
+                        {
+                            const float Distance = GetFieldStepDistance(Frame, Location, Frame.Entities[Candidate]);
+                            if (Distance < BestDistance)
+                            {
+                                Best = Candidate;
+                                BestDistance = Distance;
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    // 不在距离场上 (比如站在阻挡格子里)：按表面距离逐档扫描
+                    for (int32 Tier = 0; Tier < NumTiers && Best == INDEX_NONE; ++Tier)
+                    {
+                        for (int32 Candidate : BuildingCandidates[Tier])
+                        {
+                            const float Distance = Frame.Entities[Candidate].GetSurfaceDistance(Location);
+                            if (Distance < BestDistance)
+                            {
+                                Best = Candidate;
+                                BestDistance = Distance;
+                            }
+
+                            // 脸上就有第一档的目标，直接打
+                            if (bRangeShortCircuit && Tier == 0 && Distance <= Agent.AttackRange) break;
+                        }
+                    }
+                }
+            }
+
+            // 兵会走动，不进距离场，换成和建筑一样的口径再比较
+            if (Filter & TF_Units)
+            {
+                for (int32 Candidate : UnitCandidates)
+                {
+                    const FCrowdEntityState& CandidateState = Frame.Entities[Candidate];
+                    const float Distance = bUseFields ? GetFieldStepDistance(Frame, Location, CandidateState) : CandidateState.GetSurfaceDistance(Location);
+                    if (Distance < BestDistance)
+                    {
+                        Best = Candidate;
+                        BestDistance = Distance;
+                    }
+                }
+            }
+
+            OutTargets[Agent.EntityIndex] = Best;
+        }, bForceSingleThread);
+    }
+};
@@ -0,0 +1,341 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/**
+ * 时间轮
+ * 时间按固定步长切成刻度，定时任务按到期刻度挂到 (刻度 % 槽数) 的槽里；
+ * 推进时只看经过的槽，没到期的任务什么都不用做 (不用每帧逐个比较)
+ * 超过一圈的任务留在槽里，每转一圈检查一次
+ *
+ * 触发时间向上取整到刻度 (与下面的层级时间轮一致)：不会早于 FireTime
+ * 触发顺序完全确定：按到期刻度，同一刻度按加入顺序，只取决于调度时间不取决于帧率
+ */
+template <typename PayloadType>
+class TTimerWheel
+{
+public:
+    struct FEntry
+    {
+        int32 Tick = 0;
+        PayloadType Payload;
+    };
+
+    explicit TTimerWheel(float InTickInterval = 1.0f / 60.0f, int32 InNumSlotsLog2 = 8)
+        : TickInterval(InTickInterval)
+        , SlotMask((1 << InNumSlotsLog2) - 1)
+    {
+        Slots.SetNum(SlotMask + 1);
+    }
+
+    // 当前时间 (秒)：第一次推进之前必须调用
+    void Start(float Now)
+    {
+        CurrentTick = TimeToTick(Now);
+    }
+
+    // 在 FireTime (秒) 触发；刻度向上取整，不会早于 FireTime；已经过去的时间在下一次推进时触发
+    void Schedule(float FireTime, const PayloadType& Payload)
+    {
+        const int32 Tick = FMath::Max(FMath::CeilToInt(FireTime / TickInterval), CurrentTick + 1);
+        FEntry& Entry = Slots[Tick & SlotMask].AddDefaulted_GetRef();
+        Entry.Tick = Tick;
+        Entry.Payload = Payload;
+        ++NumPending;
+    }
+
+    // 推进到 Now，所有到期的任务按触发顺序追加到 OutFired
+    void Advance(float Now, TArray<FEntry>& OutFired)
+    {
+        const int32 TargetTick = TimeToTick(Now);
+        if (TargetTick <= CurrentTick) return;
+
+        const int32 FirstFired = OutFired.Num();
+
+        // 跨过的刻度超过一圈时每个槽只需要看一次
+        const bool bWrapped = TargetTick - CurrentTick > SlotMask + 1;
+        const int32 NumSteps = bWrapped ? SlotMask + 1 : TargetTick - CurrentTick;
+        for (int32 Step = 1; Step <= NumSteps && NumPending > 0; ++Step)
+        {
+            TArray<FEntry>& Slot = Slots[(CurrentTick + Step) & SlotMask];
+
+            // 保持剩余任务的相对顺序 (不用 RemoveAtSwap)
+            int32 Kept = 0;
+            for (int32 i = 0; i < Slot.Num(); ++i)
+            {
+                if (Slot[i].Tick <= TargetTick)
+                {
+                    OutFired.Add(MoveTemp(Slot[i]));
+                    --NumPending;
+                }
+                else
+                {
+                    if (Kept != i) Slot[Kept] = MoveTemp(Slot[i]);
+                    ++Kept;
+                }
+            }
+            Slot.SetNum(Kept, false);
+        }
+        CurrentTick = TargetTick;
+
+        // 跨圈时不同槽的任务可能交错，按刻度排一下 (稳定排序，同一刻度保持加入顺序)
+        if (bWrapped && OutFired.Num() - FirstFired > 1)
+        {
+            TArrayView<FEntry> Fired(OutFired.GetData() + FirstFired, OutFired.Num() - FirstFired);
+            Fired.StableSort([](const FEntry& A, const FEntry& B) { return A.Tick < B.Tick; });
+        }
+    }
+
+    // 清空所有任务，按调用方需要把它们取出来 (比如归还预约)
+    void Drain(TArray<FEntry>& OutPending)
+    {
+        for (TArray<FEntry>& Slot : Slots)
+        {
+            OutPending.Append(MoveTemp(Slot));
+            Slot.Reset();
+        }
+        NumPending = 0;
+    }
+
+    int32 Num() const { return NumPending; }
+    float GetTickInterval() const { return TickInterval; }
+
+private:
+    int32 TimeToTick(float Time) const
+    {
+        return FMath::FloorToInt(Time / TickInterval);
+    }
+
+    float TickInterval;
+    int32 SlotMask;
+    int32 CurrentTick = 0;
+    int32 NumPending = 0;
+    TArray<TArray<FEntry>> Slots;
+};
+
+// 层级时间轮的任务句柄 (取消用)：任务触发或取消后自动失效
+struct FTimerWheelHandle
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    bool IsSet() const { return Index != INDEX_NONE; }
+    void Reset() { Index = INDEX_NONE; Generation = 0; }
+};
+
+/**
+ * 层级时间轮
+ * 4 层、每层 64 个槽：第 0 层一个槽一个刻度，往上每层的一个槽是下一层的一整圈 (最远约 2^24 个刻度，60Hz 下 77 小时)
+ * 远的任务挂在高层，转到的时候逐层下放；任务放在节点池的双向链表里，插入、取消都是 O(1)
+ * 适合随时会重新安排、取消的冷却 (攻击、开火、生产)；只插入不取消的用上面的 TTimerWheel
+ *
+ * 触发时间向上取整到刻度：不会早于 FireTime；同一刻度按加入顺序触发，结果与帧率无关
+ */
+template <typename PayloadType>
+class THierarchicalTimerWheel
+{
+public:
+    struct FEntry
+    {
+        int32 Tick = 0;
+        PayloadType Payload;
+    };
+
+    explicit THierarchicalTimerWheel(float InTickInterval = 1.0f / 60.0f)
+        : TickInterval(InTickInterval)
+    {
+        for (int32& Head : SlotHeads) Head = INDEX_NONE;
+    }
+
+    // 当前时间 (秒)：只在没有任务时生效 (已有的任务不能平移)
+    void Start(float Now)
+    {
+        if (NumPending == 0) CurrentTick = FMath::FloorToInt(Now / TickInterval);
+    }
+
+    // 在 FireTime (秒) 触发；已经过去的时间在下一次推进时触发
+    FTimerWheelHandle Schedule(float FireTime, const PayloadType& Payload)
+    {
+        const int32 Index = (FreeNodes.Num() > 0) ? FreeNodes.Pop(false) : Nodes.AddDefaulted();
+        FNode& Node = Nodes[Index];
+        Node.Tick = FMath::Max(FMath::CeilToInt(FireTime / TickInterval), CurrentTick + 1);
+        Node.Sequence = NextSequence++;
+        Node.Payload = Payload;
+        Link(Index);
+        ++NumPending;
+
+        FTimerWheelHandle Handle;
+        Handle.Index = Index;
+        Handle.Generation = Node.Generation;
+        return Handle;
+    }
+
+    // 取消任务并清空句柄，返回任务是否还在等待
+    bool Cancel(FTimerWheelHandle& Handle)
+    {
+        const bool bPending = IsPending(Handle);
+        if (bPending)
+        {
+            Unlink(Handle.Index);
+            FreeNode(Handle.Index);
+            --NumPending;
+        }
+        Handle.Reset();
+        return bPending;
+    }
+
+    bool IsPending(const FTimerWheelHandle& Handle) const
+    {
+        return Nodes.IsValidIndex(Handle.Index) && Nodes[Handle.Index].Generation == Handle.Generation && Nodes[Handle.Index].Slot != INDEX_NONE;
+    }
+
+    // 推进到 Now，所有到期的任务按触发顺序追加到 OutFired
+    void Advance(float Now, TArray<FEntry>& OutFired)
+    {
+        const int32 TargetTick = FMath::FloorToInt(Now / TickInterval);
+        while (CurrentTick < TargetTick)
+        {
+            // 没有任务了：直接跳到目标刻度
+            if (NumPending == 0)
+            {
+                CurrentTick = TargetTick;
+                break;
+            }
+
+            const int32 Tick = CurrentTick + 1;
+
+            // 1. 下层转完一圈时，上层对应的槽下放 (此时 CurrentTick 还没前进，下放按 Tick 为起点重新挂)
+            for (int32 Level = 1; Level < NumLevels; ++Level)
+            {
+                if ((Tick & ((1 << (SlotBits * Level)) - 1)) != 0) break;
+                Cascade(Level * SlotsPerLevel + ((Tick >> (SlotBits * Level)) & SlotMask));
+            }
+
+            // 2. 第 0 层的槽里都是这个刻度的任务，按加入顺序触发
+            int32& Head = SlotHeads[Tick & SlotMask];
+            if (Head != INDEX_NONE)
+            {
+                TArray<int32, TInlineAllocator<16>> Due;
+                for (int32 Index = Head; Index != INDEX_NONE; Index = Nodes[Index].Next)
+                {
+                    Due.Add(Index);
+                }
+                Head = INDEX_NONE;
+
+                Due.Sort([this](int32 A, int32 B) { return Nodes[A].Sequence < Nodes[B].Sequence; });
+                for (int32 Index : Due)
+                {
+                    FEntry& Entry = OutFired.AddDefaulted_GetRef();
+                    Entry.Tick = Tick;
+                    Entry.Payload = MoveTemp(Nodes[Index].Payload);
+                    FreeNode(Index);
+                }
+                NumPending -= Due.Num();
+            }
+
+            CurrentTick = Tick;
+        }
+    }
+
+    // 清空所有任务，按调用方需要把它们取出来
+    void Drain(TArray<FEntry>& OutPending)
+    {
+        for (int32& Head : SlotHeads)
+        {
+            for (int32 Index = Head; Index != INDEX_NONE; )
+            {
+                const int32 Next = Nodes[Index].Next;
+                FEntry& Entry = OutPending.AddDefaulted_GetRef();
+                Entry.Tick = Nodes[Index].Tick;
+                Entry.Payload = MoveTemp(Nodes[Index].Payload);
+                FreeNode(Index);
+                Index = Next;
+            }
+            Head = INDEX_NONE;
+        }
+        NumPending = 0;
+    }
+
+    int32 Num() const { return NumPending; }
+    float GetTickInterval() const { return TickInterval; }
+
+private:
+    static const int32 SlotBits = 6;
+    static const int32 SlotsPerLevel = 1 << SlotBits;
+    static const int32 SlotMask = SlotsPerLevel - 1;
+    static const int32 NumLevels = 4;
+    static const int32 MaxDelta = (1 << (SlotBits * NumLevels)) - 1;
+
+    struct FNode
+    {
+        int32 Tick = 0;
+        uint32 Sequence = 0;
+        uint32 Generation = 1;
+        int32 Slot = INDEX_NONE;   // 空闲节点为 INDEX_NONE
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        PayloadType Payload;
+    };
+
+    // 按离下一个刻度的距离选层：距离在 64^(L+1) 以内的挂在第 L 层 (超出最远距离的先挂在最高层，下放时再重新挂)
+    int32 GetSlot(int32 Tick) const
+    {
+        const int32 Base = CurrentTick + 1;
+        const int32 Delta = FMath::Clamp(Tick - Base, 0, MaxDelta);
+        const int32 SlotTick = Base + Delta;
+
+        int32 Level = 0;
+        while (Level < NumLevels - 1 && Delta >= (1 << (SlotBits * (Level + 1)))) ++Level;
+        return Level * SlotsPerLevel + ((SlotTick >> (SlotBits * Level)) & SlotMask);
+    }
+
+    void Link(int32 Index)
+    {
+        FNode& Node = Nodes[Index];
+        Node.Slot = GetSlot(Node.Tick);
+        Node.Prev = INDEX_NONE;
+        Node.Next = SlotHeads[Node.Slot];
+        if (Node.Next != INDEX_NONE) Nodes[Node.Next].Prev = Index;
+        SlotHeads[Node.Slot] = Index;
+    }
+
+    void Unlink(int32 Index)
+    {
+        FNode& Node = Nodes[Index];
+        if (Node.Prev != INDEX_NONE) Nodes[Node.Prev].Next = Node.Next;
+        else SlotHeads[Node.Slot] = Node.Next;
+        if (Node.Next != INDEX_NONE) Nodes[Node.Next].Prev = Node.Prev;
+        Node.Slot = INDEX_NONE;
+    }
+
+    void FreeNode(int32 Index)
+    {
+        FNode& Node = Nodes[Index];
+        Node.Slot = INDEX_NONE;
+        Node.Prev = Node.Next = INDEX_NONE;
+        Node.Payload = PayloadType();
+        ++Node.Generation;   // 旧句柄失效
+        FreeNodes.Add(Index);
+    }
+
+    // 把上层一个槽的任务整体摘下来，按当前刻度重新挂 (会落到更低的层)
+    void Cascade(int32 SlotIndex)
+    {
+        int32 Index = SlotHeads[SlotIndex];
+        SlotHeads[SlotIndex] = INDEX_NONE;
+        while (Index != INDEX_NONE)
+        {
+            const int32 Next = Nodes[Index].Next;
+            Link(Index);
+            Index = Next;
+        }
+    }
+
+    float TickInterval;
+    int32 CurrentTick = 0;
+    int32 NumPending = 0;
+    uint32 NextSequence = 0;
+
+    TArray<FNode> Nodes;
+    TArray<int32> FreeNodes;
+    int32 SlotHeads[NumLevels * SlotsPerLevel];
+};
@@ -0,0 +1,109 @@
+#include "UnitPool.h"
+#include "WorldSingleton.h"
+#include "BaseUnit.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Units Reused"), STAT_UnitPoolReused, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Units Spawned"), STAT_UnitPoolSpawned, STATGROUP_Game);
+
+namespace
+{
+    // 池里的单位停在地图下面 (已经隐藏，只是防止被误选到)
+    const FVector PoolParkingLocation(0.0f, 0.0f, -100000.0f);
+}
+
+AUnitPool::AUnitPool()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    USceneComponent* SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+    RootComponent = SceneRoot;
+
+    MaxPooledPerClass = 64;
+    NumReused = 0;
+    NumSpawned = 0;
+}
+
+AUnitPool* AUnitPool::Get(const UObject* WorldContextObject)
+{
+    return TWorldSingleton<AUnitPool>::Get(WorldContextObject);
+}
+
+ABaseUnit* AUnitPool::Acquire(TSubclassOf<ABaseUnit> UnitClass, const FVector& Location, const FRotator& Rotation, ETeam Team)
+{
+    if (!UnitClass) return nullptr;
+
+    // 1. 池里有就复用 (后进先出，刚退场的还在缓存里)
+    if (FUnitPoolBucket* Bucket = Buckets.Find(UnitClass.Get()))
+    {
+        while (Bucket->FreeUnits.Num() > 0)
+        {
+            ABaseUnit* Unit = Bucket->FreeUnits.Pop(false);
+            if (!IsValid(Unit)) continue;
+
+            Unit->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+            Unit->TeamID = Team;
+            Unit->OnTakenFromPool();
+
+            ++NumReused;
+            INC_DWORD_STAT(STAT_UnitPoolReused);
+            return Unit;
+        }
+    }
+
+    // 2. 没有就生成 (BeginPlay 里完成初始化)
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    ABaseUnit* Unit = GetWorld()->SpawnActor<ABaseUnit>(UnitClass, Location, Rotation, Params);
+    if (Unit)
+    {
+        Unit->TeamID = Team;
+        ++NumSpawned;
+        INC_DWORD_STAT(STAT_UnitPoolSpawned);
+    }
+    return Unit;
+}
+
+void AUnitPool::Release(ABaseUnit* Unit)
+{
+    if (!IsValid(Unit)) return;
+
+    FUnitPoolBucket& Bucket = Buckets.FindOrAdd(Unit->GetClass());
+    if (Bucket.FreeUnits.Contains(Unit)) return;   // 已经在池里了
+
+    // 池满了：多出来的照常销毁
+    if (Bucket.FreeUnits.Num() >= MaxPooledPerClass)
+    {
+        Unit->Destroy();
+        return;
+    }
+
+    Unit->OnReturnedToPool();
+    Unit->SetActorLocation(PoolParkingLocation, false, nullptr, ETeleportType::ResetPhysics);
+    Bucket.FreeUnits.Add(Unit);
+}
+
+void AUnitPool::Prewarm(TSubclassOf<ABaseUnit> UnitClass, int32 Count)
+{
+    if (!UnitClass) return;
+
+    const int32 Existing = GetNumFree(UnitClass);
+    const int32 ToSpawn = FMath::Min(Count, MaxPooledPerClass) - Existing;
+
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    for (int32 i = 0; i < ToSpawn; ++i)
+    {
+        ABaseUnit* Unit = GetWorld()->SpawnActor<ABaseUnit>(UnitClass, PoolParkingLocation, FRotator::ZeroRotator, Params);
+        if (Unit) Release(Unit);
+    }
+}
+
+int32 AUnitPool::GetNumFree(TSubclassOf<ABaseUnit> UnitClass) const
+{
+    const FUnitPoolBucket* Bucket = UnitClass ? Buckets.Find(UnitClass.Get()) : nullptr;
+    return Bucket ? Bucket->FreeUnits.Num() : 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "RTSCoreTypes.h"
+#include "UnitPool.generated.h"
+
+class ABaseUnit;
+
+// 同一个兵种蓝图的空闲单位
+USTRUCT()
+struct FUnitPoolBucket
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+        TArray<ABaseUnit*> FreeUnits;
+};
+
+/**
+ * 单位对象池
+ * 买兵、部署、兵营存取兵、死亡都会频繁生成/销毁单位；这里按蓝图类缓存退场的单位，
+ * 需要时重置状态 (血量、阵营、状态机、路径、模型偏移) 再拿出来用，省掉 SpawnActor 的开销和之后的 GC
+ *
+ * 池里的单位隐藏、关闭碰撞、已从群体管理器注销，血量为 0 (按血量筛选活兵的地方自然跳过它们)
+ */
+UCLASS()
+class AUTOBATTLEDEMO_API AUnitPool : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AUnitPool();
+
+    // 获取当前世界的对象池（没有则自动生成一个，之后按 World 缓存，见 WorldSingleton.h）
+    static AUnitPool* Get(const UObject* WorldContextObject);
+
+    // 取一个单位：池里有就重置后放到指定位置，没有再生成
+    ABaseUnit* Acquire(TSubclassOf<ABaseUnit> UnitClass, const FVector& Location, const FRotator& Rotation, ETeam Team);
+
+    // 单位退场：放回池里 (池满了就销毁)
+    void Release(ABaseUnit* Unit);
+
+    // 预先生成一批放进池里 (关卡开始时调用)
+    void Prewarm(TSubclassOf<ABaseUnit> UnitClass, int32 Count);
+
+    int32 GetNumFree(TSubclassOf<ABaseUnit> UnitClass) const;
+
+protected:
+    // 每个兵种最多缓存的单位数
+    UPROPERTY(EditAnywhere, Category = "Pool")
+        int32 MaxPooledPerClass;
+
+private:
+    UPROPERTY()
+        TMap<UClass*, FUnitPoolBucket> Buckets;
+
+    // 统计：从池里取 / 新生成的次数
+    int32 NumReused;
+    int32 NumSpawned;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+
+/**
+ * 每个 World 一个的管理器 Actor (群体管理器、对象池、子弹管理器) 的查找
+ * 第一次查找时遍历关卡 (找摆放好的)，没有就生成一个；之后按 World 缓存弱引用，
+ * 实体 BeginPlay、开火、取池这些高频路径不再遍历 Actor
+ */
+template <typename ActorType>
+struct TWorldSingleton
+{
+    static ActorType* Get(const UObject* WorldContextObject)
+    {
+        UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+        if (!World) return nullptr;
+
+        TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<ActorType>>& Instances = GetInstances();
+        if (const TWeakObjectPtr<ActorType>* Cached = Instances.Find(World))
+        {
+            if (ActorType* Instance = Cached->Get()) return Instance;
+        }
+
+        ActorType* Instance = nullptr;
+        for (TActorIterator<ActorType> It(World); It; ++It)
+        {
+            Instance = *It;
+            break;
+        }
+
+        // 关卡里没有摆放，就现场生成一个
+        if (!Instance)
+        {
+            FActorSpawnParameters Params;
+            Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+            Instance = World->SpawnActor<ActorType>(ActorType::StaticClass(), FTransform::Identity, Params);
+        }
+
+        // 顺手清掉已经销毁的 World (PIE 反复开关)
+        for (auto It = Instances.CreateIterator(); It; ++It)
+        {
+            if (!It->Key.IsValid()) It.RemoveCurrent();
+        }
+        Instances.Add(World, Instance);
+        return Instance;
+    }
+
+private:
+    static TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<ActorType>>& GetInstances()
+    {
+        static TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<ActorType>> Instances;
+        return Instances;
+    }
+};